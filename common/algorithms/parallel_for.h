@@ -18,6 +18,7 @@
 
 #include "../tasking/taskscheduler.h"
 #include "../sys/array.h"
+#include "../sys/tracer.h"
 #include "../math/math.h"
 #include "../math/range.h"
 
@@ -31,6 +32,7 @@ namespace embree
     if (N) {
       TaskScheduler::spawn(Index(0),N,Index(1),[&] (const range<Index>& r) {
           assert(r.size() == 1);
+          TRACE_SCOPE("parallel_for");
           func(r.begin());
         });
       if (!TaskScheduler::wait())
@@ -59,12 +61,16 @@ namespace embree
   {
     assert(first <= last);
 #if defined(TASKING_INTERNAL)
-    TaskScheduler::spawn(first,last,minStepSize,func);
+    TaskScheduler::spawn(first,last,minStepSize,[&] (const range<Index>& r) {
+        TRACE_SCOPE("parallel_for");
+        func(r);
+      });
     if (!TaskScheduler::wait())
       throw std::runtime_error("task cancelled");
 
 #elif defined(TASKING_TBB)
     tbb::parallel_for(tbb::blocked_range<Index>(first,last,minStepSize),[&](const tbb::blocked_range<Index>& r) { 
+        TRACE_SCOPE("parallel_for");
         func(range<Index>(r.begin(),r.end()));
       });
     if (tbb::task::self().is_cancelled())
@@ -72,6 +78,7 @@ namespace embree
 
 #elif defined(TASKING_PPL)
     concurrency::parallel_for(first, last, Index(1) /*minStepSize*/, [&](Index i) { 
+        TRACE_SCOPE("parallel_for");
         func(range<Index>(i,i+1)); 
       });
 
@@ -44,6 +44,7 @@ namespace embree
     parallel_for(taskCount, [&](const Index taskIndex) {
         const Index k0 = first+(taskIndex+0)*(last-first)/taskCount;
         const Index k1 = first+(taskIndex+1)*(last-first)/taskCount;
+        TRACE_SCOPE("parallel_reduce");
         values[taskIndex] = func(range<Index>(k0,k1));
       });
 
@@ -67,7 +68,7 @@ namespace embree
 
 #elif defined(TASKING_TBB)
     const Value v = tbb::parallel_reduce(tbb::blocked_range<Index>(first,last,minStepSize),identity,
-      [&](const tbb::blocked_range<Index>& r, const Value& start) { return reduction(start,func(range<Index>(r.begin(),r.end()))); },
+      [&](const tbb::blocked_range<Index>& r, const Value& start) { TRACE_SCOPE("parallel_reduce"); return reduction(start,func(range<Index>(r.begin(),r.end()))); },
       reduction);
     if (tbb::task::self().is_cancelled())
       throw std::runtime_error("task cancelled");
@@ -106,6 +107,7 @@ namespace embree
     
     auto range_reduction = [&](Iterator_Index begin, Iterator_Index end, const AlignedValue& start) {
       assert(begin.v < end.v);
+      TRACE_SCOPE("parallel_reduce");
       return reduction(start, func(range<Index>(begin.v, end.v)));
     };
     const Value v = concurrency::parallel_reduce(Iterator_Index(first), Iterator_Index(last), AlignedValue(identity), range_reduction, reduction);
@@ -50,6 +50,18 @@ namespace embree
     union { float f; int i; } v; v.i = i; return v.f;
   }
 
+  /*! converts an IEEE 754 half precision float to single precision */
+  __forceinline float half_to_float(const unsigned short h)
+  {
+    const int sign = int(h & 0x8000) << 16;
+    const int exp  = (h >> 10) & 0x1f;
+    const int mant = h & 0x3ff;
+    if (exp == 0x1f) return cast_i2f(sign | 0x7f800000 | (mant << 13)); // inf and NaN
+    if (exp != 0)    return cast_i2f(sign | ((exp+112) << 23) | (mant << 13));
+    const float f = float(mant)*5.9604644775390625E-8f; // zero and denormals
+    return sign ? -f : f;
+  }
+
 #if defined(__WIN32__)
   __forceinline bool finite ( const float x ) { return _finite(x) != 0; }
 #endif
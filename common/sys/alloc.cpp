@@ -175,6 +175,40 @@ namespace embree
   void os_advise(void *ptr, size_t bytes)
   {
   }
+
+  static size_t os_map_granularity()
+  {
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwAllocationGranularity;
+  }
+
+  void* os_map_file(const char* fileName, size_t offset, size_t bytes)
+  {
+    HANDLE file = CreateFileA(fileName,GENERIC_READ,FILE_SHARE_READ,nullptr,OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL,nullptr);
+    if (file == INVALID_HANDLE_VALUE) return nullptr;
+    HANDLE mapping = CreateFileMappingA(file,nullptr,PAGE_WRITECOPY,0,0,nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr) return nullptr;
+
+    const size_t align = offset % os_map_granularity();
+    const size_t base = offset-align;
+    char* ptr = (char*) MapViewOfFile(mapping,FILE_MAP_COPY,DWORD(base >> 32),DWORD(base),bytes+align);
+    CloseHandle(mapping);
+    if (ptr == nullptr) return nullptr;
+    return ptr+align;
+  }
+
+  void os_unmap_file(void* ptr, size_t offset, size_t bytes)
+  {
+    const size_t align = offset % os_map_granularity();
+    if (!UnmapViewOfFile((char*)ptr-align))
+      throw std::bad_alloc();
+  }
+
+  void os_prefetch(void* ptr, size_t bytes)
+  {
+  }
 }
 
 #endif
@@ -186,6 +220,8 @@ namespace embree
 #if defined(__UNIX__)
 
 #include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include <errno.h>
 #include <stdlib.h>
 #include <string.h>
@@ -314,6 +350,36 @@ namespace embree
     madvise(pptr,bytes,MADV_HUGEPAGE); 
 #endif
   }
+
+  void* os_map_file(const char* fileName, size_t offset, size_t bytes)
+  {
+    int fd = open(fileName,O_RDONLY);
+    if (fd == -1) return nullptr;
+
+    /* the mapping is writable as rtcGetBufferData hands out a writable
+     * pointer, but private, such that writes only touch copy-on-write
+     * pages and never reach the file */
+    const size_t align = offset & (PAGE_SIZE_4K-1);
+    void* ptr = mmap(nullptr,bytes+align,PROT_READ|PROT_WRITE,MAP_PRIVATE,fd,off_t(offset-align));
+    close(fd);
+    if (ptr == MAP_FAILED) return nullptr;
+    return (char*)ptr+align;
+  }
+
+  void os_unmap_file(void* ptr, size_t offset, size_t bytes)
+  {
+    const size_t align = offset & (PAGE_SIZE_4K-1);
+    if (munmap((char*)ptr-align,bytes+align) == -1)
+      throw std::bad_alloc();
+  }
+
+  /* asks the OS to page in a range of a mapped file ahead of time */
+  void os_prefetch(void* pptr, size_t bytes)
+  {
+    const size_t begin = size_t(pptr) & ~size_t(PAGE_SIZE_4K-1);
+    const size_t end = size_t(pptr)+bytes;
+    madvise((void*)begin,end-begin,MADV_WILLNEED);
+  }
 }
 
 #endif
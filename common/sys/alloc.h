@@ -74,6 +74,11 @@ namespace embree
   void  os_free   (void* ptr, size_t bytes, bool hugepages);
   void  os_advise (void* ptr, size_t bytes);
 
+  /*! maps a file copy-on-write into memory, writes never reach the file, returns nullptr on failure */
+  void* os_map_file (const char* fileName, size_t offset, size_t bytes);
+  void  os_unmap_file (void* ptr, size_t offset, size_t bytes);
+  void  os_prefetch (void* ptr, size_t bytes);
+
   /*! allocator that performs OS allocations */
   template<typename T>
     struct os_allocator
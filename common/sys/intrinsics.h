@@ -412,7 +412,18 @@ namespace embree
     return _mm_popcnt_u64(in);
   }
 #endif
-  
+
+#else
+
+  /* software fallback for ISAs without popcnt instruction */
+  __forceinline size_t popcnt(size_t in) {
+    uint64_t x = in;
+    x = x - ((x >> 1) & 0x5555555555555555ull);
+    x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return (size_t)((x * 0x0101010101010101ull) >> 56);
+  }
+
 #endif
 
   __forceinline uint64_t rdtsc()
@@ -421,6 +421,18 @@ namespace embree
     GetProcessMemoryInfo( GetCurrentProcess( ), &info, sizeof(info) );
     return (size_t)info.WorkingSetSize;
   }
+
+  unsigned int getNumberOfSockets() {
+    return 1;
+  }
+
+  unsigned int getSocketOfLogicalThread(size_t threadID) {
+    return 0;
+  }
+
+  unsigned int getSocketOfCurrentThread() {
+    return 0;
+  }
 }
 #endif
 
@@ -432,9 +444,74 @@ namespace embree
 
 #include <stdio.h>
 #include <unistd.h>
+#include <sched.h>
+#include <dirent.h>
+#include <algorithm>
+#include <vector>
 
 namespace embree
 {
+  /* maps each logical thread to a dense socket index using the physical package IDs */
+  static const std::vector<unsigned int>& getSocketMapping()
+  {
+    static const std::vector<unsigned int> sockets = [] ()
+    {
+      /* enumerate all cpuN entries, CPU IDs are not contiguous when some CPUs are offline */
+      std::vector<int> packageIDs;
+      if (DIR* dir = opendir("/sys/devices/system/cpu"))
+      {
+        while (struct dirent* entry = readdir(dir))
+        {
+          unsigned int cpuID = 0; char c = 0;
+          if (sscanf(entry->d_name,"cpu%u%c",&cpuID,&c) != 1) continue;
+          std::ifstream fs("/sys/devices/system/cpu/" + std::string(entry->d_name) + "/topology/physical_package_id");
+          if (fs.fail()) continue;
+          int id = 0; fs >> id;
+          if (cpuID >= packageIDs.size()) packageIDs.resize(cpuID+1,-1);
+          packageIDs[cpuID] = std::max(id,0);
+        }
+        closedir(dir);
+      }
+
+      std::vector<int> uniqueIDs;
+      for (int id : packageIDs) if (id >= 0) uniqueIDs.push_back(id);
+      std::sort(uniqueIDs.begin(),uniqueIDs.end());
+      uniqueIDs.erase(std::unique(uniqueIDs.begin(),uniqueIDs.end()),uniqueIDs.end());
+
+      /* CPUs without topology information are assigned to the first socket */
+      std::vector<unsigned int> sockets(packageIDs.size(),0);
+      for (size_t i=0; i<packageIDs.size(); i++)
+        if (packageIDs[i] >= 0)
+          sockets[i] = unsigned(std::lower_bound(uniqueIDs.begin(),uniqueIDs.end(),packageIDs[i])-uniqueIDs.begin());
+      return sockets;
+    }();
+    return sockets;
+  }
+
+  unsigned int getNumberOfSockets()
+  {
+    static const unsigned int numSockets = [] () -> unsigned int {
+      const std::vector<unsigned int>& sockets = getSocketMapping();
+      if (sockets.size() == 0) return 1;
+      return *std::max_element(sockets.begin(),sockets.end())+1;
+    }();
+    return numSockets;
+  }
+
+  unsigned int getSocketOfLogicalThread(size_t threadID)
+  {
+    const std::vector<unsigned int>& sockets = getSocketMapping();
+    if (threadID >= sockets.size()) return 0;
+    return sockets[threadID];
+  }
+
+  unsigned int getSocketOfCurrentThread()
+  {
+    const int cpuID = sched_getcpu();
+    if (cpuID < 0) return 0;
+    return getSocketOfLogicalThread(cpuID);
+  }
+
   std::string getExecutableFileName() 
   {
     std::string pid = "/proc/" + toString(getpid()) + "/exe";
@@ -492,6 +569,18 @@ namespace embree
   size_t getResidentMemoryBytes() {
     return 0;
   }
+
+  unsigned int getNumberOfSockets() {
+    return 1;
+  }
+
+  unsigned int getSocketOfLogicalThread(size_t threadID) {
+    return 0;
+  }
+
+  unsigned int getSocketOfCurrentThread() {
+    return 0;
+  }
 }
 
 #endif
@@ -522,6 +611,18 @@ namespace embree
   size_t getResidentMemoryBytes() {
     return 0;
   }
+
+  unsigned int getNumberOfSockets() {
+    return 1;
+  }
+
+  unsigned int getSocketOfLogicalThread(size_t threadID) {
+    return 0;
+  }
+
+  unsigned int getSocketOfCurrentThread() {
+    return 0;
+  }
 }
 
 #endif
@@ -164,6 +164,15 @@ namespace embree
 
   /*! return the number of logical threads of the system */
   unsigned int getNumberOfLogicalThreads();
+
+  /*! returns the number of CPU sockets of the system */
+  unsigned int getNumberOfSockets();
+
+  /*! returns the socket the specified logical thread belongs to */
+  unsigned int getSocketOfLogicalThread(size_t threadID);
+
+  /*! returns the socket the calling thread is currently running on */
+  unsigned int getSocketOfCurrentThread();
   
   /*! returns the size of the terminal window in characters */
   int getTerminalWidth();
@@ -178,7 +178,7 @@ namespace embree
   static MutexSys mutex;
   static std::vector<size_t> threadIDs;
   
-  /* changes thread ID mapping such that we first fill up all thread on one core */
+  /* changes thread ID mapping such that we first fill up all thread on one core and all cores on one socket */
   size_t mapThreadID(size_t threadID)
   {
     Lock<MutexSys> lock(mutex);
@@ -217,6 +217,11 @@ namespace embree
           }
         }
       }
+
+      /* fill up all cores of one socket before using the next socket */
+      std::stable_sort(threadIDs.begin(),threadIDs.end(),[] (size_t a, size_t b) {
+          return getSocketOfLogicalThread(a) < getSocketOfLogicalThread(b);
+        });
     }
 
     /* re-map threadIDs if mapping is available */
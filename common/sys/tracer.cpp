@@ -0,0 +1,173 @@
+// ======================================================================== //
+// Copyright 2009-2018 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#include "tracer.h"
+#include "mutex.h"
+#include "sysinfo.h"
+
+#include <vector>
+#include <memory>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+
+namespace embree
+{
+  /*! a traced scope of some thread */
+  struct TraceEvent
+  {
+    const char* name;  //!< static name of the event
+    uint64_t t0;       //!< TSC at the begin of the scope
+    uint64_t t1;       //!< TSC at the end of the scope
+  };
+
+  /*! ring buffer of the events of a single thread, the oldest events get overwritten when full */
+  struct TraceBuffer
+  {
+    TraceBuffer (size_t tid, size_t size)
+      : tid(tid), events(size), numEvents(0) {}
+
+    /*! only called by the owning thread to reuse the buffer in a new session */
+    void reset(size_t tid, size_t size)
+    {
+      this->tid = tid;
+      events.resize(size);
+      numEvents.store(0,std::memory_order_relaxed);
+    }
+
+    /*! only called by the owning thread, the event gets published after it got written */
+    __forceinline void add(const char* name, uint64_t t0, uint64_t t1)
+    {
+      const size_t n = numEvents.load(std::memory_order_relaxed);
+      TraceEvent& e = events[n % events.size()];
+      e.name = name; e.t0 = t0; e.t1 = t1;
+      numEvents.store(n+1,std::memory_order_release);
+    }
+
+  public:
+    size_t tid;                     //!< trace thread ID in order of the first recorded event
+    std::vector<TraceEvent> events;
+    std::atomic<size_t> numEvents;  //!< number of recorded events including overwritten ones
+  };
+
+  std::atomic<bool> Tracer::active(false);
+
+  static MutexSys g_trace_mutex;
+  static std::vector<std::unique_ptr<TraceBuffer>> g_trace_buffers;
+  static std::vector<std::unique_ptr<TraceBuffer>> g_retired_trace_buffers; //!< buffers of stopped sessions, kept alive for reuse by their threads
+  static size_t g_trace_buffer_size = 0;
+  static std::atomic<size_t> g_trace_session(0);
+  static double g_trace_t0 = 0.0;
+  static uint64_t g_trace_c0 = 0;
+
+  static __thread size_t thread_trace_session = 0;
+  static __thread TraceBuffer* thread_trace_buffer = nullptr;
+
+  bool Tracer::start(size_t bufferSize)
+  {
+    Lock<MutexSys> lock(g_trace_mutex);
+    if (active) return false;
+    g_trace_buffer_size = std::max(bufferSize,size_t(1));
+    g_trace_session++;
+    g_trace_t0 = getSeconds();
+    g_trace_c0 = read_tsc();
+    active = true;
+    return true;
+  }
+
+  void Tracer::record(const char* name, uint64_t t0, uint64_t t1)
+  {
+    /* the buffer gets registered at the first event of each thread and session */
+    if (unlikely(thread_trace_session != g_trace_session))
+    {
+      Lock<MutexSys> lock(g_trace_mutex);
+      if (!active) return;
+
+      /* only the owning thread writes into its buffer, thus the retired
+       * buffer of a previous session can safely get reused */
+      auto retired = std::find_if(g_retired_trace_buffers.begin(),g_retired_trace_buffers.end(),
+                                  [] (const std::unique_ptr<TraceBuffer>& buffer) { return buffer.get() == thread_trace_buffer; });
+      if (retired != g_retired_trace_buffers.end()) {
+        thread_trace_buffer->reset(g_trace_buffers.size(),g_trace_buffer_size);
+        g_trace_buffers.push_back(std::move(*retired));
+        g_retired_trace_buffers.erase(retired);
+      } else {
+        g_trace_buffers.push_back(std::unique_ptr<TraceBuffer>(new TraceBuffer(g_trace_buffers.size(),g_trace_buffer_size)));
+        thread_trace_buffer = g_trace_buffers.back().get();
+      }
+      thread_trace_session = g_trace_session;
+    }
+
+    /* tracing may have stopped after the session of the cached buffer got checked */
+    if (unlikely(!active.load(std::memory_order_relaxed))) return;
+    thread_trace_buffer->add(name,t0,t1);
+  }
+
+  bool Tracer::stop(const char* fileName)
+  {
+    Lock<MutexSys> lock(g_trace_mutex);
+    if (!active) return false;
+    active = false;
+
+    /* invalidate the cached buffers of all threads */
+    g_trace_session++;
+
+    /* convert TSC ticks to microseconds using the elapsed wall time */
+    const double dt = getSeconds()-g_trace_t0;
+    const uint64_t dc = read_tsc()-g_trace_c0;
+    const double us = dc ? 1E6*dt/double(dc) : 0.0;
+
+    std::ofstream file(fileName);
+    bool ok = file.good();
+    if (ok)
+    {
+      size_t numDropped = 0;
+      file << std::fixed << std::setprecision(3);
+      file << "{\"traceEvents\":[" << std::endl;
+      for (size_t i=0; i<g_trace_buffers.size(); i++)
+      {
+        const TraceBuffer& buffer = *g_trace_buffers[i];
+        if (i) file << "," << std::endl;
+        file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << buffer.tid << ",\"args\":{\"name\":\"thread " << buffer.tid << "\"}}";
+
+        /* an event that passed the active check before tracing stopped may
+         * still overwrite the oldest slot, which thus gets skipped when the
+         * buffer wrapped around */
+        const size_t size = buffer.events.size();
+        const size_t numEvents = buffer.numEvents.load(std::memory_order_acquire);
+        const size_t begin = numEvents >= size ? numEvents-size+1 : 0;
+        numDropped += begin;
+        for (size_t j=begin; j<numEvents; j++)
+        {
+          const TraceEvent& e = buffer.events[j % size];
+          file << "," << std::endl;
+          file << "{\"name\":\"" << e.name << "\",\"cat\":\"embree\",\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer.tid
+               << ",\"ts\":" << us*double(int64_t(e.t0-g_trace_c0)) << ",\"dur\":" << us*double(e.t1-e.t0) << "}";
+        }
+      }
+      file << std::endl << "],\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedEvents\":" << numDropped << "}}" << std::endl;
+      ok = file.good();
+    }
+
+    /* threads that checked the session before it ended may still write
+     * into their buffers, thus the buffers get retired instead of freed
+     * and each thread reuses its own buffer in the next session */
+    for (auto& buffer : g_trace_buffers)
+      g_retired_trace_buffers.push_back(std::move(buffer));
+    g_trace_buffers.clear();
+    return ok;
+  }
+}
@@ -0,0 +1,70 @@
+// ======================================================================== //
+// Copyright 2009-2018 Intel Corporation                                    //
+//                                                                          //
+// Licensed under the Apache License, Version 2.0 (the "License");          //
+// you may not use this file except in compliance with the License.         //
+// You may obtain a copy of the License at                                  //
+//                                                                          //
+//     http://www.apache.org/licenses/LICENSE-2.0                           //
+//                                                                          //
+// Unless required by applicable law or agreed to in writing, software      //
+// distributed under the License is distributed on an "AS IS" BASIS,        //
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. //
+// See the License for the specific language governing permissions and      //
+// limitations under the License.                                           //
+// ======================================================================== //
+
+#pragma once
+
+#include "platform.h"
+#include "intrinsics.h"
+
+#include <atomic>
+
+/* records the duration of the enclosing scope as trace event */
+#define TRACE_SCOPE(name) embree::TraceScope trace_scope(name)
+
+namespace embree
+{
+  /*! Records the begin and end of tasks and build phases into per
+   *  thread ring buffers and writes them in the Chrome trace event
+   *  format, which can be viewed with chrome://tracing or Perfetto.
+   *  The tracer is disabled by default, then each traced scope costs a
+   *  single load and branch. */
+  class Tracer
+  {
+  public:
+
+    /*! starts tracing into ring buffers of bufferSize events per thread, returns false if already tracing */
+    static bool start(size_t bufferSize);
+
+    /*! stops tracing and writes all recorded events to a JSON file, returns false if the file cannot get written */
+    static bool stop(const char* fileName);
+
+    /*! returns true if events get recorded */
+    static __forceinline bool enabled() {
+      return active.load(std::memory_order_relaxed);
+    }
+
+    /*! records an event of the calling thread, the name has to be a string literal */
+    static void record(const char* name, uint64_t t0, uint64_t t1);
+
+  private:
+    static std::atomic<bool> active;
+  };
+
+  /*! records the lifetime of the object as trace event */
+  struct TraceScope
+  {
+    __forceinline TraceScope (const char* name)
+      : name(Tracer::enabled() ? name : nullptr), t0(this->name ? read_tsc() : 0) {}
+
+    __forceinline ~TraceScope() {
+      if (unlikely(name != nullptr)) Tracer::record(name,t0,read_tsc());
+    }
+
+  private:
+    const char* name;
+    uint64_t t0;
+  };
+}
@@ -17,6 +17,7 @@
 #include "taskschedulerinternal.h"
 #include "../math/math.h"
 #include "../sys/sysinfo.h"
+#include "../sys/tracer.h"
 #include <algorithm>
 
 namespace embree
@@ -43,6 +44,7 @@ namespace embree
           if (!pred()) return;
           if (thread.scheduler->steal_from_other_threads(thread)) {
             i=j=0;
+            TRACE_SCOPE("steal");
             body();
           }
         }
@@ -149,7 +151,7 @@ namespace embree
   }
 
   TaskScheduler::ThreadPool::ThreadPool(bool set_affinity)
-    : numThreads(0), numThreadsRunning(0), set_affinity(set_affinity), running(false) {}
+    : numThreads(0), numThreadsRunning(0), set_affinity(set_affinity), running(false), numForegroundBuilds(0) {}
 
   dll_export void TaskScheduler::ThreadPool::startThreads()
   {
@@ -206,6 +208,7 @@ namespace embree
   {
     mutex.lock();
     schedulers.push_back(scheduler);
+    if (scheduler->priority == FOREGROUND_BUILD) numForegroundBuilds++;
     mutex.unlock();
     condition.notify_all();
   }
@@ -215,6 +218,7 @@ namespace embree
     Lock<MutexSys> lock(mutex);
     for (std::list<Ref<TaskScheduler> >::iterator it = schedulers.begin(); it != schedulers.end(); it++) {
       if (scheduler == *it) {
+        if (scheduler->priority == FOREGROUND_BUILD) numForegroundBuilds--;
         schedulers.erase(it);
         return;
       }
@@ -232,14 +236,33 @@ namespace embree
         condition.wait(mutex, [&] () { return globalThreadIndex >= numThreadsRunning || !schedulers.empty(); });
         if (globalThreadIndex >= numThreadsRunning) break;
         scheduler = schedulers.front();
+        for (auto& s : schedulers) {
+          if (s->priority != BACKGROUND_BUILD) { scheduler = s; break; }
+        }
         threadIndex = scheduler->allocThreadIndex();
       }
       scheduler->thread_loop(threadIndex);
     }
   }
 
-  TaskScheduler::TaskScheduler()
-    : threadCounter(0), anyTasksRunning(0), hasRootTask(false)
+  bool TaskScheduler::ThreadPool::joinForegroundBuild()
+  {
+    Ref<TaskScheduler> scheduler = nullptr;
+    ssize_t threadIndex = -1;
+    {
+      Lock<MutexSys> lock(mutex);
+      for (auto& s : schedulers) {
+        if (s->priority == FOREGROUND_BUILD) { scheduler = s; break; }
+      }
+      if (scheduler == null) return false;
+      threadIndex = scheduler->allocThreadIndex();
+    }
+    scheduler->thread_loop(threadIndex);
+    return true;
+  }
+
+  TaskScheduler::TaskScheduler(Priority priority)
+    : threadCounter(0), anyTasksRunning(0), hasRootTask(false), numSockets(getNumberOfSockets()), priority(priority)
   {
     threadLocal.resize(2*getNumberOfLogicalThreads()); // FIXME: this has to be 2x as in the compatibility join mode with rtcCommitScene the worker threads also join. When disallowing rtcCommitScene to join a build we can remove the 2x.
     for (size_t i=0; i<threadLocal.size(); i++)
@@ -269,6 +292,10 @@ namespace embree
     return threadPool->size();
   }
 
+  dll_export size_t TaskScheduler::threadSocket() {
+    return getSocketOfCurrentThread();
+  }
+
   dll_export TaskScheduler* TaskScheduler::instance()
   {
     if (g_instance == NULL) {
@@ -347,12 +374,16 @@ namespace embree
     while (anyTasksRunning)
     {
       steal_loop(thread,
-                 [&] () { return anyTasksRunning > 0; },
+                 [&] () { return anyTasksRunning > 0 && !preempted(); },
                  [&] () {
                    anyTasksRunning++;
                    while (thread.tasks.execute_local_internal(thread,nullptr));
                    anyTasksRunning--;
                  });
+
+      /* threads of a background build help foreground builds first, the local task queue is empty here */
+      if (preempted())
+        threadPool->joinForegroundBuild();
     }
     threadLocal[threadIndex].store(nullptr);
     swapThread(oldThread);
@@ -386,18 +417,29 @@ namespace embree
     const size_t threadIndex = thread.threadIndex;
     const size_t threadCount = this->threadCounter;
 
-    for (size_t i=1; i<threadCount; i++)
+    /* threads that are not pinned can migrate to another socket */
+    if (numSockets > 1)
+      thread.socket = getSocketOfCurrentThread();
+
+    /* on multi-socket systems first steal from threads of the same socket, then from all other threads */
+    for (size_t pass=(numSockets > 1) ? 0 : 1; pass<2; pass++)
     {
-      pause_cpu(32);
-      size_t otherThreadIndex = threadIndex+i;
-      if (otherThreadIndex >= threadCount) otherThreadIndex -= threadCount;
+      for (size_t i=1; i<threadCount; i++)
+      {
+        size_t otherThreadIndex = threadIndex+i;
+        if (otherThreadIndex >= threadCount) otherThreadIndex -= threadCount;
+
+        Thread* othread = threadLocal[otherThreadIndex].load();
+        if (!othread)
+          continue;
 
-      Thread* othread = threadLocal[otherThreadIndex].load();
-      if (!othread)
-        continue;
+        if (numSockets > 1 && (othread->socket == thread.socket) != (pass == 0))
+          continue;
 
-      if (othread->tasks.steal(thread))
-        return true;
+        pause_cpu(32);
+        if (othread->tasks.steal(thread))
+          return true;
+      }
     }
 
     return false;
@@ -24,6 +24,7 @@
 #include "../sys/condition.h"
 #include "../sys/ref.h"
 #include "../sys/atomic.h"
+#include "../sys/sysinfo.h"
 #include "../math/range.h"
 
 #include <list>
@@ -176,18 +177,27 @@ namespace embree
       ALIGNED_STRUCT_(64);
 
       Thread (size_t threadIndex, const Ref<TaskScheduler>& scheduler)
-      : threadIndex(threadIndex), task(nullptr), scheduler(scheduler) {}
+      : threadIndex(threadIndex), socket(getSocketOfCurrentThread()), task(nullptr), scheduler(scheduler) {}
 
       __forceinline size_t threadCount() {
         return scheduler->threadCounter;
       }
 
       size_t threadIndex;              //!< ID of this thread
+      std::atomic<size_t> socket;      //!< CPU socket this thread last ran on
       TaskQueue tasks;                 //!< local task queue
       Task* task;                      //!< current active task
       Ref<TaskScheduler> scheduler;     //!< pointer to task scheduler
     };
 
+    /*! priority of a task scheduler, only foreground builds pre-empt background builds */
+    enum Priority
+    {
+      DEFAULT_PRIORITY,  //!< parallel loops spawned outside of a build
+      FOREGROUND_BUILD,  //!< build of a scene without RTC_SCENE_FLAG_BACKGROUND_BUILD
+      BACKGROUND_BUILD   //!< build of a scene with RTC_SCENE_FLAG_BACKGROUND_BUILD
+    };
+
     /*! pool of worker threads */
     struct ThreadPool
     {
@@ -212,6 +222,14 @@ namespace embree
       /*! main loop for all threads */
       void thread_loop(size_t threadIndex);
 
+      /*! returns true if some foreground build is waiting for threads */
+      __forceinline bool hasForegroundBuilds() const {
+        return numForegroundBuilds > 0;
+      }
+
+      /*! lets the calling thread help some foreground build until it finished */
+      bool joinForegroundBuild();
+
     private:
       std::atomic<size_t> numThreads;
       std::atomic<size_t> numThreadsRunning;
@@ -223,9 +241,10 @@ namespace embree
       MutexSys mutex;
       ConditionSys condition;
       std::list<Ref<TaskScheduler> > schedulers;
+      std::atomic<size_t> numForegroundBuilds;
     };
 
-    TaskScheduler ();
+    TaskScheduler (Priority priority = DEFAULT_PRIORITY);
     ~TaskScheduler ();
 
     /*! initializes the task scheduler */
@@ -250,6 +269,11 @@ namespace embree
     /*! steals a task from a different thread */
     bool steal_from_other_threads(Thread& thread);
 
+    /*! returns true if threads of this background build should help some foreground build */
+    __forceinline bool preempted() const {
+      return priority == BACKGROUND_BUILD && threadPool && threadPool->hasForegroundBuilds();
+    }
+
     template<typename Predicate, typename Body>
       static void steal_loop(Thread& thread, const Predicate& pred, const Body& body);
 
@@ -339,6 +363,9 @@ namespace embree
     /* returns the total number of threads */
     dll_export static size_t threadCount();
 
+    /* returns the CPU socket of the current thread, tasks spawned by a thread are preferably stolen by threads of the same socket */
+    dll_export static size_t threadSocket();
+
   private:
 
     /* returns the thread local task list of this worker thread */
@@ -364,6 +391,8 @@ namespace embree
     std::atomic<size_t> threadCounter;
     std::atomic<size_t> anyTasksRunning;
     std::atomic<bool> hasRootTask;
+    size_t numSockets;
+    Priority priority;   //!< threads of background builds leave to help foreground builds
     std::exception_ptr cancellingException;
     MutexSys mutex;
     ConditionSys condition;
@@ -23,6 +23,7 @@
 #include "../sys/mutex.h"
 #include "../sys/condition.h"
 #include "../sys/ref.h"
+#include "../sys/sysinfo.h"
 
 #if !defined(__WIN32__)
 #error PPL tasking system only available under windows
@@ -55,5 +56,10 @@ namespace embree
     static __forceinline size_t threadCount() {
       return GetMaximumProcessorCount(ALL_PROCESSOR_GROUPS) + 1;
     }
+
+    /* returns the CPU socket of the current thread */
+    static __forceinline size_t threadSocket() {
+      return getSocketOfCurrentThread();
+    }
   };
 };
@@ -23,6 +23,7 @@
 #include "../sys/mutex.h"
 #include "../sys/condition.h"
 #include "../sys/ref.h"
+#include "../sys/sysinfo.h"
 
 #if defined(__WIN32__)
 #  define NOMINMAX
@@ -74,6 +75,11 @@ namespace embree
 #endif
     }
 
+    /* returns the CPU socket of the current thread */
+    static __forceinline size_t threadSocket() {
+      return getSocketOfCurrentThread();
+    }
+
   };
 
 };
@@ -41,7 +41,9 @@ enum RTCBufferType
   RTC_BUFFER_TYPE_VERTEX_CREASE_WEIGHT = 21,
   RTC_BUFFER_TYPE_HOLE                 = 22,
 
-  RTC_BUFFER_TYPE_FLAGS = 32
+  RTC_BUFFER_TYPE_FLAGS = 32,
+
+  RTC_BUFFER_TYPE_OPACITY_MICROMAP = 40
 };
 
 /* Opaque buffer type */
@@ -53,6 +55,9 @@ RTC_API RTCBuffer rtcNewBuffer(RTCDevice device, size_t byteSize);
 /* Creates a new shared buffer. */
 RTC_API RTCBuffer rtcNewSharedBuffer(RTCDevice device, void* ptr, size_t byteSize);
 
+/* Creates a new buffer that maps a range of a file into memory. */
+RTC_API RTCBuffer rtcNewMappedBuffer(RTCDevice device, const char* fileName, size_t byteOffset, size_t byteSize);
+
 /* Returns a pointer to the buffer data. */
 RTC_API void* rtcGetBufferData(RTCBuffer buffer);
 
@@ -165,7 +165,13 @@ enum RTCFormat
   RTC_FORMAT_FLOAT4X4_COLUMN_MAJOR = 0x9244,
 
   /* special 12-byte format for grids */
-  RTC_FORMAT_GRID = 0xA001
+  RTC_FORMAT_GRID = 0xA001,
+
+  /* 16-bit float */
+  RTC_FORMAT_HALF = 0xB001,
+  RTC_FORMAT_HALF2,
+  RTC_FORMAT_HALF3,
+  RTC_FORMAT_HALF4
 };
 
 /* Build quality levels */
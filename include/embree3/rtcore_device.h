@@ -60,7 +60,9 @@ enum RTCDeviceProperty
   RTC_DEVICE_PROPERTY_POINT_GEOMETRY_SUPPORTED       = 101,
 
   RTC_DEVICE_PROPERTY_TASKING_SYSTEM        = 128,
-  RTC_DEVICE_PROPERTY_JOIN_COMMIT_SUPPORTED = 129
+  RTC_DEVICE_PROPERTY_JOIN_COMMIT_SUPPORTED = 129,
+
+  RTC_DEVICE_PROPERTY_TRAVERSAL_COUNTERS_ENABLED = 160
 };
 
 /* Gets a device property. */
@@ -96,6 +98,25 @@ typedef bool (*RTCMemoryMonitorFunction)(void* ptr, ssize_t bytes, bool post);
 /* Sets the memory monitor callback function. */
 RTC_API void rtcSetDeviceMemoryMonitorFunction(RTCDevice device, RTCMemoryMonitorFunction memoryMonitor, void* userPtr);
 
+/* Traversal counters of a single thread */
+struct RTCTraversalCounters
+{
+  unsigned int threadIndex;        // index of the thread in order of its first counted traversal
+  size_t traversals;               // number of BVH traversals
+  size_t nodes;                    // number of visited inner nodes
+  size_t leaves;                   // number of visited leaf nodes
+  size_t primitives;               // number of primitive tests
+  size_t filterCalls;              // number of intersection and occlusion filter function calls
+  size_t instanceTransitions;      // number of transitions into instanced scenes
+  size_t maxStackDepth;            // maximal depth of the traversal stack
+};
+
+/* Gets the traversal counters of at most maxCount threads and returns the number of threads. */
+RTC_API size_t rtcGetDeviceTraversalCounters(RTCDevice device, struct RTCTraversalCounters* counters, size_t maxCount);
+
+/* Resets the traversal counters of all threads to zero. */
+RTC_API void rtcResetDeviceTraversalCounters(RTCDevice device);
+
 #if defined(__cplusplus)
 }
 #endif
@@ -37,6 +37,7 @@ enum RTCGeometryType
 
   RTC_GEOMETRY_TYPE_SUBDIVISION = 8, // Catmull-Clark subdivision surface
 
+  RTC_GEOMETRY_TYPE_ROUND_LINEAR_CURVE  = 16, // round (tube-like) linear curves with spherical joints
   RTC_GEOMETRY_TYPE_FLAT_LINEAR_CURVE   = 17, // flat (ribbon-like) linear curves
 
   RTC_GEOMETRY_TYPE_ROUND_BEZIER_CURVE  = 24, // round (tube-like) Bezier curves
@@ -97,6 +98,9 @@ struct RTCIntersectFunctionNArguments
   struct RTCIntersectContext* context;
   struct RTCRayHitN* rayhit;
   unsigned int N;
+  const unsigned int* primIDs;
+  unsigned int numPrimIDs;
+  const struct RTCRayCone* cone;
 };
 
 /* Intersection callback function */
@@ -111,11 +115,26 @@ struct RTCOccludedFunctionNArguments
   struct RTCIntersectContext* context;
   struct RTCRayN* ray;
   unsigned int N;
+  const unsigned int* primIDs;
+  unsigned int numPrimIDs;
+  const struct RTCRayCone* cone;
 };
 
 /* Occlusion callback function */
 typedef void (*RTCOccludedFunctionN)(const struct RTCOccludedFunctionNArguments* args);
 
+/* Arguments for RTCOpacityFunction */
+struct RTCOpacityFunctionArguments
+{
+  void* geometryUserPtr;
+  struct RTCIntersectContext* context;
+  struct RTCRay* ray;
+  struct RTCHit* hit;
+};
+
+/* Opacity callback function */
+typedef float (*RTCOpacityFunction)(const struct RTCOpacityFunctionArguments* args);
+
 /* Arguments for RTCDisplacementFunctionN */
 struct RTCDisplacementFunctionNArguments
 {
@@ -195,6 +214,9 @@ RTC_API void rtcSetGeometryIntersectFilterFunction(RTCGeometry geometry, RTCFilt
 /* Sets the occlusion filter callback function of the geometry. */
 RTC_API void rtcSetGeometryOccludedFilterFunction(RTCGeometry geometry, RTCFilterFunctionN filter);
 
+/* Sets the opacity callback function of the geometry used by transmittance queries. */
+RTC_API void rtcSetGeometryOpacityFunction(RTCGeometry geometry, RTCOpacityFunction opacity);
+
 /* Sets the user-defined data pointer of the geometry. */
 RTC_API void rtcSetGeometryUserData(RTCGeometry geometry, void* ptr);
 
@@ -214,6 +236,12 @@ RTC_API void rtcSetGeometryIntersectFunction(RTCGeometry geometry, RTCIntersectF
 /* Set the occlusion callback function of a user geometry. */
 RTC_API void rtcSetGeometryOccludedFunction(RTCGeometry geometry, RTCOccludedFunctionN occluded);
 
+/* Set the intersect callback function of a user geometry that intersects multiple primitives per invocation. */
+RTC_API void rtcSetGeometryIntersectBatchFunction(RTCGeometry geometry, RTCIntersectFunctionN intersect);
+
+/* Set the occlusion callback function of a user geometry that tests multiple primitives per invocation. */
+RTC_API void rtcSetGeometryOccludedBatchFunction(RTCGeometry geometry, RTCOccludedFunctionN occluded);
+
 /* Invokes the intersection filter from the intersection callback function. */
 RTC_API void rtcFilterIntersection(const struct RTCIntersectFunctionNArguments* args, const struct RTCFilterFunctionNArguments* filterArgs);
 
@@ -224,6 +252,9 @@ RTC_API void rtcFilterOcclusion(const struct RTCOccludedFunctionNArguments* args
 /* Sets the instanced scene of an instance geometry. */
 RTC_API void rtcSetGeometryInstancedScene(RTCGeometry geometry, RTCScene scene);
 
+/* Sets the instanced scene of an instance geometry for a level of detail. */
+RTC_API void rtcSetGeometryInstancedSceneLOD(RTCGeometry geometry, unsigned int level, RTCScene scene, float distance, float blendRange);
+
 /* Sets the transformation of an instance for the specified time step. */
 RTC_API void rtcSetGeometryTransform(RTCGeometry geometry, unsigned int timeStep, enum RTCFormat format, const void* xfm);
 
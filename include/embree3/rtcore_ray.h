@@ -63,6 +63,20 @@ struct RTCRayHit
   struct RTCHit hit;
 };
 
+/* Ray cone of a single ray, e.g. for level of detail selection */
+struct RTCRayCone
+{
+  float width;         // cone width at the ray origin
+  float spreadAngle;   // cone spread angle in radians
+};
+
+/* Hit structure of a multi-hit query */
+struct RTCMultiHit
+{
+  float t;             // hit distance
+  struct RTCHit hit;
+};
+
 /* Ray structure for a packet of 4 rays */
 struct RTC_ALIGN(16) RTCRay4
 {
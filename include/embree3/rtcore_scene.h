@@ -36,7 +36,10 @@ enum RTCSceneFlags
   RTC_SCENE_FLAG_DYNAMIC                 = (1 << 0),
   RTC_SCENE_FLAG_COMPACT                 = (1 << 1),
   RTC_SCENE_FLAG_ROBUST                  = (1 << 2),
-  RTC_SCENE_FLAG_CONTEXT_FILTER_FUNCTION = (1 << 3)
+  RTC_SCENE_FLAG_CONTEXT_FILTER_FUNCTION = (1 << 3),
+  RTC_SCENE_FLAG_BACKGROUND_BUILD        = (1 << 4),
+  RTC_SCENE_FLAG_AUTO_INSTANCING         = (1 << 5),
+  RTC_SCENE_FLAG_BUILD_REPORT            = (1 << 6)
 };
 
 /* Creates a new scene. */
@@ -84,6 +87,26 @@ RTC_API void rtcSetSceneFlags(RTCScene scene, enum RTCSceneFlags flags);
 /* Returns the scene flags. */
 RTC_API enum RTCSceneFlags rtcGetSceneFlags(RTCScene scene);
 
+/* Build report of the last scene commit */
+struct RTCSceneBuildReport
+{
+  double commitTime;
+  double primRefTime;
+  double hierarchyTime;
+  double spatialSplitTime;
+  double leafTime;
+  unsigned int numThreads;
+  unsigned int numBVHs;
+  size_t numPrimitives;
+  size_t bytesAllocated;
+  size_t bytesUsed;
+  size_t bytesWasted;
+  float sahCost;
+};
+
+/* Returns the build report of the last scene commit. */
+RTC_API void rtcGetSceneBuildReport(RTCScene scene, struct RTCSceneBuildReport* report);
+
 /* Returns the axis-aligned bounds of the scene. */
 RTC_API void rtcGetSceneBounds(RTCScene scene, struct RTCBounds* bounds_o);
 
@@ -93,6 +116,12 @@ RTC_API void rtcGetSceneLinearBounds(RTCScene scene, struct RTCLinearBounds* bou
 /* Intersects a single ray with the scene. */
 RTC_API void rtcIntersect1(RTCScene scene, struct RTCIntersectContext* context, struct RTCRayHit* rayhit);
 
+/* Intersects a single ray with the scene and gathers the hits closest to the ray origin sorted by distance. */
+RTC_API unsigned int rtcIntersectMultiHit1(RTCScene scene, struct RTCIntersectContext* context, struct RTCRay* ray, struct RTCMultiHit* hits, unsigned int maxHitCount);
+
+/* Intersects a single ray with a ray cone with the scene. */
+RTC_API void rtcIntersectCone1(RTCScene scene, struct RTCIntersectContext* context, struct RTCRayHit* rayhit, const struct RTCRayCone* cone);
+
 /* Intersects a packet of 4 rays with the scene. */
 RTC_API void rtcIntersect4(const int* valid, RTCScene scene, struct RTCIntersectContext* context, struct RTCRayHit4* rayhit);
 
@@ -117,6 +146,12 @@ RTC_API void rtcIntersectNp(RTCScene scene, struct RTCIntersectContext* context,
 /* Tests a single ray for occlusion with the scene. */
 RTC_API void rtcOccluded1(RTCScene scene, struct RTCIntersectContext* context, struct RTCRay* ray);
 
+/* Tests a single ray for occlusion and returns the transmittance accumulated from the opacity of all hits along the ray. */
+RTC_API float rtcOccludedTransmittance1(RTCScene scene, struct RTCIntersectContext* context, struct RTCRay* ray, float minTransmittance);
+
+/* Tests a single ray with a ray cone for occlusion with the scene. */
+RTC_API void rtcOccludedCone1(RTCScene scene, struct RTCIntersectContext* context, struct RTCRay* ray, const struct RTCRayCone* cone);
+
 /* Tests a packet of 4 rays for occlusion occluded with the scene. */
 RTC_API void rtcOccluded4(const int* valid, RTCScene scene, struct RTCIntersectContext* context, struct RTCRay4* ray);
 
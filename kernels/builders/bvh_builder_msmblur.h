@@ -18,6 +18,8 @@
 
 #define MBLUR_NUM_TEMPORAL_BINS 2
 #define MBLUR_NUM_OBJECT_BINS   32
+#define MBLUR_MANY_TIME_SEGMENTS 4
+#define MBLUR_MANY_TIME_SEGMENTS_SPLIT_THRESHOLD 1.0f
 
 #include "../bvh/bvh.h"
 #include "../common/primref_mb.h"
@@ -196,7 +198,7 @@ namespace embree
         Settings ()
         : branchingFactor(2), maxDepth(32), logBlockSize(0), minLeafSize(1), maxLeafSize(8),
           travCost(1.0f), intCost(1.0f), singleLeafTimeSegment(false),
-          singleThreadThreshold(1024) {}
+          singleThreadThreshold(1024), manyTimeSegments(0) {}
 
       public:
         size_t branchingFactor;  //!< branching factor of BVH to build
@@ -208,6 +210,7 @@ namespace embree
         float intCost;           //!< estimated cost of one primitive intersection
         bool singleLeafTimeSegment; //!< split time to single time range
         size_t singleThreadThreshold; //!< threshold when we switch to single threaded build
+        size_t manyTimeSegments; //!< always test temporal splits for subtrees spanning at least that many time segments (0 disables)
       };
 
       struct BuildRecord
@@ -297,15 +300,20 @@ namespace embree
             const Split object_split = heuristicObjectSplit.find(set,cfg.logBlockSize);
             const float object_split_sah = object_split.splitSAH();
 
-            /* test temporal splits only when object split was bad */
+            /* test temporal splits only when object split was bad, or
+             * when the subtree spans many time segments, as linear bounds
+             * fitted over many time steps of deforming geometry grow fast
+             * and temporal splits get favoured there */
             const float leaf_sah = set.leafSAH(cfg.logBlockSize);
-            if (object_split_sah < 0.50f*leaf_sah)
+            const float num_time_segments = set.time_range.size()*float(set.max_num_time_segments);
+            const bool many_time_segments = cfg.manyTimeSegments && num_time_segments > float(cfg.manyTimeSegments)-0.01f;
+            if (object_split_sah < 0.50f*leaf_sah && !many_time_segments)
               return object_split;
 
             /* do temporal splits only if the the time range is big enough */
             if (set.time_range.size() > 1.01f/float(set.max_num_time_segments))
             {
-              const Split temporal_split = heuristicTemporalSplit.find(set,cfg.logBlockSize);
+              const Split temporal_split = heuristicTemporalSplit.find(set,cfg.logBlockSize,many_time_segments ? MBLUR_MANY_TIME_SEGMENTS_SPLIT_THRESHOLD : MBLUR_TIME_SPLIT_THRESHOLD);
               const float temporal_split_sah = temporal_split.splitSAH();
 
               /* take temporal split if it improved SAH */
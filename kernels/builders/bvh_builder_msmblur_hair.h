@@ -21,6 +21,7 @@
 #include "../builders/bvh_builder_msmblur.h"
 #include "../builders/heuristic_binning_array_aligned.h"
 #include "../builders/heuristic_binning_array_unaligned.h"
+#include "../builders/heuristic_strand_array.h"
 #include "../builders/heuristic_timesplit_array.h"
 
 namespace embree
@@ -91,6 +92,7 @@ namespace embree
           typedef HeuristicMBlurTemporalSplit<PrimRefMB,RecalculatePrimRef,MBLUR_NUM_TEMPORAL_BINS> HeuristicTemporal;
           typedef HeuristicArrayBinningMB<PrimRefMB,MBLUR_NUM_OBJECT_BINS> HeuristicBinning;
           typedef UnalignedHeuristicArrayBinningMB<PrimRefMB,MBLUR_NUM_OBJECT_BINS> UnalignedHeuristicBinning;
+          typedef HeuristicStrandSplitMB HeuristicStrand;
 
         public:
 
@@ -114,6 +116,7 @@ namespace embree
             createLeaf(createLeaf),
             progressMonitor(progressMonitor),
             unalignedHeuristic(scene),
+            strandHeuristic(scene),
             temporalSplitHeuristic(scene->device,recalculatePrimRef) {}
 
         private:
@@ -278,6 +281,15 @@ namespace embree
               bestSAH = min(unalignedObjectSAH,bestSAH);
             }
 
+            /* try splitting into two strands of different orientation */
+            typename HeuristicStrand::Split strandSplit;
+            float strandSAH = inf;
+            if (bestSAH > 0.7f*leafSAH && current.size() <= 256) {
+              strandSplit = strandHeuristic.find(current.prims,cfg.logBlockSize);
+              strandSAH = 1.3f*strandSplit.splitSAH(); // same penalty as unaligned splits
+              bestSAH = min(strandSAH,bestSAH);
+            }
+
             /* do temporal splits only if previous approaches failed to produce good SAH and the the time range is large enough */
             float temporal_split_sah = inf;
             typename HeuristicTemporal::Split temporal_split;
@@ -303,6 +315,11 @@ namespace embree
               unalignedHeuristic.split(unalignedObjectSplit,uspace,current.prims,lrecord.prims,rrecord.prims);
               aligned = false;
             }
+            /* perform strand split if this is best */
+            else if (likely(bestSAH == strandSAH)) {
+              strandHeuristic.split(strandSplit,current.prims,lrecord.prims,rrecord.prims);
+              aligned = false;
+            }
             /* perform temporal split if this is best */
             else if (likely(bestSAH == temporal_split_sah)) {
               timesplit = true;
@@ -496,6 +513,7 @@ namespace embree
         private:
           HeuristicBinning alignedHeuristic;
           UnalignedHeuristicBinning unalignedHeuristic;
+          HeuristicStrand strandHeuristic;
           HeuristicTemporal temporalSplitHeuristic;
         };
 
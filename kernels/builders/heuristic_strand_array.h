@@ -197,5 +197,142 @@ namespace embree
       Scene* const scene;
       PrimRef* const prims;
     };
+
+    /*! Splits motion blurred hair into two strands of different orientation */
+    struct HeuristicStrandSplitMB
+    {
+      /*! stores all information to perform some split */
+      struct Split
+      {
+        /*! construct an invalid split by default */
+        __forceinline Split()
+          : sah(inf), axis0(zero), axis1(zero) {}
+
+        /*! constructs specified split */
+        __forceinline Split(const float sah, const Vec3fa& axis0, const Vec3fa& axis1)
+          : sah(sah), axis0(axis0), axis1(axis1) {}
+
+        /*! calculates standard surface area heuristic for the split */
+        __forceinline float splitSAH() const { return sah; }
+
+        /*! test if this split is valid */
+        __forceinline bool valid() const { return sah != float(inf); }
+
+      public:
+        float sah;             //!< SAH cost of the split
+        Vec3fa axis0, axis1;   //!< axis the two strands are aligned into
+      };
+
+      __forceinline HeuristicStrandSplitMB (Scene* scene)
+        : scene(scene) {}
+
+      /*! curve direction at the center of the time range, matches the space used for unaligned MB nodes */
+      __forceinline const Vec3fa direction(const PrimRefMB& prim, const BBox1f& time_range)
+      {
+        const Geometry* mesh = scene->get(prim.geomID());
+        const range<int> tbounds = mesh->timeSegmentRange(time_range);
+        if (tbounds.size() == 0) return Vec3fa(zero);
+        const size_t t = (tbounds.begin()+tbounds.end())/2;
+        return mesh->computeDirection(prim.primID(),t);
+      }
+
+      __forceinline const LBBox3fa linearBounds(const LinearSpace3fa& space, const PrimRefMB& prim, const BBox1f& time_range) {
+        return scene->get(prim.geomID())->vlinearBounds(space,prim.primID(),time_range);
+      }
+
+      /*! finds the best split */
+      const Split find(const SetMB& set, size_t logBlockSize)
+      {
+        mvector<PrimRefMB>& prims = *set.prims;
+        Vec3fa axis0(0,0,1);
+        uint64_t bestGeomPrimID = -1;
+
+        /* curve with minimum ID determines first axis */
+        for (size_t i=set.begin(); i<set.end(); i++)
+        {
+          const uint64_t geomprimID = prims[i].ID64();
+          if (geomprimID >= bestGeomPrimID) continue;
+          const Vec3fa axis = direction(prims[i],set.time_range);
+          if (sqr_length(axis) > 1E-18f) {
+            axis0 = normalize(axis);
+            bestGeomPrimID = geomprimID;
+          }
+        }
+
+        /* find 2nd axis that is most misaligned with first axis and has minimum ID */
+        float bestCos = 1.0f;
+        Vec3fa axis1 = axis0;
+        bestGeomPrimID = -1;
+        for (size_t i=set.begin(); i<set.end(); i++)
+        {
+          const uint64_t geomprimID = prims[i].ID64();
+          Vec3fa axisi = direction(prims[i],set.time_range);
+          float leni = length(axisi);
+          if (leni == 0.0f) continue;
+          axisi /= leni;
+          float cos = abs(dot(axisi,axis0));
+          if ((cos == bestCos && (geomprimID < bestGeomPrimID)) || cos < bestCos) {
+            bestCos = cos; axis1 = axisi;
+            bestGeomPrimID = geomprimID;
+          }
+        }
+
+        /* partition the two strands, each strand is bounded by linear bounds in its own space */
+        size_t lnum = 0, rnum = 0;
+        LBBox3fa lbounds = empty, rbounds = empty;
+        const LinearSpace3fa space0 = frame(axis0).transposed();
+        const LinearSpace3fa space1 = frame(axis1).transposed();
+
+        for (size_t i=set.begin(); i<set.end(); i++)
+        {
+          const PrimRefMB& prim = prims[i];
+          const Vec3fa axisi = normalize(direction(prim,set.time_range));
+          const float cos0 = abs(dot(axisi,axis0));
+          const float cos1 = abs(dot(axisi,axis1));
+
+          if (cos0 > cos1) { lnum += prim.size(); lbounds.extend(linearBounds(space0,prim,set.time_range)); }
+          else             { rnum += prim.size(); rbounds.extend(linearBounds(space1,prim,set.time_range)); }
+        }
+
+        /*! return an invalid split if we do not partition */
+        if (lnum == 0 || rnum == 0)
+          return Split(inf,axis0,axis1);
+
+        /*! calculate sah for the split */
+        const size_t lblocks = (lnum+(1ull<<logBlockSize)-1ull) >> logBlockSize;
+        const size_t rblocks = (rnum+(1ull<<logBlockSize)-1ull) >> logBlockSize;
+        const float sah = madd(float(lblocks),expectedApproxHalfArea(lbounds),float(rblocks)*expectedApproxHalfArea(rbounds));
+        return Split(set.time_range.size()*sah,axis0,axis1);
+      }
+
+      /*! array partitioning */
+      void split(const Split& split, const SetMB& set, SetMB& lset, SetMB& rset)
+      {
+        assert(split.valid());
+        const size_t begin = set.begin();
+        const size_t end   = set.end();
+        PrimInfoMB left = empty;
+        PrimInfoMB right = empty;
+
+        auto primOnLeftSide = [&] (const PrimRefMB& prim) -> bool {
+          const Vec3fa axisi = normalize(direction(prim,set.time_range));
+          const float cos0 = abs(dot(axisi,split.axis0));
+          const float cos1 = abs(dot(axisi,split.axis1));
+          return cos0 > cos1;
+        };
+
+        auto mergePrimInfo = [] (PrimInfoMB& pinfo, const PrimRefMB& ref) {
+          pinfo.add_primref(ref);
+        };
+
+        size_t center = serial_partitioning(set.prims->data(),begin,end,left,right,primOnLeftSide,mergePrimInfo);
+
+        new (&lset) SetMB(left, set.prims,range<size_t>(begin,center),set.time_range);
+        new (&rset) SetMB(right,set.prims,range<size_t>(center,end  ),set.time_range);
+      }
+
+    private:
+      Scene* const scene;
+    };
   }
 }
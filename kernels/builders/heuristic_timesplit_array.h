@@ -124,7 +124,7 @@ namespace embree
             TemporalBinInfo r = a; r.merge(b); return r;
           }
                     
-          Split best(int logBlockSize, BBox1f time_range, const SetMB& set)
+          Split best(int logBlockSize, BBox1f time_range, const SetMB& set, float splitThreshold)
           {
             float bestSAH = inf;
             float bestPos = 0.0f;
@@ -152,7 +152,7 @@ namespace embree
               }
             }
             assert(bestSAH != float(inf));
-            return Split(bestSAH*MBLUR_TIME_SPLIT_THRESHOLD,(unsigned)Split::SPLIT_TEMPORAL,0,bestPos);
+            return Split(bestSAH*splitThreshold,(unsigned)Split::SPLIT_TEMPORAL,0,bestPos);
           }
           
         public:
@@ -163,12 +163,12 @@ namespace embree
         };
         
         /*! finds the best split */
-        const Split find(const SetMB& set, const size_t logBlockSize)
+        const Split find(const SetMB& set, const size_t logBlockSize, const float splitThreshold = MBLUR_TIME_SPLIT_THRESHOLD)
         {
           assert(set.size() > 0);
           TemporalBinInfo binner(empty);
           binner.bin_parallel(set.prims->data(),set.begin(),set.end(),PARALLEL_FIND_BLOCK_SIZE,PARALLEL_THRESHOLD,set.time_range,set,recalculatePrimRef);
-          Split tsplit = binner.best((int)logBlockSize,set.time_range,set);
+          Split tsplit = binner.best((int)logBlockSize,set.time_range,set,splitThreshold);
           if (!tsplit.valid()) tsplit.data = Split::SPLIT_FALLBACK; // use fallback split
           return tsplit;
         }
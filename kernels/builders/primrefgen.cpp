@@ -23,6 +23,27 @@ namespace embree
 {
   namespace isa
   {
+    /* processes the primitive range in blocks and lets the OS page in
+     * the memory mapped buffers of the next block while the current
+     * block gets processed */
+    template<typename Func>
+    static __forceinline PrimInfo prefetchBlocks(const Geometry* mesh, const range<size_t>& r, size_t k, const Func& func)
+    {
+      const size_t blockSize = 4096;
+      const range<size_t> r0(r.begin(),min(r.begin()+blockSize,r.end()));
+      if (likely(!mesh->prefetchPrimRefs(r0)))
+        return func(r,k);
+
+      PrimInfo pinfo(empty);
+      for (size_t i=r.begin(); i<r.end(); i+=blockSize)
+      {
+        const size_t end = min(i+blockSize,r.end());
+        if (end < r.end()) mesh->prefetchPrimRefs(range<size_t>(end,min(end+blockSize,r.end())));
+        pinfo.merge(func(range<size_t>(i,end),k+pinfo.size()));
+      }
+      return pinfo;
+    }
+
     PrimInfo createPrimRefArray(Geometry* geometry, mvector<PrimRef>& prims, BuildProgressMonitor& progressMonitor)
     {
       ParallelPrefixSumState<PrimInfo> pstate;
@@ -30,7 +51,7 @@ namespace embree
       /* first try */
       progressMonitor(0);
       PrimInfo pinfo = parallel_prefix_sum( pstate, size_t(0), geometry->size(), size_t(1024), PrimInfo(empty), [&](const range<size_t>& r, const PrimInfo& base) -> PrimInfo {
-          return geometry->createPrimRefArray(prims,r,r.begin());
+          return prefetchBlocks(geometry,r,r.begin(),[&] (const range<size_t>& rb, size_t kb) { return geometry->createPrimRefArray(prims,rb,kb); });
         }, [](const PrimInfo& a, const PrimInfo& b) -> PrimInfo { return PrimInfo::merge(a,b); });
 
       /* if we need to filter out geometry, run again */
@@ -38,7 +59,7 @@ namespace embree
       {
         progressMonitor(0);
         pinfo = parallel_prefix_sum( pstate, size_t(0), geometry->size(), size_t(1024), PrimInfo(empty), [&](const range<size_t>& r, const PrimInfo& base) -> PrimInfo {
-          return geometry->createPrimRefArray(prims,r,base.size());
+          return prefetchBlocks(geometry,r,base.size(),[&] (const range<size_t>& rb, size_t kb) { return geometry->createPrimRefArray(prims,rb,kb); });
         }, [](const PrimInfo& a, const PrimInfo& b) -> PrimInfo { return PrimInfo::merge(a,b); });
       }
       return pinfo;
@@ -53,7 +74,7 @@ namespace embree
       progressMonitor(0);
       pstate.init(iter,size_t(1024));
       PrimInfo pinfo = parallel_for_for_prefix_sum0( pstate, iter, PrimInfo(empty), [&](Geometry* mesh, const range<size_t>& r, size_t k) -> PrimInfo {
-          return mesh->createPrimRefArray(prims,r,k);
+          return prefetchBlocks(mesh,r,k,[&] (const range<size_t>& rb, size_t kb) { return mesh->createPrimRefArray(prims,rb,kb); });
         }, [](const PrimInfo& a, const PrimInfo& b) -> PrimInfo { return PrimInfo::merge(a,b); });
       
       /* if we need to filter out geometry, run again */
@@ -61,12 +82,139 @@ namespace embree
       {
         progressMonitor(0);
         pinfo = parallel_for_for_prefix_sum1( pstate, iter, PrimInfo(empty), [&](Geometry* mesh, const range<size_t>& r, size_t k, const PrimInfo& base) -> PrimInfo {
-            return mesh->createPrimRefArray(prims,r,base.size());
+            return prefetchBlocks(mesh,r,base.size(),[&] (const range<size_t>& rb, size_t kb) { return mesh->createPrimRefArray(prims,rb,kb); });
           }, [](const PrimInfo& a, const PrimInfo& b) -> PrimInfo { return PrimInfo::merge(a,b); });
       }
       return pinfo;
     }
 
+    /* generates the primitive references of range r in small blocks and passes each valid one to func */
+    template<typename Func>
+    static __forceinline void streamPrimRefs(Geometry* mesh, const range<size_t>& r, const Func& func)
+    {
+      const size_t blockSize = 1024;
+      mvector<PrimRef> block(mesh->device,min(blockSize,r.size()));
+      for (size_t i=r.begin(); i<r.end(); i+=blockSize)
+      {
+        const range<size_t> rb(i,min(i+blockSize,r.end()));
+        if (rb.end() < r.end()) mesh->prefetchPrimRefs(range<size_t>(rb.end(),min(rb.end()+blockSize,r.end())));
+        const size_t n = mesh->createPrimRefArray(block,rb,0).size();
+        for (size_t j=0; j<n; j++) func(block[j]);
+      }
+    }
+
+    PrimInfo createPrimRefSlabs(Scene* scene, Geometry::GTypeMask types, bool mblur, const PrimRefChunk& parent, PrimRefSlabs& slabs, BuildProgressMonitor& progressMonitor)
+    {
+      Scene::Iterator2 iter(scene,types,mblur);
+
+      /* first pass computes the centroid bounds */
+      progressMonitor(0);
+      const PrimInfo pinfo = parallel_for_for_reduce( iter, size_t(1024), PrimInfo(empty), [&](Geometry* mesh, const range<size_t>& r, size_t k) -> PrimInfo {
+          PrimInfo pinfo(empty);
+          streamPrimRefs(mesh,r,[&] (const PrimRef& prim) {
+              if (parent.inside(prim)) pinfo.add_center2(prim);
+            });
+          return pinfo;
+        }, [](const PrimInfo& a, const PrimInfo& b) -> PrimInfo { return PrimInfo::merge(a,b); });
+
+      /* second pass counts the primitives per slab */
+      progressMonitor(0);
+      slabs.init(pinfo.centBounds);
+      slabs.counts = parallel_for_for_reduce( iter, size_t(1024), std::vector<size_t>(PrimRefSlabs::NUM_SLABS,0), [&](Geometry* mesh, const range<size_t>& r, size_t k) -> std::vector<size_t> {
+          std::vector<size_t> counts(PrimRefSlabs::NUM_SLABS,0);
+          streamPrimRefs(mesh,r,[&] (const PrimRef& prim) {
+              if (parent.inside(prim)) counts[slabs.slab(prim)]++;
+            });
+          return counts;
+        }, [](const std::vector<size_t>& a, const std::vector<size_t>& b) -> std::vector<size_t> {
+          std::vector<size_t> c(PrimRefSlabs::NUM_SLABS);
+          for (size_t i=0; i<c.size(); i++) c[i] = a[i]+b[i];
+          return c;
+        });
+      return pinfo;
+    }
+
+    PrimInfo createPrimRefArray(Scene* scene, Geometry::GTypeMask types, bool mblur, mvector<PrimRef>& prims, const PrimRefChunk& chunk, BuildProgressMonitor& progressMonitor)
+    {
+      ParallelForForPrefixSumState<PrimInfo> pstate;
+      Scene::Iterator2 iter(scene,types,mblur);
+
+      /* first pass counts the primitives of each task that fall into the slab ranges */
+      progressMonitor(0);
+      pstate.init(iter,size_t(1024));
+      parallel_for_for_prefix_sum0( pstate, iter, PrimInfo(empty), [&](Geometry* mesh, const range<size_t>& r, size_t k) -> PrimInfo {
+          PrimInfo pinfo(empty);
+          streamPrimRefs(mesh,r,[&] (const PrimRef& prim) {
+              if (chunk.inside(prim)) pinfo.add_center2(prim);
+            });
+          return pinfo;
+        }, [](const PrimInfo& a, const PrimInfo& b) -> PrimInfo { return PrimInfo::merge(a,b); });
+
+      /* second pass writes the ones inside the rank range to their final location */
+      progressMonitor(0);
+      return parallel_for_for_prefix_sum1( pstate, iter, PrimInfo(empty), [&](Geometry* mesh, const range<size_t>& r, size_t k, const PrimInfo& base) -> PrimInfo {
+          PrimInfo pinfo(empty);
+          size_t rank = base.size();
+          streamPrimRefs(mesh,r,[&] (const PrimRef& prim) {
+              if (!chunk.inside(prim)) return;
+              if (rank >= chunk.ranks.begin() && rank < chunk.ranks.end()) {
+                pinfo.add_center2(prim);
+                prims[rank-chunk.ranks.begin()] = prim;
+              }
+              rank++;
+            });
+          return pinfo;
+        }, [](const PrimInfo& a, const PrimInfo& b) -> PrimInfo { return PrimInfo::merge(a,b); });
+    }
+
+    void createPrimRefIDs(Scene* scene, Geometry::GTypeMask types, bool mblur, const PrimRefChunkTree& tree, const std::vector<size_t>& offsets, mvector<PrimRefID>& ids, BuildProgressMonitor& progressMonitor)
+    {
+      typedef std::vector<size_t> Counts;
+      ParallelForForPrefixSumState<Counts> pstate;
+      Scene::Iterator2 iter(scene,types,mblur);
+      const Counts identity(offsets.size(),0);
+      auto add = [](const Counts& a, const Counts& b) -> Counts {
+        Counts c(a.size());
+        for (size_t i=0; i<c.size(); i++) c[i] = a[i]+b[i];
+        return c;
+      };
+
+      /* first pass counts the primitives of each task per group */
+      progressMonitor(0);
+      pstate.init(iter,size_t(1024));
+      parallel_for_for_prefix_sum0( pstate, iter, identity, [&](Geometry* mesh, const range<size_t>& r, size_t k) -> Counts {
+          Counts counts(identity);
+          streamPrimRefs(mesh,r,[&] (const PrimRef& prim) { counts[tree.group(prim)]++; });
+          return counts;
+        }, add);
+
+      /* second pass writes the IDs behind the ones of all previous tasks in each group */
+      progressMonitor(0);
+      parallel_for_for_prefix_sum1( pstate, iter, identity, [&](Geometry* mesh, const range<size_t>& r, size_t k, const Counts& base) -> Counts {
+          Counts counts(identity);
+          streamPrimRefs(mesh,r,[&] (const PrimRef& prim) {
+              const size_t group = tree.group(prim);
+              PrimRefID& id = ids[offsets[group]+base[group]+counts[group]++];
+              id.geomID = prim.geomID();
+              id.primID = prim.primID();
+            });
+          return counts;
+        }, add);
+    }
+
+    PrimInfo createPrimRefArray(Scene* scene, const PrimRefID* ids, const size_t numIDs, mvector<PrimRef>& prims, BuildProgressMonitor& progressMonitor)
+    {
+      progressMonitor(0);
+      return parallel_reduce( size_t(0), numIDs, size_t(1024), PrimInfo(empty), [&](const range<size_t>& r) -> PrimInfo {
+          PrimInfo pinfo(empty);
+          for (size_t i=r.begin(); i<r.end(); i++) {
+            const Geometry* mesh = scene->get(ids[i].geomID);
+            pinfo.merge(mesh->createPrimRefArray(prims,range<size_t>(ids[i].primID,ids[i].primID+1),i));
+          }
+          return pinfo;
+        }, [](const PrimInfo& a, const PrimInfo& b) -> PrimInfo { return PrimInfo::merge(a,b); });
+    }
+
     PrimInfo createPrimRefArrayMBlur(Scene* scene, Geometry::GTypeMask types, mvector<PrimRef>& prims, BuildProgressMonitor& progressMonitor, size_t itime)
     {
       ParallelForForPrefixSumState<PrimInfo> pstate;
@@ -76,7 +224,7 @@ namespace embree
       progressMonitor(0);
       pstate.init(iter,size_t(1024));
       PrimInfo pinfo = parallel_for_for_prefix_sum0( pstate, iter, PrimInfo(empty), [&](Geometry* mesh, const range<size_t>& r, size_t k) -> PrimInfo {
-          return mesh->createPrimRefArrayMB(prims,itime,r,k);
+          return prefetchBlocks(mesh,r,k,[&] (const range<size_t>& rb, size_t kb) { return mesh->createPrimRefArrayMB(prims,itime,rb,kb); });
         }, [](const PrimInfo& a, const PrimInfo& b) -> PrimInfo { return PrimInfo::merge(a,b); });
       
       /* if we need to filter out geometry, run again */
@@ -84,7 +232,7 @@ namespace embree
       {
         progressMonitor(0);
         pinfo = parallel_for_for_prefix_sum1( pstate, iter, PrimInfo(empty), [&](Geometry* mesh, const range<size_t>& r, size_t k, const PrimInfo& base) -> PrimInfo {
-            return mesh->createPrimRefArrayMB(prims,itime,r,base.size());
+            return prefetchBlocks(mesh,r,base.size(),[&] (const range<size_t>& rb, size_t kb) { return mesh->createPrimRefArrayMB(prims,itime,rb,kb); });
           }, [](const PrimInfo& a, const PrimInfo& b) -> PrimInfo { return PrimInfo::merge(a,b); });
       }
       return pinfo;
@@ -121,73 +269,45 @@ namespace embree
     {
       size_t numPrimitives = morton.size();
 
-      /* compute scene bounds */
-      std::pair<size_t,BBox3fa> cb_empty(0,empty);
-      auto cb = parallel_reduce 
-        ( size_t(0), numPrimitives, size_t(1024), cb_empty, [&](const range<size_t>& r) -> std::pair<size_t,BBox3fa>
+      /* compute the centroid bounds and the number of valid primitives of each task */
+      typedef std::pair<size_t,BBox3fa> CentroidInfo;
+      const auto merge2 = [] (const CentroidInfo& a, const CentroidInfo& b) -> CentroidInfo {
+        return CentroidInfo(a.first+b.first,merge(a.second,b.second));
+      };
+      ParallelPrefixSumState<CentroidInfo> pstate;
+      const CentroidInfo cb = parallel_prefix_sum( pstate, size_t(0), numPrimitives, size_t(1024), CentroidInfo(0,empty), [&](const range<size_t>& r, const CentroidInfo& base) -> CentroidInfo
+        {
+          size_t num = 0;
+          BBox3fa bounds = empty;
+          for (size_t j=r.begin(); j<r.end(); j++)
+          {
+            BBox3fa prim_bounds = empty;
+            if (unlikely(!mesh->buildBounds(j,&prim_bounds))) continue;
+            bounds.extend(center2(prim_bounds));
+            num++;
+          }
+          return CentroidInfo(num,bounds);
+        }, merge2);
+
+      /* compute morton codes, the counts of the first pass place the
+       * codes of each task such that invalid primitives get compacted
+       * without an additional pass */
+      BVHBuilderMorton::MortonCodeMapping mapping(cb.second);
+      parallel_prefix_sum( pstate, size_t(0), numPrimitives, size_t(1024), CentroidInfo(0,empty), [&](const range<size_t>& r, const CentroidInfo& base) -> CentroidInfo
+        {
+          size_t num = 0;
+          BVHBuilderMorton::MortonCodeGenerator generator(mapping,&morton.data()[base.first]);
+          for (size_t j=r.begin(); j<r.end(); j++)
           {
-            size_t num = 0;
             BBox3fa bounds = empty;
-            
-            for (size_t j=r.begin(); j<r.end(); j++)
-            {
-              BBox3fa prim_bounds = empty;
-              if (unlikely(!mesh->buildBounds(j,&prim_bounds))) continue;
-              bounds.extend(center2(prim_bounds));
-              num++;
-            }
-            return std::make_pair(num,bounds);
-          }, [] (const std::pair<size_t,BBox3fa>& a, const std::pair<size_t,BBox3fa>& b) {
-          return std::make_pair(a.first + b.first,merge(a.second,b.second)); 
-        });
-      
-      
-      size_t numPrimitivesGen = cb.first;
-      const BBox3fa centBounds = cb.second;
-      
-      /* compute morton codes */
-      if (likely(numPrimitivesGen == numPrimitives))
-      {
-        /* fast path if all primitives were valid */
-        BVHBuilderMorton::MortonCodeMapping mapping(centBounds);
-        parallel_for( size_t(0), numPrimitives, size_t(1024), [&](const range<size_t>& r) -> void {
-            BVHBuilderMorton::MortonCodeGenerator generator(mapping,&morton.data()[r.begin()]);
-            for (size_t j=r.begin(); j<r.end(); j++)
-              generator(mesh->bounds(j),unsigned(j));
-          });
-      }
-      else
-      {
-        /* slow path, fallback in case some primitives were invalid */
-        ParallelPrefixSumState<size_t> pstate;
-        BVHBuilderMorton::MortonCodeMapping mapping(centBounds);
-        parallel_prefix_sum( pstate, size_t(0), numPrimitives, size_t(1024), size_t(0), [&](const range<size_t>& r, const size_t base) -> size_t {
-            size_t num = 0;
-            BVHBuilderMorton::MortonCodeGenerator generator(mapping,&morton.data()[r.begin()]);
-            for (size_t j=r.begin(); j<r.end(); j++)
-            {
-              BBox3fa bounds = empty;
-              if (unlikely(!mesh->buildBounds(j,&bounds))) continue;
-              generator(bounds,unsigned(j));
-              num++;
-            }
-            return num;
-          }, std::plus<size_t>());
-        
-        parallel_prefix_sum( pstate, size_t(0), numPrimitives, size_t(1024), size_t(0), [&](const range<size_t>& r, const size_t base) -> size_t {
-            size_t num = 0;
-            BVHBuilderMorton::MortonCodeGenerator generator(mapping,&morton.data()[base]);
-            for (size_t j=r.begin(); j<r.end(); j++)
-            {
-              BBox3fa bounds = empty;
-              if (!mesh->buildBounds(j,&bounds)) continue;
-              generator(bounds,unsigned(j));
-              num++;
-            }
-            return num;
-          }, std::plus<size_t>());          
-      }
-      return numPrimitivesGen;
+            if (unlikely(!mesh->buildBounds(j,&bounds))) continue;
+            generator(bounds,unsigned(j));
+            num++;
+          }
+          return CentroidInfo(num,empty);
+        }, merge2);
+
+      return cb.first;
     }
 
     // ====================================================================================================
@@ -30,6 +30,128 @@ namespace embree
    
     PrimInfo createPrimRefArray(Scene* scene, Geometry::GTypeMask types, bool mblur, mvector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
    
+    /*! maps primitive centroids to slabs along the largest axis of the centroid bounds, used to stream the primitives of a scene in chunks */
+    struct PrimRefSlabMapping
+    {
+      enum { NUM_SLABS = 1024 };
+
+      __forceinline PrimRefSlabMapping ()
+        : dim(0), ofs(0.0f), scale(0.0f) {}
+
+      /*! a scale of zero maps all primitives to the first slab, which happens if the centroid bounds are (nearly) degenerate */
+      __forceinline void init(const BBox3fa& centBounds)
+      {
+        const Vec3fa diag = centBounds.size();
+        dim = maxDim(diag);
+        ofs = centBounds.lower[dim];
+        scale = diag[dim] > 1E-30f ? float(NUM_SLABS)*0.99f/diag[dim] : 0.0f;
+      }
+
+      __forceinline size_t slab(const PrimRef& prim) const {
+        return min(size_t(max(0.0f,(prim.center2()[dim]-ofs)*scale)),size_t(NUM_SLABS-1));
+      }
+
+    public:
+      int dim;
+      float ofs, scale;
+    };
+
+    /*! slab mapping together with the number of primitives per slab */
+    struct PrimRefSlabs : public PrimRefSlabMapping
+    {
+      __forceinline PrimRefSlabs ()
+        : counts(NUM_SLABS,0) {}
+
+    public:
+      std::vector<size_t> counts; //!< number of primitives per slab
+    };
+
+    /*! selects a chunk of the primitives of a scene, a primitive belongs
+     *  to the chunk if it falls into the slab range of each level, and if
+     *  its rank among these primitives in scene order is inside the rank
+     *  range, the latter is used to split primitives with equal centroids */
+    struct PrimRefChunk
+    {
+      struct Level
+      {
+        __forceinline Level (const PrimRefSlabMapping& mapping, const range<size_t>& slabs)
+          : mapping(mapping), slabs(slabs) {}
+
+        PrimRefSlabMapping mapping;
+        range<size_t> slabs;
+      };
+
+      __forceinline PrimRefChunk ()
+        : ranks(0,size_t(inf)) {}
+
+      __forceinline PrimRefChunk (const PrimRefChunk& parent, const PrimRefSlabMapping& mapping, const range<size_t>& slabs)
+        : levels(parent.levels), ranks(0,size_t(inf)) { levels.push_back(Level(mapping,slabs)); }
+
+      __forceinline PrimRefChunk (const PrimRefChunk& parent, const range<size_t>& ranks)
+        : levels(parent.levels), ranks(ranks) {}
+
+      /*! tests if the primitive falls into the slab ranges of all levels, the rank range is not tested */
+      __forceinline bool inside(const PrimRef& prim) const
+      {
+        for (const Level& level : levels) {
+          const size_t i = level.mapping.slab(prim);
+          if (i < level.slabs.begin() || i >= level.slabs.end()) return false;
+        }
+        return true;
+      }
+
+    public:
+      std::vector<Level> levels;
+      range<size_t> ranks;
+    };
+
+    /*! maps primitives to groups by recursively refined slab ranges, such
+     *  that all primitives can get binned into their group in one pass */
+    struct PrimRefChunkTree
+    {
+      struct Node
+      {
+        __forceinline Node ()
+          : group(-1) {}
+
+        PrimRefSlabMapping mapping;
+        std::vector<size_t> children; //!< child node of each slab of an inner node
+        int group;                    //!< group of a leaf node, -1 for inner nodes
+      };
+
+      __forceinline PrimRefChunkTree ()
+        : nodes(1) {}
+
+      __forceinline size_t group(const PrimRef& prim) const
+      {
+        const Node* node = &nodes[0];
+        while (node->group < 0) node = &nodes[node->children[node->mapping.slab(prim)]];
+        return size_t(node->group);
+      }
+
+    public:
+      std::vector<Node> nodes;
+    };
+
+    /*! identifies a primitive of the scene */
+    struct PrimRefID
+    {
+      unsigned int geomID;
+      unsigned int primID;
+    };
+
+    /*! computes the primitive info and the slab histogram of the primitives inside the parent chunk without storing any primitive references */
+    PrimInfo createPrimRefSlabs(Scene* scene, Geometry::GTypeMask types, bool mblur, const PrimRefChunk& parent, PrimRefSlabs& slabs, BuildProgressMonitor& progressMonitor);
+
+    /*! creates the primitive references of all primitives of the chunk, prims has to be large enough */
+    PrimInfo createPrimRefArray(Scene* scene, Geometry::GTypeMask types, bool mblur, mvector<PrimRef>& prims, const PrimRefChunk& chunk, BuildProgressMonitor& progressMonitor);
+
+    /*! stores the IDs of all primitives sorted by their group in the tree, starting at the offset of each group, the order inside a group is the scene order */
+    void createPrimRefIDs(Scene* scene, Geometry::GTypeMask types, bool mblur, const PrimRefChunkTree& tree, const std::vector<size_t>& offsets, mvector<PrimRefID>& ids, BuildProgressMonitor& progressMonitor);
+
+    /*! creates the primitive references of a range of primitive IDs, prims has to be large enough */
+    PrimInfo createPrimRefArray(Scene* scene, const PrimRefID* ids, const size_t numIDs, mvector<PrimRef>& prims, BuildProgressMonitor& progressMonitor);
+   
     PrimInfo createPrimRefArrayMBlur(Scene* scene, Geometry::GTypeMask types, mvector<PrimRef>& prims, BuildProgressMonitor& progressMonitor, size_t itime = 0);
 
     PrimInfoMB createPrimRefArrayMSMBlur(Scene* scene, Geometry::GTypeMask types, mvector<PrimRefMB>& prims, BuildProgressMonitor& progressMonitor, BBox1f t0t1 = BBox1f(0.0f,1.0f));
@@ -23,13 +23,18 @@ namespace embree
   BVHN<N>::BVHN (const PrimitiveType& primTy, Scene* scene)
     : AccelData((N==4) ? AccelData::TY_BVH4 : (N==8) ? AccelData::TY_BVH8 : AccelData::TY_UNKNOWN),
       primTy(&primTy), device(scene->device), scene(scene),
-      root(emptyNode), alloc(scene->device,scene->isStaticAccel()), numPrimitives(0), numVertices(0)
+      root(emptyNode), alloc(scene->device,scene->isStaticAccel()), numSockets(getNumberOfSockets()), numPrimitives(0), numVertices(0)
   {
+    if (device->numa_replication) {
+      replicaRoots.reset(new std::atomic<size_t>[numSockets]);
+      for (size_t i=0; i<numSockets; i++) replicaRoots[i] = 0;
+    }
   }
 
   template<int N>
   BVHN<N>::~BVHN ()
   {
+    clearReplicas();
     for (size_t i=0; i<objects.size(); i++) 
       delete objects[i];
   }
@@ -44,11 +49,101 @@ namespace embree
   template<int N>
   void BVHN<N>::set (NodeRef root, const LBBox3fa& bounds, size_t numPrimitives)
   {
+    clearReplicas();
     this->root = root;
     this->bounds = bounds;
     this->numPrimitives = numPrimitives;
   }	
 
+  /* querying the socket of the calling thread is a system call, as
+   * threads migrate rarely the socket is only queried again after a
+   * number of ray queries */
+  static const unsigned int THREAD_SOCKET_REFRESH_INTERVAL = 4096;
+  static __thread unsigned int thread_socket = 0;
+  static __thread unsigned int thread_socket_queries = 0;
+
+  static __forceinline size_t getCachedSocketOfCurrentThread()
+  {
+    if (unlikely(thread_socket_queries++ % THREAD_SOCKET_REFRESH_INTERVAL == 0))
+      thread_socket = getSocketOfCurrentThread();
+    return thread_socket;
+  }
+
+  template<int N>
+  typename BVHN<N>::NodeRef BVHN<N>::getReplicatedRoot() const
+  {
+    const size_t socket = min(getCachedSocketOfCurrentThread(),numSockets-1);
+    size_t ref = replicaRoots[socket].load();
+    if (likely(ref != 0)) return NodeRef(ref);
+
+    /* the first thread of each socket creates the copy, thus its first touch places the memory on that socket */
+    Lock<MutexSys> lock(replicaMutex);
+    ref = replicaRoots[socket].load();
+    if (ref == 0) {
+      ref = replicateTopLevels(replicaNodes);
+      replicaRoots[socket] = ref;
+    }
+    return NodeRef(ref);
+  }
+
+  template<int N>
+  typename BVHN<N>::NodeRef BVHN<N>::replicateTopLevels(std::vector<AlignedNode*>& memory) const
+  {
+    if (!root.isAlignedNode())
+      return root;
+
+    /* small BVHs get replicated fully, large ones only up to the levels that contain about 0.5% of the nodes */
+    const size_t maxNodes = numPrimitives <= 64*1024 ? size_t(inf) : max(size_t(64),size_t(numPrimitives*0.005f));
+
+    /* collect nodes level by level as long as the next level fits */
+    std::vector<NodeRef> nodes;
+    nodes.push_back(root);
+    size_t levelBegin = 0;
+    while (levelBegin < nodes.size())
+    {
+      size_t numChildren = 0;
+      for (size_t i=levelBegin; i<nodes.size(); i++)
+        for (size_t c=0; c<N; c++)
+          numChildren += nodes[i].alignedNode()->child(c).isAlignedNode();
+
+      if (nodes.size()+numChildren > maxNodes)
+        break;
+
+      const size_t levelEnd = nodes.size();
+      for (size_t i=levelBegin; i<levelEnd; i++)
+        for (size_t c=0; c<N; c++)
+          if (nodes[i].alignedNode()->child(c).isAlignedNode())
+            nodes.push_back(nodes[i].alignedNode()->child(c));
+      levelBegin = levelEnd;
+    }
+
+    /* copy nodes in the same order and link the copied children, nodes of the last level keep pointing to the original subtrees */
+    AlignedNode* copy = (AlignedNode*) alignedMalloc(nodes.size()*sizeof(AlignedNode),byteNodeAlignment);
+    memory.push_back(copy);
+    size_t next = 1;
+    for (size_t i=0; i<nodes.size(); i++)
+    {
+      copy[i] = *nodes[i].alignedNode();
+      if (i >= levelBegin) continue;
+      for (size_t c=0; c<N; c++)
+        if (copy[i].child(c).isAlignedNode())
+          copy[i].child(c) = encodeNode(&copy[next++]);
+    }
+    assert(levelBegin == nodes.size() || next == nodes.size());
+    return encodeNode(&copy[0]);
+  }
+
+  template<int N>
+  void BVHN<N>::clearReplicas()
+  {
+    if (!replicaRoots) return;
+    for (size_t i=0; i<numSockets; i++)
+      replicaRoots[i] = 0;
+    for (size_t i=0; i<replicaNodes.size(); i++)
+      alignedFree(replicaNodes[i]);
+    replicaNodes.clear();
+  }
+
   template<int N>
   void BVHN<N>::clearBarrier(NodeRef& node)
   {
@@ -190,6 +285,23 @@ namespace embree
       Lock<MutexSys> lock(g_printMutex);
       std::cout << "BENCHMARK_BUILD " << dt << " " << double(numPrimitives)/dt << " " << stat->sah() << " " << stat->bytesUsed() << " BVH" << N << "<" << primTy->name() << ">" << std::endl << std::flush;
     }
+
+    /* add memory statistics and SAH cost to the build report of the scene */
+    if (scene && scene->buildReport.enabled)
+    {
+      if (!stat) stat.reset(new BVHNStatistics<N>(this));
+      size_t bytesAllocated = alloc.getStatistics(FastAllocator::ANY_TYPE).bytesAllocatedTotal();
+      size_t bytesUsed = alloc.getUsedBytes();
+      size_t bytesWasted = alloc.getWastedBytes();
+      for (size_t i=0; i<objects.size(); i++)
+      {
+        if (!objects[i]) continue;
+        bytesAllocated += objects[i]->alloc.getStatistics(FastAllocator::ANY_TYPE).bytesAllocatedTotal();
+        bytesUsed += objects[i]->alloc.getUsedBytes();
+        bytesWasted += objects[i]->alloc.getWastedBytes();
+      }
+      scene->buildReport.addBVH(numPrimitives,stat->sah(),bytesAllocated,bytesUsed,bytesWasted);
+    }
   }
 
 #if defined(__AVX__)
@@ -1439,6 +1439,22 @@ namespace embree
     void layoutLargeNodes(size_t num);
     NodeRef layoutLargeNodesRecursion(NodeRef& node, const FastAllocator::CachedAllocator& allocator);
 
+    /*! returns the root node, or the copy local to the socket of the calling thread if NUMA replication is enabled */
+    __forceinline NodeRef getRoot() const
+    {
+      if (likely(!replicaRoots)) return root;
+      return getReplicatedRoot();
+    }
+
+    /*! returns the root of the socket local copy of the top levels of the BVH, creates the copy when missing */
+    NodeRef getReplicatedRoot() const;
+
+    /*! copies the top levels of the BVH */
+    NodeRef replicateTopLevels(std::vector<AlignedNode*>& memory) const;
+
+    /*! frees all socket local copies, has to get called whenever nodes of the BVH change */
+    void clearReplicas();
+
     /*! called by all builders before build starts */
     double preBuild(const std::string& builderName);
 
@@ -1529,6 +1545,13 @@ namespace embree
     NodeRef root;                      //!< root node
     FastAllocator alloc;               //!< allocator used to allocate nodes
 
+    /*! per socket copies of the top levels of the BVH */
+  private:
+    mutable MutexSys replicaMutex;
+    mutable std::unique_ptr<std::atomic<size_t>[]> replicaRoots; //!< root node of each socket, 0 if not yet replicated
+    mutable std::vector<AlignedNode*> replicaNodes;               //!< memory of all socket local copies
+    size_t numSockets;
+
     /*! statistics data */
   public:
     size_t numPrimitives;              //!< number of primitives the BVH is build over
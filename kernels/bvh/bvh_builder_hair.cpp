@@ -60,7 +60,11 @@ namespace embree
 
         /* create primref array */
         prims.resize(numPrimitives);
-        const PrimInfo pinfo = createPrimRefArray(scene,Geometry::MTY_CURVES,false,prims,scene->progressInterface);
+        PrimInfo pinfo(empty);
+        {
+          BuildReport::Timer timer(scene->buildReport,BuildReport::PRIMREFS);
+          pinfo = createPrimRefArray(scene,Geometry::MTY_CURVES,false,prims,scene->progressInterface);
+        }
 
         /* estimate acceleration structure size */
         const size_t node_bytes = pinfo.size()*sizeof(typename BVH::UnalignedNode)/(4*N);
@@ -83,6 +87,7 @@ namespace embree
           if (set.size() == 0)
             return BVH::emptyNode;
 
+          BuildReport::Timer timer(scene->buildReport,BuildReport::LEAVES);
           const unsigned int geomID0 = prims[set.begin()].geomID();
           if (scene->get(geomID0)->getTypeMask() & Geometry::MTY_POINTS)
             return PointPrimitive::createLeaf(bvh,prims,set,alloc);
@@ -101,15 +106,19 @@ namespace embree
           };
           
         /* build hierarchy */
-        typename BVH::NodeRef root = BVHBuilderHair::build<NodeRef>
-          (typename BVH::CreateAlloc(bvh),
-           typename BVH::AlignedNode::Create(),
-           typename BVH::AlignedNode::Set(),
-           typename BVH::UnalignedNode::Create(),
-           typename BVH::UnalignedNode::Set(),
-           createLeaf,scene->progressInterface,
-           reportFinishedRange,
-           scene,prims.data(),pinfo,settings);
+        NodeRef root;
+        {
+          BuildReport::Timer timer(scene->buildReport,BuildReport::HIERARCHY);
+          root = BVHBuilderHair::build<NodeRef>
+            (typename BVH::CreateAlloc(bvh),
+             typename BVH::AlignedNode::Create(),
+             typename BVH::AlignedNode::Set(),
+             typename BVH::UnalignedNode::Create(),
+             typename BVH::UnalignedNode::Set(),
+             createLeaf,scene->progressInterface,
+             reportFinishedRange,
+             scene,prims.data(),pinfo,settings);
+        }
         
         bvh->set(root,LBBox3fa(pinfo.geomBounds),pinfo.size());
         
@@ -51,6 +51,7 @@ namespace embree
 
       __forceinline NodeRef operator() (const PrimRef* prims, const range<size_t>& set, const FastAllocator::CachedAllocator& alloc) const
       {
+        BuildReport::Timer timer(bvh->scene->buildReport,BuildReport::LEAVES);
         size_t n = set.size();
         size_t items = Primitive::blocks(n);
         size_t start = set.begin();
@@ -76,6 +77,7 @@ namespace embree
 
       __forceinline NodeRef operator() (const PrimRef* prims, const range<size_t>& set, const FastAllocator::CachedAllocator& alloc) const
       {
+        BuildReport::Timer timer(bvh->scene->buildReport,BuildReport::LEAVES);
         size_t n = set.size();
         size_t items = Primitive::blocks(n);
         size_t start = set.begin();
@@ -106,15 +108,26 @@ namespace embree
       Mesh* mesh;
       mvector<PrimRef> prims;
       GeneralBVHBuilder::Settings settings;
+      const size_t maxLeafSize;
       bool primrefarrayalloc;
 
       BVHNBuilderSAH (BVH* bvh, Scene* scene, const size_t sahBlockSize, const float intCost, const size_t minLeafSize, const size_t maxLeafSize,
                       const size_t mode, bool primrefarrayalloc = false)
         : bvh(bvh), scene(scene), mesh(nullptr), prims(scene->device,0),
-          settings(sahBlockSize, minLeafSize, min(maxLeafSize,Primitive::max_size()*BVH::maxLeafBlocks), travCost, intCost, DEFAULT_SINGLE_THREAD_THRESHOLD), primrefarrayalloc(primrefarrayalloc) {}
+          settings(sahBlockSize, minLeafSize, min(maxLeafSize,Primitive::max_size()*BVH::maxLeafBlocks), travCost, intCost, DEFAULT_SINGLE_THREAD_THRESHOLD),
+          maxLeafSize(settings.maxLeafSize), primrefarrayalloc(primrefarrayalloc) {}
 
       BVHNBuilderSAH (BVH* bvh, Mesh* mesh, const size_t sahBlockSize, const float intCost, const size_t minLeafSize, const size_t maxLeafSize, const size_t mode)
-        : bvh(bvh), scene(nullptr), mesh(mesh), prims(bvh->device,0), settings(sahBlockSize, minLeafSize, min(maxLeafSize,Primitive::max_size()*BVH::maxLeafBlocks), travCost, intCost, DEFAULT_SINGLE_THREAD_THRESHOLD), primrefarrayalloc(false) {}
+        : bvh(bvh), scene(nullptr), mesh(mesh), prims(bvh->device,0), settings(sahBlockSize, minLeafSize, min(maxLeafSize,Primitive::max_size()*BVH::maxLeafBlocks), travCost, intCost, DEFAULT_SINGLE_THREAD_THRESHOLD),
+          maxLeafSize(settings.maxLeafSize), primrefarrayalloc(false) {}
+
+      /* batched user geometry callbacks amortize the invocation over all primitives of a leaf, thus allow N primitives per leaf */
+      size_t getMaxLeafSize() const
+      {
+        if (scene && std::is_same<Mesh,UserGeometry>::value && scene->hasBatchedUserGeometry<false>())
+          return max(maxLeafSize,min(size_t(N),Primitive::max_size()*BVH::maxLeafBlocks));
+        return maxLeafSize;
+      }
 
       // FIXME: shrink bvh->alloc in destructor here and in other builders too
 
@@ -139,6 +152,9 @@ namespace embree
 
         double t0 = bvh->preBuild(mesh ? "" : TOSTRING(isa) "::BVH" + toString(N) + "BuilderSAH");
 
+        /* evaluated for each build as the batched callbacks can get set after the builder got created */
+        settings.maxLeafSize = getMaxLeafSize();
+
 #if PROFILE
         profile(2,PROFILE_RUNS,numPrimitives,[&] (ProfileTimer& timer) {
 #endif
@@ -159,11 +175,23 @@ namespace embree
             const size_t leaf_bytes = size_t(1.2*Primitive::blocks(numPrimitives)*sizeof(Primitive));
             bvh->alloc.init_estimate(node_bytes+leaf_bytes);
             settings.singleThreadThreshold = bvh->alloc.fixSingleThreadThreshold(N,DEFAULT_SINGLE_THREAD_THRESHOLD,numPrimitives,node_bytes+leaf_bytes);
+
+            /* stream the primitives chunk by chunk if the primref array would exceed the memory budget */
+            const size_t budget = scene ? scene->device->build_memory_budget : 0;
+            if (budget && numPrimitives*sizeof(PrimRef) > budget) {
+              settings.primrefarrayalloc = inf; // the primref array gets reused for each chunk thus cannot hold any leaves
+              return buildChunked(budget,t0);
+            }
+
             prims.resize(numPrimitives); 
 
-            PrimInfo pinfo = mesh ?
-              createPrimRefArray(mesh,prims,bvh->scene->progressInterface) :
-              createPrimRefArray(scene,Mesh::geom_type,false,prims,bvh->scene->progressInterface);
+            PrimInfo pinfo(empty);
+            {
+              BuildReport::Timer timer(bvh->scene->buildReport,BuildReport::PRIMREFS);
+              pinfo = mesh ?
+                createPrimRefArray(mesh,prims,bvh->scene->progressInterface) :
+                createPrimRefArray(scene,Mesh::geom_type,false,prims,bvh->scene->progressInterface);
+            }
 
             /* pinfo might has zero size due to invalid geometry */
             if (unlikely(pinfo.size() == 0))
@@ -174,7 +202,11 @@ namespace embree
             }
 
             /* call BVH builder */
-            NodeRef root = BVHNBuilderVirtual<N>::build(&bvh->alloc,CreateLeaf<N,Primitive>(bvh),bvh->scene->progressInterface,prims.data(),pinfo,settings);
+            NodeRef root;
+            {
+              BuildReport::Timer timer(bvh->scene->buildReport,BuildReport::HIERARCHY);
+              root = BVHNBuilderVirtual<N>::build(&bvh->alloc,CreateLeaf<N,Primitive>(bvh),bvh->scene->progressInterface,prims.data(),pinfo,settings);
+            }
             bvh->set(root,LBBox3fa(pinfo.geomBounds),pinfo.size());
             bvh->layoutLargeNodes(size_t(pinfo.size()*0.005f));
 
@@ -195,6 +227,160 @@ namespace embree
         bvh->postBuild(t0);
       }
 
+      /* splits the primitives of the parent chunk into groups of at
+       * most maxChunkSize primitives by grouping neighbouring slabs,
+       * slabs that are too large get split recursively, and primitives
+       * that cannot be separated spatially stay in one group that later
+       * gets split by the order of the primitives */
+      void splitChunk(const PrimRefChunk& parent, const PrimRefSlabs& slabs, const size_t numPrims, const size_t maxChunkSize,
+                      const size_t nodeID, PrimRefChunkTree& tree, std::vector<PrimRefChunk>& groups, std::vector<size_t>& groupSizes)
+      {
+        const size_t maxSlabPrims = *std::max_element(slabs.counts.begin(),slabs.counts.end());
+        if (slabs.scale == 0.0f || maxSlabPrims == numPrims)
+        {
+          tree.nodes[nodeID].group = int(groups.size());
+          groups.push_back(parent);
+          groupSizes.push_back(numPrims);
+          return;
+        }
+
+        tree.nodes[nodeID].mapping = slabs;
+        tree.nodes[nodeID].children.resize(PrimRefSlabs::NUM_SLABS);
+        for (size_t i=0; i<PrimRefSlabs::NUM_SLABS; )
+        {
+          size_t j = i, n = 0;
+          while (j<PrimRefSlabs::NUM_SLABS && (n == 0 || n+slabs.counts[j] <= maxChunkSize))
+            n += slabs.counts[j++];
+
+          const size_t childID = tree.nodes.size();
+          tree.nodes.push_back(PrimRefChunkTree::Node());
+          for (size_t k=i; k<j; k++)
+            tree.nodes[nodeID].children[k] = childID;
+
+          const PrimRefChunk chunk(parent,slabs,range<size_t>(i,j));
+          if (n > maxChunkSize)
+          {
+            PrimRefSlabs subslabs;
+            {
+              BuildReport::Timer timer(bvh->scene->buildReport,BuildReport::PRIMREFS);
+              createPrimRefSlabs(scene,Mesh::geom_type,false,chunk,subslabs,bvh->scene->progressInterface);
+            }
+            splitChunk(chunk,subslabs,n,maxChunkSize,childID,tree,groups,groupSizes);
+          }
+          else
+          {
+            tree.nodes[childID].group = int(groups.size());
+            groups.push_back(chunk);
+            groupSizes.push_back(n);
+          }
+          i = j;
+        }
+      }
+
+      /* builds one sub-BVH for each chunk of primitives, such that the
+       * primref array never exceeds the memory budget, and stitches the
+       * chunks together with a top-level build */
+      void buildChunked(const size_t budget, double t0)
+      {
+        PrimRefSlabs slabs;
+        PrimInfo pinfo(empty);
+        {
+          BuildReport::Timer timer(bvh->scene->buildReport,BuildReport::PRIMREFS);
+          pinfo = createPrimRefSlabs(scene,Mesh::geom_type,false,PrimRefChunk(),slabs,bvh->scene->progressInterface);
+        }
+        if (unlikely(pinfo.size() == 0))
+        {
+          bvh->clear();
+          prims.clear();
+          return;
+        }
+
+        /* the primitive IDs sorted by group take a part of the budget, if
+         * they would take more than half of it, each chunk gets streamed
+         * from the scene separately instead */
+        const size_t idBytes = pinfo.size()*sizeof(PrimRefID);
+        const bool sortIDs = 2*idBytes <= budget;
+        const size_t maxChunkSize = max(size_t(1),(sortIDs ? budget-idBytes : budget)/sizeof(PrimRef));
+        PrimRefChunkTree tree;
+        std::vector<PrimRefChunk> groups;
+        std::vector<size_t> groupSizes;
+        splitChunk(PrimRefChunk(),slabs,pinfo.size(),maxChunkSize,0,tree,groups,groupSizes);
+
+        /* bin all primitive IDs into their groups in a single pass over the scene */
+        std::vector<size_t> groupOffsets(groups.size());
+        for (size_t g=0, offset=0; g<groups.size(); offset+=groupSizes[g++])
+          groupOffsets[g] = offset;
+        mvector<PrimRefID> ids(scene->device,sortIDs ? pinfo.size() : 0);
+        if (sortIDs)
+        {
+          BuildReport::Timer timer(bvh->scene->buildReport,BuildReport::PRIMREFS);
+          createPrimRefIDs(scene,Mesh::geom_type,false,tree,groupOffsets,ids,bvh->scene->progressInterface);
+        }
+
+        /* build a sub-BVH for each chunk of at most maxChunkSize primitives of a group, all chunks share the same primref array */
+        size_t numChunks = 0;
+        for (size_t g=0; g<groups.size(); g++)
+          numChunks += (groupSizes[g]+maxChunkSize-1)/maxChunkSize;
+        prims.resize(min(pinfo.size(),maxChunkSize));
+        mvector<PrimRef> refs(scene->device,numChunks);
+        PrimInfo tinfo(empty);
+        for (size_t g=0, c=0; g<groups.size(); g++)
+        {
+          for (size_t i=0; i<groupSizes[g]; i+=maxChunkSize)
+          {
+            const range<size_t> ranks(i,min(i+maxChunkSize,groupSizes[g]));
+            PrimInfo cinfo(empty);
+            {
+              BuildReport::Timer timer(bvh->scene->buildReport,BuildReport::PRIMREFS);
+              cinfo = sortIDs ?
+                createPrimRefArray(scene,ids.data()+groupOffsets[g]+ranks.begin(),ranks.size(),prims,bvh->scene->progressInterface) :
+                createPrimRefArray(scene,Mesh::geom_type,false,prims,PrimRefChunk(groups[g],ranks),bvh->scene->progressInterface);
+            }
+            BuildReport::Timer timer(bvh->scene->buildReport,BuildReport::HIERARCHY);
+            const NodeRef root = BVHNBuilderVirtual<N>::build(&bvh->alloc,CreateLeaf<N,Primitive>(bvh),bvh->scene->progressInterface,prims.data(),cinfo,settings);
+            refs[c] = PrimRef(cinfo.geomBounds,(size_t)root);
+            tinfo.add_center2(refs[c++]);
+          }
+        }
+        ids.clear();
+
+        /* stitch the chunks together */
+        NodeRef root = (NodeRef) refs[0].ID();
+        if (refs.size() > 1)
+        {
+          BuildReport::Timer timer(bvh->scene->buildReport,BuildReport::HIERARCHY);
+          GeneralBVHBuilder::Settings tsettings;
+          tsettings.branchingFactor = N;
+          tsettings.maxDepth = BVH::maxBuildDepthLeaf;
+          tsettings.logBlockSize = bsr(N);
+          tsettings.minLeafSize = 1;
+          tsettings.maxLeafSize = 1;
+          tsettings.travCost = 1.0f;
+          tsettings.intCost = 1.0f;
+          tsettings.singleThreadThreshold = settings.singleThreadThreshold;
+
+          root = BVHBuilderBinnedSAH::build<NodeRef>(
+            typename BVH::CreateAlloc(bvh),
+            typename BVH::AlignedNode::Create2(),
+            typename BVH::AlignedNode::Set2(),
+            [&] (const PrimRef* refs, const range<size_t>& range, const FastAllocator::CachedAllocator& alloc) -> NodeRef {
+              assert(range.size() == 1);
+              return (NodeRef) refs[range.begin()].ID();
+            },
+            [&] (size_t dn) { bvh->scene->progressMonitor(0); },
+            refs.data(),tinfo,tsettings);
+        }
+        bvh->set(root,LBBox3fa(pinfo.geomBounds),pinfo.size());
+        bvh->layoutLargeNodes(size_t(pinfo.size()*0.005f));
+
+        if (scene->isStaticAccel()) {
+          bvh->shrink();
+          prims.clear();
+        }
+        bvh->cleanup();
+        bvh->postBuild(t0);
+      }
+
       void clear() {
         prims.clear();
       }
@@ -247,9 +433,13 @@ namespace embree
 #endif
             /* create primref array */
             prims.resize(numPrimitives);
-            PrimInfo pinfo = mesh ?
-              createPrimRefArray(mesh,prims,bvh->scene->progressInterface) :
-              createPrimRefArray(scene,Mesh::geom_type,false,prims,bvh->scene->progressInterface);
+            PrimInfo pinfo(empty);
+            {
+              BuildReport::Timer timer(bvh->scene->buildReport,BuildReport::PRIMREFS);
+              pinfo = mesh ?
+                createPrimRefArray(mesh,prims,bvh->scene->progressInterface) :
+                createPrimRefArray(scene,Mesh::geom_type,false,prims,bvh->scene->progressInterface);
+            }
 
             /* enable os_malloc for two level build */
             if (mesh)
@@ -260,7 +450,11 @@ namespace embree
             const size_t leaf_bytes = size_t(1.2*Primitive::blocks(numPrimitives)*sizeof(Primitive));
             bvh->alloc.init_estimate(node_bytes+leaf_bytes);
             settings.singleThreadThreshold = bvh->alloc.fixSingleThreadThreshold(N,DEFAULT_SINGLE_THREAD_THRESHOLD,numPrimitives,node_bytes+leaf_bytes);
-            NodeRef root = BVHNBuilderQuantizedVirtual<N>::build(&bvh->alloc,CreateLeafQuantized<N,Primitive>(bvh),bvh->scene->progressInterface,prims.data(),pinfo,settings);
+            NodeRef root;
+            {
+              BuildReport::Timer timer(bvh->scene->buildReport,BuildReport::HIERARCHY);
+              root = BVHNBuilderQuantizedVirtual<N>::build(&bvh->alloc,CreateLeafQuantized<N,Primitive>(bvh),bvh->scene->progressInterface,prims.data(),pinfo,settings);
+            }
             bvh->set(root,LBBox3fa(pinfo.geomBounds),pinfo.size());
             //bvh->layoutLargeNodes(pinfo.size()*0.005f); // FIXME: COPY LAYOUT FOR LARGE NODES !!!
 #if PROFILE
@@ -297,6 +491,7 @@ namespace embree
 
       __forceinline NodeRef operator() (const PrimRef* prims, const range<size_t>& set, const FastAllocator::CachedAllocator& alloc) const
       {
+        BuildReport::Timer timer(bvh->scene->buildReport,BuildReport::LEAVES);
         const size_t items = set.size(); //Primitive::blocks(n);
         const size_t start = set.begin();
 
@@ -385,6 +580,8 @@ namespace embree
 
         if (!mesh)
         {
+          BuildReport::Timer timer(bvh->scene->buildReport,BuildReport::PRIMREFS);
+
           /* first run to get #primitives */
 
           ParallelForForPrefixSumState<PrimInfo> pstate;
@@ -521,7 +718,11 @@ namespace embree
         }
 
         /* call BVH builder */
-        NodeRef root = BVHNBuilderVirtual<N>::build(&bvh->alloc,CreateLeafGrid<N,SubGridQBVHN<N>>(bvh,sgrids.data()),bvh->scene->progressInterface,prims.data(),pinfo,settings);
+        NodeRef root;
+        {
+          BuildReport::Timer timer(bvh->scene->buildReport,BuildReport::HIERARCHY);
+          root = BVHNBuilderVirtual<N>::build(&bvh->alloc,CreateLeafGrid<N,SubGridQBVHN<N>>(bvh,sgrids.data()),bvh->scene->progressInterface,prims.data(),pinfo,settings);
+        }
         bvh->set(root,LBBox3fa(pinfo.geomBounds),pinfo.size());
         bvh->layoutLargeNodes(size_t(pinfo.size()*0.005f));
 
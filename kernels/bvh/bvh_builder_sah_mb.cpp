@@ -86,6 +86,7 @@ namespace embree
 
       __forceinline const NodeRecordMB4D operator() (const BVHBuilderMSMBlur::BuildRecord& current, const FastAllocator::CachedAllocator& alloc) const
       {
+        BuildReport::Timer timer(bvh->scene->buildReport,BuildReport::LEAVES);
         size_t items = Primitive::blocks(current.prims.size());
         size_t start = current.prims.begin();
         size_t end   = current.prims.end();
@@ -120,6 +121,14 @@ namespace embree
       BVHNBuilderMBlurSAH (BVH* bvh, Scene* scene, const size_t sahBlockSize, const float intCost, const size_t minLeafSize, const size_t maxLeafSize)
         : bvh(bvh), scene(scene), sahBlockSize(sahBlockSize), intCost(intCost), minLeafSize(minLeafSize), maxLeafSize(min(maxLeafSize,Primitive::max_size()*BVH::maxLeafBlocks)) {}
 
+      /* batched user geometry callbacks amortize the invocation over all primitives of a leaf, thus allow N primitives per leaf */
+      size_t getMaxLeafSize() const
+      {
+        if (std::is_same<Mesh,UserGeometry>::value && scene->hasBatchedUserGeometry<true>())
+          return max(maxLeafSize,min(size_t(N),Primitive::max_size()*BVH::maxLeafBlocks));
+        return maxLeafSize;
+      }
+
       void build()
       {
 	/* skip build for empty scene */
@@ -169,7 +178,7 @@ namespace embree
         settings.maxDepth = BVH::maxBuildDepthLeaf;
         settings.logBlockSize = bsr(sahBlockSize);
         settings.minLeafSize = minLeafSize;
-        settings.maxLeafSize = maxLeafSize;
+        settings.maxLeafSize = getMaxLeafSize();
         settings.travCost = travCost;
         settings.intCost = intCost;
         settings.singleThreadThreshold = bvh->alloc.fixSingleThreadThreshold(N,DEFAULT_SINGLE_THREAD_THRESHOLD,pinfo.size(),node_bytes+leaf_bytes);
@@ -188,7 +197,11 @@ namespace embree
       {
         /* create primref array */
         mvector<PrimRefMB> prims(scene->device,numPrimitives);
-        PrimInfoMB pinfo = createPrimRefArrayMSMBlur(scene,Mesh::geom_type,prims,bvh->scene->progressInterface);
+        PrimInfoMB pinfo(empty);
+        {
+          BuildReport::Timer timer(scene->buildReport,BuildReport::PRIMREFS);
+          pinfo = createPrimRefArrayMSMBlur(scene,Mesh::geom_type,prims,bvh->scene->progressInterface);
+        }
 
         /* early out if no valid primitives */
         if (pinfo.size() == 0) { bvh->clear(); return; }
@@ -204,13 +217,15 @@ namespace embree
         settings.maxDepth = BVH::maxDepth;
         settings.logBlockSize = bsr(sahBlockSize);
         settings.minLeafSize = minLeafSize;
-        settings.maxLeafSize = maxLeafSize;
+        settings.maxLeafSize = getMaxLeafSize();
         settings.travCost = travCost;
         settings.intCost = intCost;
         settings.singleLeafTimeSegment = Primitive::singleTimeSegment;
+        settings.manyTimeSegments = scene->getBuildQuality() == RTC_BUILD_QUALITY_HIGH ? MBLUR_MANY_TIME_SEGMENTS : 0; // costs build time, thus only done for high quality builds
         settings.singleThreadThreshold = bvh->alloc.fixSingleThreadThreshold(N,DEFAULT_SINGLE_THREAD_THRESHOLD,pinfo.size(),node_bytes+leaf_bytes);
         
         /* build hierarchy */
+        BuildReport::Timer timer(scene->buildReport,BuildReport::HIERARCHY);
         auto root =
           BVHBuilderMSMBlur::build<NodeRef>(prims,pinfo,scene->device,
                                             RecalculatePrimRef<Mesh>(scene),
@@ -641,6 +656,7 @@ namespace embree
         settings.travCost = travCost;
         settings.intCost = intCost;
         settings.singleLeafTimeSegment = false; 
+        settings.manyTimeSegments = scene->getBuildQuality() == RTC_BUILD_QUALITY_HIGH ? MBLUR_MANY_TIME_SEGMENTS : 0; // costs build time, thus only done for high quality builds
         settings.singleThreadThreshold = bvh->alloc.fixSingleThreadThreshold(N,DEFAULT_SINGLE_THREAD_THRESHOLD,pinfo.size(),node_bytes+leaf_bytes);
         
         /* build hierarchy */
@@ -47,6 +47,7 @@ namespace embree
 
       __forceinline NodeRef operator() (const PrimRef* prims, const range<size_t>& set, const FastAllocator::CachedAllocator& alloc) const
       {
+        BuildReport::Timer timer(bvh->scene->buildReport,BuildReport::LEAVES);
         size_t n = set.size();
         size_t items = Primitive::blocks(n);
         size_t start = set.begin();
@@ -61,6 +62,46 @@ namespace embree
       BVH* bvh;
     };
 
+    /*! splitter factory that adds the time spent splitting primitive
+     *  references to the build report, clipping of bounds during
+     *  binning is not timed to keep the overhead low */
+    template<typename SplitterFactory>
+    struct TimedSplitterFactory
+    {
+      typedef decltype(std::declval<SplitterFactory>()(std::declval<PrimRef>())) Splitter;
+
+      struct TimedSplitter
+      {
+        __forceinline TimedSplitter (BuildReport& report, const Splitter& splitter)
+          : report(report), splitter(splitter) {}
+
+        __forceinline void operator() (const PrimRef& prim, const size_t dim, const float pos, PrimRef& left_o, PrimRef& right_o) const
+        {
+          BuildReport::Timer timer(report,BuildReport::SPATIAL_SPLITS);
+          splitter(prim,dim,pos,left_o,right_o);
+        }
+
+        __forceinline void operator() (const BBox3fa& prim, const size_t dim, const float pos, BBox3fa& left_o, BBox3fa& right_o) const {
+          splitter(prim,dim,pos,left_o,right_o);
+        }
+
+      private:
+        BuildReport& report;
+        Splitter splitter;
+      };
+
+      __forceinline TimedSplitterFactory (Scene* scene, BuildReport& report)
+        : factory(scene), report(report) {}
+
+      __forceinline TimedSplitter operator() (const PrimRef& prim) const {
+        return TimedSplitter(report,factory(prim));
+      }
+
+    private:
+      SplitterFactory factory;
+      BuildReport& report;
+    };
+
     template<int N, typename Mesh, typename Primitive, typename Splitter>
     struct BVHNBuilderFastSpatialSAH : public Builder
     {
@@ -103,11 +144,15 @@ namespace embree
         /* create primref array */
         const size_t numSplitPrimitives = max(numOriginalPrimitives,size_t(splitFactor*numOriginalPrimitives));
         prims0.resize(numSplitPrimitives);
-        PrimInfo pinfo = mesh ?
-          createPrimRefArray(mesh,prims0,bvh->scene->progressInterface) :
-          createPrimRefArray(scene,Mesh::geom_type,false,prims0,bvh->scene->progressInterface);
+        PrimInfo pinfo(empty);
+        {
+          BuildReport::Timer timer(bvh->scene->buildReport,BuildReport::PRIMREFS);
+          pinfo = mesh ?
+            createPrimRefArray(mesh,prims0,bvh->scene->progressInterface) :
+            createPrimRefArray(scene,Mesh::geom_type,false,prims0,bvh->scene->progressInterface);
+        }
 
-        Splitter splitter(scene);
+        TimedSplitterFactory<Splitter> splitter(scene,bvh->scene->buildReport);
 
         /* enable os_malloc for two level build */
         if (mesh)
@@ -121,16 +166,20 @@ namespace embree
         settings.branchingFactor = N;
         settings.maxDepth = BVH::maxBuildDepthLeaf;
 
-        NodeRef root = BVHBuilderBinnedFastSpatialSAH::build<NodeRef>(
-          typename BVH::CreateAlloc(bvh),
-          typename BVH::AlignedNode::Create2(),
-          typename BVH::AlignedNode::Set2(),
-          CreateLeafSpatial<N,Primitive>(bvh),
-          splitter,
-          bvh->scene->progressInterface,
-          prims0.data(),
-          numSplitPrimitives,
-          pinfo,settings);
+        NodeRef root;
+        {
+          BuildReport::Timer timer(bvh->scene->buildReport,BuildReport::HIERARCHY);
+          root = BVHBuilderBinnedFastSpatialSAH::build<NodeRef>(
+            typename BVH::CreateAlloc(bvh),
+            typename BVH::AlignedNode::Create2(),
+            typename BVH::AlignedNode::Set2(),
+            CreateLeafSpatial<N,Primitive>(bvh),
+            splitter,
+            bvh->scene->progressInterface,
+            prims0.data(),
+            numSplitPrimitives,
+            pinfo,settings);
+        }
 
         bvh->set(root,LBBox3fa(pinfo.geomBounds),pinfo.size());
         bvh->layoutLargeNodes(size_t(pinfo.size()*0.005f));
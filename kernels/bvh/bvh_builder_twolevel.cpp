@@ -117,9 +117,9 @@ namespace embree
       {
         for (size_t objectID=r.begin(); objectID<r.end(); objectID++)
         {
-          /* ignore if no triangle mesh or not enabled */
+          /* ignore if no triangle mesh, not enabled, or traced through an automatically created instance */
           Mesh* mesh = scene->getSafe<Mesh>(objectID);
-          if (mesh == nullptr || !mesh->isEnabled() || mesh->numTimeSteps != 1) 
+          if (mesh == nullptr || !mesh->isEnabled() || mesh->isInstanced() || mesh->numTimeSteps != 1) 
             continue;
         
           BVH*     object  = objects [objectID]; assert(object);
@@ -58,7 +58,7 @@ namespace embree
       StackItemT<NodeRef> stack[stackSize];    // stack of nodes
       StackItemT<NodeRef>* stackPtr = stack+1; // current stack pointer
       StackItemT<NodeRef>* stackEnd = stack+stackSize;
-      stack[0].ptr  = bvh->root;
+      stack[0].ptr  = bvh->getRoot();
       stack[0].dist = neg_inf;
       
       if (bvh->root == BVH::emptyNode)
@@ -78,12 +78,14 @@ namespace embree
 
       /* initialize the node traverser */
       BVHNNodeTraverser1Hit<N, Nx, types> nodeTraverser;
+      TRAV_COUNTER(context,travs++);
 
       /* pop loop */
       while (true) pop:
       {
         /* pop next node */
         if (unlikely(stackPtr == stack)) break;
+        TRAV_COUNTER(context,stack(stackPtr-stack));
         stackPtr--;
         NodeRef cur = NodeRef(stackPtr->ptr);
 
@@ -105,6 +107,7 @@ namespace embree
           STAT3(normal.trav_nodes,1,1,1);
           bool nodeIntersected = BVHNNodeIntersector1<N, Nx, types, robust>::intersect(cur, tray, ray.time(), tNear, mask);
           if (unlikely(!nodeIntersected)) { STAT3(normal.trav_nodes,-1,-1,-1); break; }
+          TRAV_COUNTER(context,nodes++);
 
           /* if no child is hit, pop next node */
           if (unlikely(mask == 0))
@@ -118,6 +121,8 @@ namespace embree
         assert(cur != BVH::emptyNode);
         STAT3(normal.trav_leaves,1,1,1);
         size_t num; Primitive* prim = (Primitive*)cur.leaf(num);
+        TRAV_COUNTER(context,leaves++);
+        TRAV_COUNTER(context,prims += num);
         size_t lazy_node = 0;
         PrimitiveIntersector1::intersect(This, pre, ray, context, prim, num, tray, lazy_node);
         tray.tfar = ray.tfar;
@@ -153,7 +158,7 @@ namespace embree
       NodeRef stack[stackSize];    // stack of nodes that still need to get traversed
       NodeRef* stackPtr = stack+1; // current stack pointer
       NodeRef* stackEnd = stack+stackSize;
-      stack[0] = bvh->root;
+      stack[0] = bvh->getRoot();
 
       /* filter out invalid rays */
 #if defined(EMBREE_IGNORE_INVALID_RAYS)
@@ -170,12 +175,14 @@ namespace embree
 
       /* initialize the node traverser */
       BVHNNodeTraverser1Hit<N, Nx, types> nodeTraverser;
+      TRAV_COUNTER(context,travs++);
 
       /* pop loop */
       while (true) pop:
       {
         /* pop next node */
         if (unlikely(stackPtr == stack)) break;
+        TRAV_COUNTER(context,stack(stackPtr-stack));
         stackPtr--;
         NodeRef cur = (NodeRef)*stackPtr;
 
@@ -187,6 +194,7 @@ namespace embree
           STAT3(shadow.trav_nodes,1,1,1);
           bool nodeIntersected = BVHNNodeIntersector1<N, Nx, types, robust>::intersect(cur, tray, ray.time(), tNear, mask);
           if (unlikely(!nodeIntersected)) { STAT3(shadow.trav_nodes,-1,-1,-1); break; }
+          TRAV_COUNTER(context,nodes++);
 
           /* if no child is hit, pop next node */
           if (unlikely(mask == 0))
@@ -200,6 +208,8 @@ namespace embree
         assert(cur != BVH::emptyNode);
         STAT3(shadow.trav_leaves,1,1,1);
         size_t num; Primitive* prim = (Primitive*)cur.leaf(num);
+        TRAV_COUNTER(context,leaves++);
+        TRAV_COUNTER(context,prims += num);
         size_t lazy_node = 0;
         if (PrimitiveIntersector1::occluded(This, pre, ray, context, prim, num, tray, lazy_node)) {
           ray.tfar = neg_inf;
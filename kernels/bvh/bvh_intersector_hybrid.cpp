@@ -71,6 +71,7 @@ namespace embree
       {
         /* pop next node */
         if (unlikely(stackPtr == stack)) break;
+        TRAV_COUNTER(context,stack(stackPtr-stack));
         stackPtr--;
         NodeRef cur = NodeRef(stackPtr->ptr);
 
@@ -90,6 +91,7 @@ namespace embree
           /* stop if we found a leaf node */
           if (unlikely(cur.isLeaf())) break;
           STAT3(normal.trav_nodes, 1, 1, 1);
+          TRAV_COUNTER(context,nodes++);
 
           /* intersect node */
           size_t mask = 0;
@@ -108,6 +110,8 @@ namespace embree
         assert(cur != BVH::emptyNode);
         STAT3(normal.trav_leaves, 1, 1, 1);
         size_t num; Primitive* prim = (Primitive*)cur.leaf(num);
+        TRAV_COUNTER(context,leaves++);
+        TRAV_COUNTER(context,prims += num);
 
         size_t lazy_node = 0;
         PrimitiveIntersectorK::intersect(This, pre, ray, k, context, prim, num, tray1, lazy_node);
@@ -157,6 +161,7 @@ namespace embree
 #endif
 
       if (unlikely(valid_bits == 0)) return;
+      TRAV_COUNTER(context,travs += popcnt(valid));
 
       /* verify correct input */
       assert(all(valid, ray.valid()));
@@ -176,7 +181,7 @@ namespace embree
         
         for (; valid_bits!=0; ) {
           const size_t i = bscf(valid_bits);
-          intersect1(This, bvh, bvh->root, i, pre, ray, tray, context);
+          intersect1(This, bvh, bvh->getRoot(), i, pre, ray, tray, context);
         }
         return;
       }
@@ -226,7 +231,7 @@ namespace embree
         NodeRef stack_node[stackSizeChunk];
         stack_node[0] = BVH::invalidNode;
         stack_near[0] = inf;
-        stack_node[1] = bvh->root;
+        stack_node[1] = bvh->getRoot();
         stack_near[1] = tray.tnear;
         NodeRef* stackEnd MAYBE_UNUSED = stack_node+stackSizeChunk;
         NodeRef* __restrict__ sptr_node = stack_node + 2;
@@ -236,6 +241,7 @@ namespace embree
         {
           /* pop next node from stack */
           assert(sptr_node > stack_node);
+          TRAV_COUNTER(context,stack(sptr_node-stack_node));
           sptr_node--;
           sptr_near--;
           NodeRef cur = *sptr_node;
@@ -275,6 +281,7 @@ namespace embree
             /* process nodes */
             const vbool<K> valid_node = tray.tfar > curDist;
             STAT3(normal.trav_nodes, 1, popcnt(valid_node), K);
+            TRAV_COUNTER(context,nodes += popcnt(valid_node));
             const NodeRef nodeRef = cur;
             const BaseNode* __restrict__ const node = nodeRef.baseNode(types);
 
@@ -376,6 +383,8 @@ namespace embree
           STAT3(normal.trav_leaves, 1, popcnt(valid_leaf), K);
           if (unlikely(none(valid_leaf))) continue;
           size_t items; const Primitive* prim = (Primitive*)cur.leaf(items);
+          TRAV_COUNTER(context,leaves += popcnt(valid_leaf));
+          TRAV_COUNTER(context,prims += items*popcnt(valid_leaf));
 
           size_t lazy_node = 0;
           PrimitiveIntersectorK::intersect(valid_leaf, This, pre, ray, context, prim, items, tray, lazy_node);
@@ -407,6 +416,7 @@ namespace embree
       /* return if there are no valid rays */
       size_t valid_bits = movemask(valid);
       if (unlikely(valid_bits == 0)) return;
+      TRAV_COUNTER(context,travs += popcnt(valid));
 
       /* verify correct input */
       assert(all(valid, ray.valid()));
@@ -435,7 +445,7 @@ namespace embree
 
         StackItemT<NodeRef> stack[stackSizeSingle];  // stack of nodes
         StackItemT<NodeRef>* stackPtr = stack + 1;   // current stack pointer
-        stack[0].ptr  = bvh->root;
+        stack[0].ptr  = bvh->getRoot();
         stack[0].dist = neg_inf;
 
         while (1) pop:
@@ -443,6 +453,7 @@ namespace embree
           /* pop next node from stack */
           if (unlikely(stackPtr == stack)) break;
 
+          TRAV_COUNTER(context,stack(stackPtr-stack));
           stackPtr--;
           NodeRef cur = NodeRef(stackPtr->ptr);
 
@@ -455,6 +466,7 @@ namespace embree
           {
             /* process nodes */
             //STAT3(normal.trav_nodes, 1, popcnt(valid_node), K);
+            TRAV_COUNTER(context,nodes += popcnt(curDist < tray.tfar));
             const NodeRef nodeRef = cur;
             const AlignedNode* __restrict__ const node = nodeRef.alignedNode();
 
@@ -526,6 +538,8 @@ namespace embree
           STAT3(normal.trav_leaves, 1, popcnt(valid_leaf), K);
           if (unlikely(none(valid_leaf))) continue;
           size_t items; const Primitive* prim = (Primitive*)cur.leaf(items);
+          TRAV_COUNTER(context,leaves += popcnt(valid_leaf));
+          TRAV_COUNTER(context,prims += items*popcnt(valid_leaf));
 
           size_t lazy_node = 0;
           PrimitiveIntersectorK::intersect(valid_leaf, This, pre, ray, context, prim, items, tray, lazy_node);
@@ -575,6 +589,7 @@ namespace embree
 	{
           /* pop next node */
 	  if (unlikely(stackPtr == stack)) break;
+          TRAV_COUNTER(context,stack(stackPtr-stack));
 	  stackPtr--;
           NodeRef cur = (NodeRef)*stackPtr;
 
@@ -584,6 +599,7 @@ namespace embree
             /* stop if we found a leaf node */
             if (unlikely(cur.isLeaf())) break;
             STAT3(shadow.trav_nodes, 1, 1, 1);
+            TRAV_COUNTER(context,nodes++);
 
             /* intersect node */
             size_t mask = 0;
@@ -602,6 +618,8 @@ namespace embree
           assert(cur != BVH::emptyNode);
           STAT3(shadow.trav_leaves, 1, 1, 1);
           size_t num; Primitive* prim = (Primitive*)cur.leaf(num);
+          TRAV_COUNTER(context,leaves++);
+          TRAV_COUNTER(context,prims += num);
 
           size_t lazy_node = 0;
           if (PrimitiveIntersectorK::occluded(This, pre, ray, k, context, prim, num, tray1, lazy_node)) {
@@ -647,6 +665,7 @@ namespace embree
       /* return if there are no valid rays */
       const size_t valid_bits = movemask(valid);
       if (unlikely(valid_bits == 0)) return;
+      TRAV_COUNTER(context,travs += popcnt(valid));
 
       /* verify correct input */
       assert(all(valid, ray.valid()));
@@ -673,7 +692,7 @@ namespace embree
       NodeRef stack_node[stackSizeChunk];
       stack_node[0] = BVH::invalidNode;
       stack_near[0] = inf;
-      stack_node[1] = bvh->root;
+      stack_node[1] = bvh->getRoot();
       stack_near[1] = tray.tnear;
       NodeRef* stackEnd MAYBE_UNUSED = stack_node+stackSizeChunk;
       NodeRef* __restrict__ sptr_node = stack_node + 2;
@@ -683,6 +702,7 @@ namespace embree
       {
         /* pop next node from stack */
         assert(sptr_node > stack_node);
+        TRAV_COUNTER(context,stack(sptr_node-stack_node));
         sptr_node--;
         sptr_near--;
         NodeRef cur = *sptr_node;
@@ -725,6 +745,7 @@ namespace embree
           /* process nodes */
           const vbool<K> valid_node = tray.tfar > curDist;
           STAT3(shadow.trav_nodes, 1, popcnt(valid_node), K);
+          TRAV_COUNTER(context,nodes += popcnt(valid_node));
           const NodeRef nodeRef = cur;
           const BaseNode* __restrict__ const node = nodeRef.baseNode(types);
 
@@ -786,6 +807,8 @@ namespace embree
         STAT3(shadow.trav_leaves, 1, popcnt(valid_leaf), K);
         if (unlikely(none(valid_leaf))) continue;
         size_t items; const Primitive* prim = (Primitive*) cur.leaf(items);
+        TRAV_COUNTER(context,leaves += popcnt(valid_leaf));
+        TRAV_COUNTER(context,prims += items*popcnt(valid_leaf));
 
         size_t lazy_node = 0;
         terminated |= PrimitiveIntersectorK::occluded(!terminated, This, pre, ray, context, prim, items, tray, lazy_node);
@@ -819,6 +842,7 @@ namespace embree
       /* return if there are no valid rays */
       size_t valid_bits = movemask(valid);
       if (unlikely(valid_bits == 0)) return;
+      TRAV_COUNTER(context,travs += popcnt(valid));
 
       /* verify correct input */
       assert(all(valid, ray.valid()));
@@ -849,7 +873,7 @@ namespace embree
 
         StackItemMaskT<NodeRef> stack[stackSizeSingle];  // stack of nodes
         StackItemMaskT<NodeRef>* stackPtr = stack + 1;   // current stack pointer
-        stack[0].ptr  = bvh->root;
+        stack[0].ptr  = bvh->getRoot();
         stack[0].mask = movemask(octant_valid);
 
         while (1) pop:
@@ -857,6 +881,7 @@ namespace embree
           /* pop next node from stack */
           if (unlikely(stackPtr == stack)) break;
 
+          TRAV_COUNTER(context,stack(stackPtr-stack));
           stackPtr--;
           NodeRef cur = NodeRef(stackPtr->ptr);
 
@@ -869,6 +894,7 @@ namespace embree
           {
             /* process nodes */
             //STAT3(normal.trav_nodes, 1, popcnt(valid_node), K);
+            TRAV_COUNTER(context,nodes += popcnt(m_active));
             const NodeRef nodeRef = cur;
             const AlignedNode* __restrict__ const node = nodeRef.alignedNode();
 
@@ -917,6 +943,8 @@ namespace embree
 #endif
           if (unlikely(!m_active)) continue;
           size_t items; const Primitive* prim = (Primitive*)cur.leaf(items);
+          TRAV_COUNTER(context,leaves += popcnt(m_active));
+          TRAV_COUNTER(context,prims += items*popcnt(m_active));
 
           size_t lazy_node = 0;
           terminated |= PrimitiveIntersectorK::occluded(!terminated, This, pre, ray, context, prim, items, tray, lazy_node);
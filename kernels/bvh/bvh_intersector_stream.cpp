@@ -87,9 +87,10 @@ namespace embree
         return;
       }
 
+      TRAV_COUNTER(context,travs += popcnt(m_active));
       stack[0].mask   = m_active;
       stack[0].parent = 0;
-      stack[0].child  = bvh->root;
+      stack[0].child  = bvh->getRoot();
 
       ///////////////////////////////////////////////////////////////////////////////////
       ///////////////////////////////////////////////////////////////////////////////////
@@ -102,6 +103,7 @@ namespace embree
         if (unlikely(stackPtr == stack)) break;
 
         STAT3(normal.trav_stack_pop,1,1,1);
+        TRAV_COUNTER(context,stack(stackPtr-stack));
         stackPtr--;
         /*! pop next node */
         NodeRef cur = NodeRef(stackPtr->child);
@@ -114,6 +116,7 @@ namespace embree
           if (unlikely(cur.isLeaf())) break;
           const AlignedNode* __restrict__ const node = cur.alignedNode();
           parent = cur;
+          TRAV_COUNTER(context,nodes += popcnt(m_trav_active));
 
           __aligned(64) size_t maskK[N];
           for (size_t i = 0; i < N; i++)
@@ -144,6 +147,8 @@ namespace embree
         size_t num; PrimitiveK<K>* prim = (PrimitiveK<K>*)cur.leaf(num);
 
         size_t bits = m_trav_active;
+        TRAV_COUNTER(context,leaves += popcnt(bits));
+        TRAV_COUNTER(context,prims += num*popcnt(bits));
 
         /*! intersect stream of rays with all primitives */
         size_t lazy_node = 0;
@@ -215,9 +220,10 @@ namespace embree
         return;
       }
 
+      TRAV_COUNTER(context,travs += popcnt(m_active));
       stack[0].mask   = m_active;
       stack[0].parent = 0;
-      stack[0].child  = bvh->root;
+      stack[0].child  = bvh->getRoot();
 
       ///////////////////////////////////////////////////////////////////////////////////
       ///////////////////////////////////////////////////////////////////////////////////
@@ -230,6 +236,7 @@ namespace embree
         if (unlikely(stackPtr == stack)) break;
 
         STAT3(normal.trav_stack_pop,1,1,1);
+        TRAV_COUNTER(context,stack(stackPtr-stack));
         stackPtr--;
         /*! pop next node */
         NodeRef cur = NodeRef(stackPtr->child);
@@ -243,6 +250,7 @@ namespace embree
           if (unlikely(cur.isLeaf())) break;
           const AlignedNode* __restrict__ const node = cur.alignedNode();
           parent = cur;
+          TRAV_COUNTER(context,nodes += popcnt(m_trav_active));
 
           __aligned(64) size_t maskK[N];
           for (size_t i = 0; i < N; i++)
@@ -274,6 +282,8 @@ namespace embree
         size_t num; PrimitiveK<K>* prim = (PrimitiveK<K>*)cur.leaf(num);
 
         size_t bits = m_trav_active & m_active;
+        TRAV_COUNTER(context,leaves += popcnt(bits));
+        TRAV_COUNTER(context,prims += num*popcnt(bits));
         /*! intersect stream of rays with all primitives */
         size_t lazy_node = 0;
 #if defined(__SSE4_2__)
@@ -328,10 +338,11 @@ namespace embree
 
       StackItemMaskT<NodeRef> stack[stackSizeSingle]; // stack of nodes
       StackItemMaskT<NodeRef>* stackPtr = stack + 1;  // current stack pointer
-      stack[0].ptr = bvh->root;
+      stack[0].ptr = bvh->getRoot();
       stack[0].mask = m_active;
 
       size_t terminated = ~m_active;
+      TRAV_COUNTER(context,travs += popcnt(m_active));
 
       /* near/far offsets based on first ray */
       const NearFarPrecalculations nf(Vec3fa(packet[0].rdir.x[0], packet[0].rdir.y[0], packet[0].rdir.z[0]), N);
@@ -340,6 +351,7 @@ namespace embree
       {
         if (unlikely(stackPtr == stack)) break;
         STAT3(shadow.trav_stack_pop,1,1,1);
+        TRAV_COUNTER(context,stack(stackPtr-stack));
         stackPtr--;
         NodeRef cur = NodeRef(stackPtr->ptr);
         size_t cur_mask = stackPtr->mask & (~terminated);
@@ -350,6 +362,7 @@ namespace embree
           /*! stop if we found a leaf node */
           if (unlikely(cur.isLeaf())) break;
           const AlignedNode* __restrict__ const node = cur.alignedNode();
+          TRAV_COUNTER(context,nodes += popcnt(cur_mask));
 
           const vint<Nx> vmask = traverseIncoherentStream(cur_mask, packet, node, nf, shiftTable);
 
@@ -396,6 +409,8 @@ namespace embree
 
         size_t bits = cur_mask;
         size_t lazy_node = 0;
+        TRAV_COUNTER(context,leaves += popcnt(bits));
+        TRAV_COUNTER(context,prims += num*popcnt(bits));
 
         for (; bits != 0;)
         {
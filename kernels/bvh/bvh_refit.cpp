@@ -47,6 +47,7 @@ namespace embree
     template<int N>
     void BVHNRefitter<N>::refit()
     {
+      bvh->clearReplicas();
       if (bvh->numPrimitives <= SINGLE_THREAD_THRESHOLD) {
         bvh->bounds = LBBox3fa(recurse_bottom(bvh->root));
       }
@@ -166,6 +166,9 @@ namespace embree
         args.rayhit = (RTCRayHitN*)&ray;
         args.N = 1;
         args.primID = (unsigned int)primID;
+        args.primIDs = &args.primID;
+        args.numPrimIDs = 1;
+        args.cone = context->cone;
         args.internal_context = context;
         args.geometry = this;
         args.report = report;
@@ -187,6 +190,9 @@ namespace embree
         args.ray = (RTCRayN*)&ray;
         args.N = 1;
         args.primID = (unsigned int)primID;
+        args.primIDs = &args.primID;
+        args.numPrimIDs = 1;
+        args.cone = context->cone;
         args.internal_context = context;
         args.geometry = this;
         args.report = report;
@@ -209,6 +215,9 @@ namespace embree
         args.rayhit = (RTCRayHitN*)&ray;
         args.N = K;
         args.primID = (unsigned int)primID;
+        args.primIDs = &args.primID;
+        args.numPrimIDs = 1;
+        args.cone = context->cone;
         args.internal_context = context;
         args.geometry = this;
         args.report = report;
@@ -231,6 +240,107 @@ namespace embree
         args.ray = (RTCRayN*)&ray;
         args.N = K;
         args.primID = (unsigned int)primID;
+        args.primIDs = &args.primID;
+        args.numPrimIDs = 1;
+        args.cone = context->cone;
+        args.internal_context = context;
+        args.geometry = this;
+        args.report = report;
+        
+        intersectorN.occluded(&args);
+      }
+
+      /*! Intersects a single ray with multiple primitives using a single invocation of a batched intersect function. */
+      __forceinline void intersect (RayHit& ray, const unsigned int* primIDs, size_t numPrimIDs, IntersectContext* context, ReportIntersectionFunc report) 
+      {
+        assert(intersectBatched);
+        assert(intersectorN.intersect);
+        
+        int mask = -1;
+        IntersectFunctionNArguments args;
+        args.valid = &mask;
+        args.geometryUserPtr = userPtr;
+        args.context = context->user;
+        args.rayhit = (RTCRayHitN*)&ray;
+        args.N = 1;
+        args.primID = primIDs[0];
+        args.primIDs = primIDs;
+        args.numPrimIDs = (unsigned int)numPrimIDs;
+        args.cone = context->cone;
+        args.internal_context = context;
+        args.geometry = this;
+        args.report = report;
+        
+        intersectorN.intersect(&args);
+      }
+
+      /*! Tests if a single ray is occluded by multiple primitives using a single invocation of a batched occluded function. */
+      __forceinline void occluded (Ray& ray, const unsigned int* primIDs, size_t numPrimIDs, IntersectContext* context, ReportOcclusionFunc report)
+      {
+        assert(occludedBatched);
+        assert(intersectorN.occluded);
+        
+        int mask = -1;
+        OccludedFunctionNArguments args;
+        args.valid = &mask;
+        args.geometryUserPtr = userPtr;
+        args.context = context->user;
+        args.ray = (RTCRayN*)&ray;
+        args.N = 1;
+        args.primID = primIDs[0];
+        args.primIDs = primIDs;
+        args.numPrimIDs = (unsigned int)numPrimIDs;
+        args.cone = context->cone;
+        args.internal_context = context;
+        args.geometry = this;
+        args.report = report;
+        
+        intersectorN.occluded(&args);
+      }
+
+      /*! Intersects a packet of K rays with multiple primitives using a single invocation of a batched intersect function. */
+      template<int K>
+        __forceinline void intersect (const vbool<K>& valid, RayHitK<K>& ray, const unsigned int* primIDs, size_t numPrimIDs, IntersectContext* context, ReportIntersectionFunc report) 
+      {
+        assert(intersectBatched);
+        assert(intersectorN.intersect);
+        
+        vint<K> mask = valid.mask32();
+        IntersectFunctionNArguments args;
+        args.valid = (int*)&mask;
+        args.geometryUserPtr = userPtr;
+        args.context = context->user;
+        args.rayhit = (RTCRayHitN*)&ray;
+        args.N = K;
+        args.primID = primIDs[0];
+        args.primIDs = primIDs;
+        args.numPrimIDs = (unsigned int)numPrimIDs;
+        args.cone = context->cone;
+        args.internal_context = context;
+        args.geometry = this;
+        args.report = report;
+         
+        intersectorN.intersect(&args);
+      }
+
+      /*! Tests if a packet of K rays is occluded by multiple primitives using a single invocation of a batched occluded function. */
+      template<int K>
+        __forceinline void occluded (const vbool<K>& valid, RayK<K>& ray, const unsigned int* primIDs, size_t numPrimIDs, IntersectContext* context, ReportOcclusionFunc report)
+      {
+        assert(occludedBatched);
+        assert(intersectorN.occluded);
+        
+        vint<K> mask = valid.mask32();
+        OccludedFunctionNArguments args;
+        args.valid = (int*)&mask;
+        args.geometryUserPtr = userPtr;
+        args.context = context->user;
+        args.ray = (RTCRayN*)&ray;
+        args.N = K;
+        args.primID = primIDs[0];
+        args.primIDs = primIDs;
+        args.numPrimIDs = (unsigned int)numPrimIDs;
+        args.cone = context->cone;
         args.internal_context = context;
         args.geometry = this;
         args.report = report;
@@ -241,6 +351,8 @@ namespace embree
     public:
       RTCBoundsFunction boundsFunc;
       IntersectorN intersectorN;
+      bool intersectBatched;   //!< intersect function handles multiple primitives per invocation
+      bool occludedBatched;    //!< occluded function handles multiple primitives per invocation
   };
   
 #define DEFINE_SET_INTERSECTORN(symbol,intersector)                     \
@@ -27,11 +27,11 @@ namespace embree
   public:
     /*! Buffer construction */
     Buffer() 
-      : device(nullptr), ptr(nullptr), numBytes(0), shared(false) {}
+      : device(nullptr), ptr(nullptr), numBytes(0), shared(false), mapped(false), fileOffset(0) {}
 
     /*! Buffer construction */
     Buffer(Device* device, size_t numBytes_in, void* ptr_in = nullptr)
-      : device(device), numBytes(numBytes_in)
+      : device(device), numBytes(numBytes_in), mapped(false), fileOffset(0)
     {
       device->refInc();
       
@@ -47,6 +47,16 @@ namespace embree
       }
     }
     
+    /*! Buffer construction from a memory mapped file */
+    Buffer(Device* device, const char* fileName, size_t offset, size_t numBytes_in)
+      : device(device), numBytes(numBytes_in), shared(true), mapped(true), fileOffset(offset)
+    {
+      ptr = (char*) os_map_file(fileName,offset,numBytes);
+      if (!ptr)
+        throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "cannot map file " + std::string(fileName));
+      device->refInc();
+    }
+
     /*! Buffer destruction */
     ~Buffer() {
       free();
@@ -99,6 +109,11 @@ namespace embree
     /*! frees the buffer */
     void free()
     {
+      if (mapped) {
+        os_unmap_file(ptr,fileOffset,numBytes);
+        mapped = false;
+        ptr = nullptr;
+      }
       if (shared) return;
       alignedFree(ptr); 
       if (device)
@@ -127,6 +142,11 @@ namespace embree
       return numBytes;
     }
     
+    /*! hints the OS to page in a range of a memory mapped buffer */
+    __forceinline void prefetch(const char* p, size_t bytes) const {
+      if (mapped) os_prefetch((void*)p,bytes);
+    }
+
     /*! returns true of the buffer is not empty */
     __forceinline operator bool() const { 
       return ptr; 
@@ -137,6 +157,8 @@ namespace embree
     char* ptr;       //!< pointer to buffer data
     size_t numBytes; //!< number of bytes in the buffer
     bool shared;     //!< set if memory is shared with application
+    bool mapped;     //!< set if memory is a mapped file
+    size_t fileOffset; //!< offset of the mapping inside the file
   };
 
   /*! An untyped contiguous range of a buffer. This class does not own the buffer content. */
@@ -211,6 +233,18 @@ namespace embree
       return ptr_ofs; 
     }
 
+    /*! returns true if the buffer is backed by a memory mapped file */
+    __forceinline bool isMapped() const {
+      return buffer && buffer->mapped;
+    }
+
+    /*! hints the OS to page in the elements [begin,end) of a memory mapped buffer */
+    __forceinline void prefetch(size_t begin, size_t end) const
+    {
+      if (begin < end)
+        buffer->prefetch(getPtr(begin),(end-begin)*stride);
+    }
+
     /*! checks padding to 16 byte check, fails hard */
     __forceinline void checkPadding16() const
     {
@@ -253,6 +287,17 @@ namespace embree
       return Vec3fa(vfloat4::loadu((float*)(ptr_ofs + i*stride)));
     }
     
+    /*! decodes the i'th element of a buffer stored in a compressed format */
+    __forceinline const Vec3fa decode(size_t i) const
+    {
+      assert(i<num);
+      const unsigned short* p = (const unsigned short*)(ptr_ofs + i*stride);
+      if (format == RTC_FORMAT_HALF3)
+        return Vec3fa(half_to_float(p[0]),half_to_float(p[1]),half_to_float(p[2]));
+      else /* normalized RTC_FORMAT_USHORT3 */
+        return Vec3fa(float(p[0]),float(p[1]),float(p[2]))*(1.0f/65535.0f);
+    }
+
     /*! writes the i'th element */
     __forceinline void store(size_t i, const Vec3fa& v)
     {
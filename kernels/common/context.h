@@ -18,19 +18,164 @@
 
 #include "default.h"
 #include "rtcore.h"
+#include "stat.h"
+
+/* Macro to update the traversal counters of the calling thread */
+#define TRAV_COUNTER(context,x) \
+  do { if (unlikely((context)->counters != nullptr)) (context)->counters->x; } while (false)
 
 namespace embree
 {
   class Scene;
 
+  /* returns the traversal counters of the calling thread, or NULL if the device of the scene does not count */
+  TraversalCounters* getTraversalCounters(Scene* scene);
+
+  /* gathers the hits closest to the ray origin for multi-hit queries */
+  struct MultiHitCollector
+  {
+  public:
+    __forceinline MultiHitCollector(RTCMultiHit* hits, unsigned int maxHitCount)
+      : hits(hits), maxHitCount(maxHitCount), numHits(0), geomID(RTC_INVALID_GEOMETRY_ID) {}
+
+    /* returns the ray distance after a hit got collected, which
+     * shrinks to the farthest collected hit once the buffer is full */
+    __forceinline float tfar(float t) const {
+      return numHits < maxHitCount ? t : min(t,hits[numHits-1].t);
+    }
+
+    /* inserts a hit into the distance sorted hit buffer */
+    void insert(float t, const RTCHit& hit)
+    {
+      if (numHits == maxHitCount && t >= hits[numHits-1].t)
+        return;
+
+      /* primitives referenced multiple times by the BVH report the same hit again */
+      const unsigned int hitGeomID = geomID != RTC_INVALID_GEOMETRY_ID ? geomID : hit.geomID;
+      for (unsigned int i=0; i<numHits; i++) {
+        if (hits[i].t == t && hits[i].hit.primID == hit.primID && hits[i].hit.geomID == hitGeomID && hits[i].hit.instID[0] == hit.instID[0])
+          return;
+      }
+
+      unsigned int i = numHits < maxHitCount ? numHits++ : maxHitCount-1;
+      for (; i>0 && hits[i-1].t > t; i--)
+        hits[i] = hits[i-1];
+      hits[i].t = t;
+      hits[i].hit = hit;
+      hits[i].hit.geomID = hitGeomID;
+    }
+
+  public:
+    RTCMultiHit* hits;         //!< user provided hit buffer
+    unsigned int maxHitCount;  //!< size of the hit buffer
+    unsigned int numHits;      //!< number of collected hits
+    unsigned int geomID;       //!< geometry ID reported for hits inside automatic instances
+  };
+
+  /* accumulates the transmittance along the ray for transmittance queries */
+  struct TransmittanceAccumulator
+  {
+    static const unsigned int MAX_HITS = 64; //!< number of hits stored without heap allocation
+
+    struct HitID
+    {
+      __forceinline HitID () {}
+
+      __forceinline HitID (float t, const RTCHit& hit)
+        : t(t), primID(hit.primID), geomID(hit.geomID), instID(hit.instID[0]) {}
+
+      __forceinline bool operator== (const HitID& other) const {
+        return t == other.t && primID == other.primID && geomID == other.geomID && instID == other.instID;
+      }
+
+      __forceinline bool operator< (const HitID& other) const
+      {
+        if (t != other.t) return t < other.t;
+        if (primID != other.primID) return primID < other.primID;
+        if (geomID != other.geomID) return geomID < other.geomID;
+        return instID < other.instID;
+      }
+
+    public:
+      float t;
+      unsigned int primID;
+      unsigned int geomID;
+      unsigned int instID;
+    };
+
+  public:
+    __forceinline TransmittanceAccumulator(float minTransmittance)
+      : transmittance(1.0f), minTransmittance(minTransmittance), numHits(0) {}
+
+    /* returns true if the hit got already accumulated, otherwise records it */
+    bool duplicate(const HitID& id)
+    {
+      const unsigned int N = min(numHits,MAX_HITS);
+      for (unsigned int i=0; i<N; i++)
+        if (hits[i] == id) return true;
+
+      if (numHits < MAX_HITS) {
+        hits[numHits] = id;
+        return false;
+      }
+
+      /* further hits are kept sorted in a growing array */
+      auto iter = std::lower_bound(overflow.begin(),overflow.end(),id);
+      if (iter != overflow.end() && *iter == id) return true;
+      overflow.insert(iter,id);
+      return false;
+    }
+
+    /* multiplies in the opacity of a hit, returns true when the ray got occluded */
+    bool accumulate(float t, const RTCHit& hit, float opacity)
+    {
+      /* primitives referenced multiple times by the BVH report the same hit again */
+      if (duplicate(HitID(t,hit)))
+        return false;
+      numHits++;
+
+      transmittance *= 1.0f - clamp(opacity,0.0f,1.0f);
+      if (transmittance <= minTransmittance) {
+        transmittance = 0.0f;
+        return true;
+      }
+      return false;
+    }
+
+  public:
+    float transmittance;       //!< transmittance accumulated so far
+    float minTransmittance;    //!< the ray counts as occluded below this transmittance
+    unsigned int numHits;      //!< number of accumulated hits
+    HitID hits[MAX_HITS];          //!< first accumulated hits
+    std::vector<HitID> overflow;   //!< further accumulated hits sorted for fast lookup
+  };
+
   struct IntersectContext
   {
   public:
-    __forceinline IntersectContext(Scene* scene, RTCIntersectContext* user_context)
-      : scene(scene), user(user_context), instID(user_context->instID[0]) {}
+    __forceinline IntersectContext(Scene* scene, RTCIntersectContext* user_context, MultiHitCollector* multiHit = nullptr, TransmittanceAccumulator* transmittance = nullptr, const RTCRayCone* cone = nullptr)
+      : scene(scene), user(user_context), instID(user_context->instID[0]), multiHit(multiHit), transmittance(transmittance), cone(cone), counters(nullptr)
+    {
+      if (unlikely(TraversalCounters::numEnabledDevices.load(std::memory_order_relaxed) != 0))
+        counters = getTraversalCounters(scene);
+    }
 
+    /* multi-hit and transmittance queries process hits on the filter path */
     __forceinline bool hasContextFilter() const {
-      return user->filter != nullptr;
+      return user->filter != nullptr || multiHit != nullptr || transmittance != nullptr;
+    }
+
+    /* returns the ray distance to restore when a hit got rejected by the intersection filters */
+    __forceinline float rejectTfar(float old_t) const {
+      return unlikely(multiHit != nullptr) ? multiHit->tfar(old_t) : old_t;
+    }
+
+    /* returns the width of the ray cone at the projection of point p onto the ray, or zero without a ray cone */
+    __forceinline float coneWidth(const Vec3fa& org, const Vec3fa& dir, const Vec3fa& p) const
+    {
+      if (likely(cone == nullptr)) return 0.0f;
+      const float t = max(dot(p-org,dir),0.0f)*rcp(length(dir));
+      return cone->width + t*cone->spreadAngle;
     }
 
     __forceinline bool isCoherent() const {
@@ -45,5 +190,19 @@ namespace embree
     Scene* scene;
     RTCIntersectContext* user;
     unsigned int instID;
+    MultiHitCollector* multiHit;
+    TransmittanceAccumulator* transmittance;
+    const RTCRayCone* cone;
+    TraversalCounters* counters;
   };
+
+  /* transforms a ray cone into the space of an instance, the spread
+   * angle is preserved and the width scales like the ray direction */
+  __forceinline RTCRayCone transformRayCone(const RTCRayCone& cone, const Vec3fa& world_dir, const Vec3fa& local_dir)
+  {
+    RTCRayCone local;
+    local.width = cone.width*length(local_dir)*rcp(length(world_dir));
+    local.spreadAngle = cone.spreadAngle;
+    return local;
+  }
 }
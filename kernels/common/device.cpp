@@ -111,10 +111,24 @@ namespace embree
     SELECT_SYMBOL_DEFAULT_SSE42_AVX_AVX2_AVX512KNL_AVX512SKX(enabled_cpu_features,rayStreamFilterFuncs);
     rayStreamFilters = rayStreamFilterFuncs();
 #endif
+
+    /* enable traversal counters if requested through the configuration */
+    static std::atomic<size_t> g_traversal_counters_id(1);
+    traversalCountersID = g_traversal_counters_id++;
+    if (State::traversal_counters) {
+      State::traversal_counters = false;
+      enableTraversalCounters(true);
+    }
+
+    /* record trace events if a trace file is configured */
+    tracing = State::trace_file != "" && Tracer::start(State::trace_buffer_size);
   }
 
   Device::~Device ()
   {
+    if (tracing && !Tracer::stop(State::trace_file.c_str()))
+      std::cerr << "Embree: cannot write trace file " << State::trace_file << std::endl;
+    enableTraversalCounters(false);
     setCacheSize(0);
     exitTaskingSystem();
   }
@@ -370,6 +384,12 @@ namespace embree
     case 1000003: debug_int3 = val; return;
     }
 
+    switch (prop)
+    {
+    case RTC_DEVICE_PROPERTY_TRAVERSAL_COUNTERS_ENABLED: enableTraversalCounters(val != 0); return;
+    default: break;
+    }
+
     throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "unknown writable property");
   }
 
@@ -505,7 +525,79 @@ namespace embree
     case RTC_DEVICE_PROPERTY_JOIN_COMMIT_SUPPORTED: return 1;
 #endif
 
+    case RTC_DEVICE_PROPERTY_TRAVERSAL_COUNTERS_ENABLED: return State::traversal_counters;
+
     default: throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "unknown readable property"); break;
     };
   }
+
+  void Device::enableTraversalCounters(bool enable)
+  {
+    if (State::traversal_counters == enable) return;
+    State::traversal_counters = enable;
+    if (enable) TraversalCounters::numEnabledDevices++;
+    else        TraversalCounters::numEnabledDevices--;
+  }
+
+  /* small direct mapped cache of the counters last used by a thread, tagged with the ID of their device */
+  static const size_t THREAD_TRAVERSAL_COUNTERS_CACHE_SIZE = 4;
+  static __thread size_t thread_traversal_counters_id[THREAD_TRAVERSAL_COUNTERS_CACHE_SIZE] = { 0 };
+  static __thread TraversalCounters* thread_traversal_counters[THREAD_TRAVERSAL_COUNTERS_CACHE_SIZE] = { nullptr };
+
+  /* unique key of a thread to find its counters in each device */
+  static std::atomic<size_t> g_traversal_counters_thread_key(1);
+  static __thread size_t thread_traversal_counters_key = 0;
+
+  TraversalCounters* Device::getTraversalCounters()
+  {
+    if (!State::traversal_counters) 
+      return nullptr;
+    
+    const size_t slot = traversalCountersID % THREAD_TRAVERSAL_COUNTERS_CACHE_SIZE;
+    if (likely(thread_traversal_counters_id[slot] == traversalCountersID))
+      return thread_traversal_counters[slot];
+
+    /* look up the counters of this thread, threads that alternate between devices thus register only once per device */
+    if (thread_traversal_counters_key == 0)
+      thread_traversal_counters_key = g_traversal_counters_thread_key++;
+
+    Lock<MutexSys> lock(traversalCountersMutex);
+    TraversalCounters*& counters = threadTraversalCounters[thread_traversal_counters_key];
+    if (counters == nullptr) {
+      counters = new TraversalCounters(traversalCounters.size());
+      traversalCounters.push_back(std::unique_ptr<TraversalCounters>(counters));
+    }
+    thread_traversal_counters_id[slot] = traversalCountersID;
+    thread_traversal_counters[slot] = counters;
+    return counters;
+  }
+
+  size_t Device::getTraversalCounters(RTCTraversalCounters* counters, size_t maxCount)
+  {
+    Lock<MutexSys> lock(traversalCountersMutex);
+    if (counters == nullptr) 
+      return traversalCounters.size();
+
+    const size_t N = min(maxCount,traversalCounters.size());
+    for (size_t i=0; i<N; i++)
+    {
+      const TraversalCounters* c = traversalCounters[i].get();
+      counters[i].threadIndex = (unsigned int) c->threadIndex;
+      counters[i].traversals = c->travs;
+      counters[i].nodes = c->nodes;
+      counters[i].leaves = c->leaves;
+      counters[i].primitives = c->prims;
+      counters[i].filterCalls = c->filters;
+      counters[i].instanceTransitions = c->instances;
+      counters[i].maxStackDepth = c->stack_depth;
+    }
+    return traversalCounters.size();
+  }
+
+  void Device::resetTraversalCounters()
+  {
+    Lock<MutexSys> lock(traversalCountersMutex);
+    for (auto& c : traversalCounters)
+      c->clear();
+  }
 }
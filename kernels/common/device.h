@@ -19,6 +19,7 @@
 #include "default.h"
 #include "state.h"
 #include "accel.h"
+#include "stat.h"
 
 namespace embree
 {
@@ -67,6 +68,18 @@ namespace embree
     /*! gets a property */
     ssize_t getProperty(const RTCDeviceProperty prop);
 
+    /*! enables or disables counting of traversal operations */
+    void enableTraversalCounters(bool enable);
+
+    /*! returns the traversal counters of the calling thread, or NULL if counting is disabled */
+    TraversalCounters* getTraversalCounters();
+
+    /*! copies the traversal counters of at most maxCount threads and returns the number of threads */
+    size_t getTraversalCounters(RTCTraversalCounters* counters, size_t maxCount);
+
+    /*! resets the traversal counters of all threads */
+    void resetTraversalCounters();
+
   private:
 
     /*! initializes the tasking system */
@@ -94,5 +107,16 @@ namespace embree
     
     /* ray streams filter */
     RayStreamFilterFuncs rayStreamFilters;
+
+    /* per thread traversal counters */
+  private:
+    size_t traversalCountersID;  //!< unique ID to detect stale thread local references
+    MutexSys traversalCountersMutex;
+    std::vector<std::unique_ptr<TraversalCounters>> traversalCounters;
+    std::map<size_t,TraversalCounters*> threadTraversalCounters; //!< counters of each thread by its thread key
+
+    /* trace events of the tasking system and builders */
+  private:
+    bool tracing;  //!< true if this device started the tracer
   };
 }
@@ -59,7 +59,9 @@ namespace embree
       state(MODIFIED),
       numPrimitivesChanged(false),
       enabled(true),
-      intersectionFilterN(nullptr), occlusionFilterN(nullptr)
+      instanced(false),
+      opacityMicromap(false),
+      intersectionFilterN(nullptr), occlusionFilterN(nullptr), opacityFunction(nullptr)
   {
     device->refInc();
   }
@@ -137,11 +139,22 @@ namespace embree
 
     if (enable) {
       scene->numIntersectionFiltersN += numN;
+      scene->numOpacityMicromaps += opacityMicromap;
     } else {
       scene->numIntersectionFiltersN -= numN;
+      scene->numOpacityMicromaps -= opacityMicromap;
     }
   }
 
+  void Geometry::setOpacityMicromap(bool enable)
+  {
+    if (scene && isEnabled()) {
+      scene->numOpacityMicromaps -= opacityMicromap;
+      scene->numOpacityMicromaps += enable;
+    }
+    opacityMicromap = enable;
+  }
+
   Geometry* Geometry::attach(Scene* scene, unsigned int geomID)
   {
     assert(scene);
@@ -223,6 +236,14 @@ namespace embree
     occlusionFilterN = filter;
   }
 
+  void Geometry::setOpacityFunction (RTCOpacityFunction opacity) 
+  {
+    if (!(getTypeMask() & (MTY_TRIANGLE_MESH | MTY_QUAD_MESH | MTY_CURVES | MTY_SUBDIV_MESH | MTY_USER_GEOMETRY | MTY_GRID_MESH)))
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"opacity functions not supported for this geometry"); 
+
+    opacityFunction = opacity;
+  }
+
   void Geometry::interpolateN(const RTCInterpolateNArguments* const args)
   {
     const void* valid_i = args->valid;
@@ -134,6 +134,9 @@ namespace embree
     /*! updates intersection filter function counts in scene */
     void updateIntersectionFilters(bool enable);
 
+    /*! enables testing of hits against an opacity micromap */
+    void setOpacityMicromap(bool enable);
+
   public:
 
     /*! tests if geometry is enabled */
@@ -142,6 +145,9 @@ namespace embree
     /*! tests if geometry is disabled */
     __forceinline bool isDisabled() const { return !isEnabled(); }
 
+    /*! tests if geometry is traced through an automatically created instance */
+    __forceinline bool isInstanced() const { return instanced; }
+
     /*! tests if geometry is modified */
     __forceinline bool isModified() const { return state != BUILD; }
 
@@ -331,6 +337,9 @@ namespace embree
     /*! Set occlusion filter function for ray packets of size N. */
     virtual void setOcclusionFilterFunctionN (RTCFilterFunctionN filterN);
 
+    /*! Set opacity function used by transmittance queries. */
+    virtual void setOpacityFunction (RTCOpacityFunction opacity);
+
     /*! for instances only */
   public:
 
@@ -338,6 +347,11 @@ namespace embree
     virtual void setInstancedScene(const Ref<Scene>& scene) {
       throw_RTCError(RTC_ERROR_INVALID_OPERATION,"operation not supported for this geometry"); 
     }
+
+    /*! Sets the instanced scene for a level of detail */
+    virtual void setInstancedSceneLOD(unsigned int level, const Ref<Scene>& scene, float distance, float blendRange) {
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"operation not supported for this geometry"); 
+    }
     
     /*! Sets transformation of the instance */
     virtual void setTransform(const AffineSpace3fa& transform, unsigned int timeStep) {
@@ -357,13 +371,13 @@ namespace embree
       throw_RTCError(RTC_ERROR_INVALID_OPERATION,"operation not supported for this geometry"); 
     }
 
-    /*! Set intersect function for ray packets of size N. */
-    virtual void setIntersectFunctionN (RTCIntersectFunctionN intersect) { 
+    /*! Set intersect function for ray packets of size N, optionally handling multiple primitives per invocation. */
+    virtual void setIntersectFunctionN (RTCIntersectFunctionN intersect, bool batched) { 
       throw_RTCError(RTC_ERROR_INVALID_OPERATION,"operation not supported for this geometry"); 
     }
     
-    /*! Set occlusion function for ray packets of size N. */
-    virtual void setOccludedFunctionN (RTCOccludedFunctionN occluded) { 
+    /*! Set occlusion function for ray packets of size N, optionally handling multiple primitives per invocation. */
+    virtual void setOccludedFunctionN (RTCOccludedFunctionN occluded, bool batched) { 
       throw_RTCError(RTC_ERROR_INVALID_OPERATION,"operation not supported for this geometry"); 
     }
 
@@ -386,6 +400,11 @@ namespace embree
       throw_RTCError(RTC_ERROR_INVALID_OPERATION,"createPrimRefMBArray not implemented for this geometry"); 
     }
 
+    /*! hints the OS to page in the memory mapped buffer data of a primitive range, returns false if no buffer is memory mapped */
+    virtual bool prefetchPrimRefs(const range<size_t>& r) const {
+      return false;
+    }
+
     virtual LinearSpace3fa computeAlignedSpace(const size_t primID) const {
       throw_RTCError(RTC_ERROR_INVALID_OPERATION,"computeAlignedSpace not implemented for this geometry"); 
     }
@@ -429,6 +448,8 @@ namespace embree
   public:
     __forceinline bool hasIntersectionFilter() const { return intersectionFilterN != nullptr; }
     __forceinline bool hasOcclusionFilter() const { return occlusionFilterN != nullptr; }
+    __forceinline bool hasOpacityFunction() const { return opacityFunction != nullptr; }
+    __forceinline bool hasOpacityMicromap() const { return opacityMicromap; }
 
   public:
     Device* device;             //!< device this geometry belongs to
@@ -449,9 +470,12 @@ namespace embree
       State state : 2;
       bool numPrimitivesChanged : 1; //!< true if number of primitives changed
       bool enabled : 1;              //!< true if geometry is enabled
+      bool instanced : 1;            //!< true if geometry is replaced by an automatically created instance
+      bool opacityMicromap : 1;      //!< true if hits are tested against an opacity micromap
     };
        
     RTCFilterFunctionN intersectionFilterN;
     RTCFilterFunctionN occlusionFilterN;
+    RTCOpacityFunction opacityFunction;
   };
 }
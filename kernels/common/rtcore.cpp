@@ -118,6 +118,27 @@ namespace embree
     RTC_CATCH_END(device);
   }
 
+  RTC_API size_t rtcGetDeviceTraversalCounters(RTCDevice hdevice, RTCTraversalCounters* counters, size_t maxCount)
+  {
+    Device* device = (Device*) hdevice;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcGetDeviceTraversalCounters);
+    RTC_VERIFY_HANDLE(hdevice);
+    return device->getTraversalCounters(counters,maxCount);
+    RTC_CATCH_END(device);
+    return 0;
+  }
+
+  RTC_API void rtcResetDeviceTraversalCounters(RTCDevice hdevice)
+  {
+    Device* device = (Device*) hdevice;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcResetDeviceTraversalCounters);
+    RTC_VERIFY_HANDLE(hdevice);
+    device->resetTraversalCounters();
+    RTC_CATCH_END(device);
+  }
+
   RTC_API RTCBuffer rtcNewBuffer(RTCDevice hdevice, size_t byteSize)
   {
     RTC_CATCH_BEGIN;
@@ -140,6 +161,18 @@ namespace embree
     return nullptr;
   }
 
+  RTC_API RTCBuffer rtcNewMappedBuffer(RTCDevice hdevice, const char* fileName, size_t byteOffset, size_t byteSize)
+  {
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcNewMappedBuffer);
+    RTC_VERIFY_HANDLE(hdevice);
+    RTC_VERIFY_HANDLE(fileName);
+    Buffer* buffer = new Buffer((Device*)hdevice, fileName, byteOffset, byteSize);
+    return (RTCBuffer)buffer->refInc();
+    RTC_CATCH_END((Device*)hdevice);
+    return nullptr;
+  }
+
   RTC_API void* rtcGetBufferData(RTCBuffer hbuffer)
   {
     Buffer* buffer = (Buffer*)hbuffer;
@@ -248,6 +281,31 @@ namespace embree
     RTC_CATCH_END2(scene);
   }
 
+  RTC_API void rtcGetSceneBuildReport(RTCScene hscene, RTCSceneBuildReport* report_o)
+  {
+    Scene* scene = (Scene*) hscene;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcGetSceneBuildReport);
+    RTC_VERIFY_HANDLE(hscene);
+    if (report_o == nullptr)
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"invalid destination pointer");
+
+    const BuildReport::Result report = scene->buildReport.get();
+    report_o->commitTime       = report.commitTime;
+    report_o->primRefTime      = report.phaseTimes[BuildReport::PRIMREFS];
+    report_o->hierarchyTime    = report.phaseTimes[BuildReport::HIERARCHY];
+    report_o->spatialSplitTime = report.phaseTimes[BuildReport::SPATIAL_SPLITS];
+    report_o->leafTime         = report.phaseTimes[BuildReport::LEAVES];
+    report_o->numThreads       = (unsigned int) report.numThreads;
+    report_o->numBVHs          = (unsigned int) report.numBVHs;
+    report_o->numPrimitives    = report.numPrimitives;
+    report_o->bytesAllocated   = report.bytesAllocated;
+    report_o->bytesUsed        = report.bytesUsed;
+    report_o->bytesWasted      = report.bytesWasted;
+    report_o->sahCost          = (float) report.sah;
+    RTC_CATCH_END2(scene);
+  }
+
   RTC_API void rtcGetSceneBounds(RTCScene hscene, RTCBounds* bounds_o)
   {
     Scene* scene = (Scene*) hscene;
@@ -316,6 +374,54 @@ namespace embree
     RTC_CATCH_END2(scene);
   }
 
+  RTC_API unsigned int rtcIntersectMultiHit1 (RTCScene hscene, RTCIntersectContext* user_context, RTCRay* ray, RTCMultiHit* hits, unsigned int maxHitCount) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcIntersectMultiHit1);
+#if defined(DEBUG)
+    RTC_VERIFY_HANDLE(hscene);
+    if (scene->isModified()) throw_RTCError(RTC_ERROR_INVALID_OPERATION,"scene got not committed");
+    if (((size_t)ray) & 0x0F) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "ray not aligned to 16 bytes");   
+#endif
+#if defined(EMBREE_FILTER_FUNCTION)
+    if (maxHitCount == 0) return 0;
+    if (hits == nullptr) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "invalid hit buffer");
+    STAT3(normal.travs,1,1,1);
+    RTCRayHit rayhit;
+    rayhit.ray = *ray;
+    rayhit.hit.geomID = RTC_INVALID_GEOMETRY_ID;
+    rayhit.hit.instID[0] = RTC_INVALID_GEOMETRY_ID;
+    MultiHitCollector multiHit(hits,maxHitCount);
+    IntersectContext context(scene,user_context,&multiHit);
+    scene->intersectors.intersect(rayhit,&context);
+    return multiHit.numHits;
+#else
+    throw_RTCError(RTC_ERROR_INVALID_OPERATION,"multi-hit queries require filter function support");
+#endif
+    RTC_CATCH_END2(scene);
+    return 0;
+  }
+
+  RTC_API void rtcIntersectCone1 (RTCScene hscene, RTCIntersectContext* user_context, RTCRayHit* rayhit, const RTCRayCone* cone) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcIntersectCone1);
+#if defined(DEBUG)
+    RTC_VERIFY_HANDLE(hscene);
+    if (scene->isModified()) throw_RTCError(RTC_ERROR_INVALID_OPERATION,"scene got not committed");
+    if (((size_t)rayhit) & 0x0F) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "ray not aligned to 16 bytes");   
+#endif
+    STAT3(normal.travs,1,1,1);
+    IntersectContext context(scene,user_context,nullptr,nullptr,cone);
+    scene->intersectors.intersect(*rayhit,&context);
+#if defined(DEBUG)
+    ((RayHit*)rayhit)->verifyHit();
+#endif
+    RTC_CATCH_END2(scene);
+  }
+
   RTC_API void rtcIntersect4 (const int* valid, RTCScene hscene, RTCIntersectContext* user_context, RTCRayHit4* rayhit) 
   {
     Scene* scene = (Scene*) hscene;
@@ -567,6 +673,46 @@ namespace embree
     RTC_CATCH_END2(scene);
   }
   
+  RTC_API float rtcOccludedTransmittance1 (RTCScene hscene, RTCIntersectContext* user_context, RTCRay* ray, float minTransmittance) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcOccludedTransmittance1);
+    STAT3(shadow.travs,1,1,1);
+#if defined(DEBUG)
+    RTC_VERIFY_HANDLE(hscene);
+    if (scene->isModified()) throw_RTCError(RTC_ERROR_INVALID_OPERATION,"scene got not committed");
+    if (((size_t)ray) & 0x0F) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "ray not aligned to 16 bytes");   
+#endif
+#if defined(EMBREE_FILTER_FUNCTION)
+    RTCRay tray = *ray;
+    TransmittanceAccumulator transmittance(minTransmittance);
+    IntersectContext context(scene,user_context,nullptr,&transmittance);
+    scene->intersectors.occluded(tray,&context);
+    return tray.tfar < 0.0f ? 0.0f : transmittance.transmittance;
+#else
+    throw_RTCError(RTC_ERROR_INVALID_OPERATION,"transmittance queries require filter function support");
+#endif
+    RTC_CATCH_END2(scene);
+    return 0.0f;
+  }
+
+  RTC_API void rtcOccludedCone1 (RTCScene hscene, RTCIntersectContext* user_context, RTCRay* ray, const RTCRayCone* cone) 
+  {
+    Scene* scene = (Scene*) hscene;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcOccludedCone1);
+    STAT3(shadow.travs,1,1,1);
+#if defined(DEBUG)
+    RTC_VERIFY_HANDLE(hscene);
+    if (scene->isModified()) throw_RTCError(RTC_ERROR_INVALID_OPERATION,"scene got not committed");
+    if (((size_t)ray) & 0x0F) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "ray not aligned to 16 bytes");   
+#endif
+    IntersectContext context(scene,user_context,nullptr,nullptr,cone);
+    scene->intersectors.occluded(*ray,&context);
+    RTC_CATCH_END2(scene);
+  }
+
   RTC_API void rtcOccluded4 (const int* valid, RTCScene hscene, RTCIntersectContext* user_context, RTCRay4* ray) 
   {
     Scene* scene = (Scene*) hscene;
@@ -826,6 +972,17 @@ namespace embree
     RTC_CATCH_END2(geometry);
   }
 
+  RTC_API void rtcSetGeometryInstancedSceneLOD(RTCGeometry hgeometry, unsigned int level, RTCScene hscene, float distance, float blendRange)
+  {
+    Geometry* geometry = (Geometry*) hgeometry;
+    Ref<Scene> scene = (Scene*) hscene;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcSetGeometryInstancedSceneLOD);
+    RTC_VERIFY_HANDLE(hgeometry);
+    geometry->setInstancedSceneLOD(level,scene,distance,blendRange);
+    RTC_CATCH_END2(geometry);
+  }
+
   AffineSpace3fa loadTransform(RTCFormat format, const float* xfm)
   {
     AffineSpace3fa space = one;
@@ -985,6 +1142,7 @@ namespace embree
 #endif
     }
 
+    case RTC_GEOMETRY_TYPE_ROUND_LINEAR_CURVE:
     case RTC_GEOMETRY_TYPE_FLAT_LINEAR_CURVE:
       
     case RTC_GEOMETRY_TYPE_ROUND_BEZIER_CURVE:
@@ -1007,7 +1165,7 @@ namespace embree
       
       Geometry* geom;
       switch (type) {
-      //case RTC_GEOMETRY_TYPE_ROUND_LINEAR_CURVE            : geom = createLineSegments (device,Geometry::GTY_ROUND_LINEAR_CURVE); break;
+      case RTC_GEOMETRY_TYPE_ROUND_LINEAR_CURVE            : geom = createLineSegments (device,Geometry::GTY_ROUND_LINEAR_CURVE); break;
       case RTC_GEOMETRY_TYPE_FLAT_LINEAR_CURVE             : geom = createLineSegments (device,Geometry::GTY_FLAT_LINEAR_CURVE); break;
       //case RTC_GEOMETRY_TYPE_NORMAL_ORIENTED_LINEAR_CURVE  : geom = createLineSegments (device,Geometry::GTY_ORIENTED_LINEAR_CURVE); break;
         
@@ -1349,7 +1507,7 @@ namespace embree
     RTC_CATCH_BEGIN;
     RTC_TRACE(rtcSetGeometryIntersectFunction);
     RTC_VERIFY_HANDLE(hgeometry);
-    geometry->setIntersectFunctionN(intersect);
+    geometry->setIntersectFunctionN(intersect,false);
     RTC_CATCH_END2(geometry);
   }
 
@@ -1409,7 +1567,27 @@ namespace embree
     RTC_CATCH_BEGIN;
     RTC_TRACE(rtcSetOccludedFunctionN);
     RTC_VERIFY_HANDLE(hgeometry);
-    geometry->setOccludedFunctionN(occluded);
+    geometry->setOccludedFunctionN(occluded,false);
+    RTC_CATCH_END2(geometry);
+  }
+
+  RTC_API void rtcSetGeometryIntersectBatchFunction (RTCGeometry hgeometry, RTCIntersectFunctionN intersect) 
+  {
+    Geometry* geometry = (Geometry*) hgeometry;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcSetGeometryIntersectBatchFunction);
+    RTC_VERIFY_HANDLE(hgeometry);
+    geometry->setIntersectFunctionN(intersect,true);
+    RTC_CATCH_END2(geometry);
+  }
+
+  RTC_API void rtcSetGeometryOccludedBatchFunction (RTCGeometry hgeometry, RTCOccludedFunctionN occluded) 
+  {
+    Geometry* geometry = (Geometry*) hgeometry;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcSetGeometryOccludedBatchFunction);
+    RTC_VERIFY_HANDLE(hgeometry);
+    geometry->setOccludedFunctionN(occluded,true);
     RTC_CATCH_END2(geometry);
   }
 
@@ -1433,6 +1611,16 @@ namespace embree
     RTC_CATCH_END2(geometry);
   }
 
+  RTC_API void rtcSetGeometryOpacityFunction (RTCGeometry hgeometry, RTCOpacityFunction opacity) 
+  {
+    Geometry* geometry = (Geometry*) hgeometry;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcSetGeometryOpacityFunction);
+    RTC_VERIFY_HANDLE(hgeometry);
+    geometry->setOpacityFunction(opacity);
+    RTC_CATCH_END2(geometry);
+  }
+
   RTC_API void rtcInterpolate(const RTCInterpolateArguments* const args)
   {
     Geometry* geometry = (Geometry*) args->geometry;
@@ -29,14 +29,18 @@ namespace embree
   void invalid_rtcIntersect16() { throw_RTCError(RTC_ERROR_INVALID_OPERATION,"rtcIntersect16 and rtcOccluded16 not enabled"); }
   void invalid_rtcIntersectN()  { throw_RTCError(RTC_ERROR_INVALID_OPERATION,"rtcIntersectN and rtcOccludedN not enabled"); }
 
+  TraversalCounters* getTraversalCounters(Scene* scene) {
+    return scene->device->getTraversalCounters();
+  }
+
   Scene::Scene (Device* device)
-    : device(device),
+    : compressedVertices(false), autoInstances(nullptr), device(device),
       flags_modified(true), enabled_geometry_types(0),
       scene_flags(RTC_SCENE_FLAG_NONE),
       quality_flags(RTC_BUILD_QUALITY_MEDIUM),
       is_build(false), modified(true),
       progressInterface(this), progress_monitor_function(nullptr), progress_monitor_ptr(nullptr), progress_monitor_counter(0), 
-      numIntersectionFiltersN(0)
+      numIntersectionFiltersN(0), numOpacityMicromaps(0)
   {
     device->refInc();
 
@@ -562,6 +566,275 @@ namespace embree
 
   }
   
+#if defined(EMBREE_GEOMETRY_INSTANCE)
+
+  /*! minimal number of primitives of a mesh to get replaced by an instance */
+  static const size_t AUTO_INSTANCE_MIN_PRIMITIVES = 16;
+
+  static __forceinline void getIndices(const TriangleMesh* mesh, size_t i, unsigned int v[4])
+  {
+    const TriangleMesh::Triangle tri = mesh->triangle(i);
+    v[0] = tri.v[0]; v[1] = tri.v[1]; v[2] = tri.v[2]; v[3] = tri.v[2];
+  }
+
+  static __forceinline void getIndices(const QuadMesh* mesh, size_t i, unsigned int v[4])
+  {
+    const QuadMesh::Quad quad = mesh->quad(i);
+    v[0] = quad.v[0]; v[1] = quad.v[1]; v[2] = quad.v[2]; v[3] = quad.v[3];
+  }
+
+  /*! hashes the topology and the shape of a mesh, the vertices
+   *  relative to the first vertex get quantized to a coarse grid such
+   *  that translated copies typically get the same hash despite
+   *  rounding, copies that straddle a grid boundary only miss the
+   *  instancing */
+  template<typename Mesh>
+  static uint64_t hashMesh(const Mesh* mesh)
+  {
+    uint64_t h = 0xcbf29ce484222325ull;
+    auto add = [&] (unsigned int x) { h = (h ^ x) * 0x100000001b3ull; };
+
+    add(mesh->getType());
+    add((unsigned int)mesh->size());
+    add((unsigned int)mesh->numVertices());
+    for (size_t i=0; i<mesh->size(); i++) {
+      unsigned int v[4]; getIndices(mesh,i,v);
+      add(v[0]); add(v[1]); add(v[2]); add(v[3]);
+    }
+
+    const Vec3fa p0 = mesh->vertex(0);
+    BBox3fa bounds = empty;
+    for (size_t i=0; i<mesh->numVertices(); i++) {
+      const Vec3fa d = mesh->vertex(i)-p0;
+      if (likely(isvalid(d))) bounds.extend(d);
+    }
+    const float extent = reduce_max(max(abs(bounds.lower),abs(bounds.upper)));
+    const float scale = extent > 0.0f ? 64.0f*rcp(extent) : 0.0f;
+    for (size_t i=0; i<mesh->numVertices(); i++)
+    {
+      const Vec3fa d = mesh->vertex(i)-p0;
+      if (unlikely(!isvalid(d))) { add(0x7fffffff); continue; }
+      const Vec3fa q = floor(d*scale+Vec3fa(0.5f));
+      add((unsigned int)(int)q.x); add((unsigned int)(int)q.y); add((unsigned int)(int)q.z);
+    }
+    return h;
+  }
+
+  /*! tests if two meshes are identical up to a translation, vertices
+   *  relative to the first vertex may differ by floating point rounding
+   *  as exporters typically bake the translation into the vertices */
+  template<typename Mesh>
+  static bool equalMeshes(const Mesh* a, const Mesh* b)
+  {
+    if (a->size() != b->size() || a->numVertices() != b->numVertices())
+      return false;
+
+    const Vec3fa a0 = a->vertex(0);
+    const Vec3fa b0 = b->vertex(0);
+    const float scale0 = max(reduce_max(abs(a0)),reduce_max(abs(b0)));
+    for (size_t i=0; i<a->numVertices(); i++)
+    {
+      const Vec3fa ai = a->vertex(i);
+      const Vec3fa bi = b->vertex(i);
+      const float eps = 8.0f*float(ulp)*max(scale0,reduce_max(abs(ai)),reduce_max(abs(bi)));
+      if (reduce_max(abs((ai-a0)-(bi-b0))) > eps)
+        return false;
+    }
+
+    for (size_t i=0; i<a->size(); i++) {
+      unsigned int va[4]; getIndices(a,i,va);
+      unsigned int vb[4]; getIndices(b,i,vb);
+      if (va[0] != vb[0] || va[1] != vb[1] || va[2] != vb[2] || va[3] != vb[3])
+        return false;
+    }
+    return true;
+  }
+
+  static __forceinline Vec3fa firstVertex(const Geometry* geom)
+  {
+    if (geom->getType() == Geometry::GTY_TRIANGLE_MESH) return ((const TriangleMesh*)geom)->vertex(0);
+    else                                                 return ((const QuadMesh*)geom)->vertex(0);
+  }
+
+  static __forceinline uint64_t hashGeometry(const Geometry* geom)
+  {
+    if (geom->getType() == Geometry::GTY_TRIANGLE_MESH) return hashMesh((const TriangleMesh*)geom);
+    else                                                 return hashMesh((const QuadMesh*)geom);
+  }
+
+  static __forceinline bool equalGeometries(const Geometry* a, const Geometry* b)
+  {
+    if (a->getType() != b->getType()) return false;
+    if (a->getType() == Geometry::GTY_TRIANGLE_MESH) return equalMeshes((const TriangleMesh*)a,(const TriangleMesh*)b);
+    else                                              return equalMeshes((const QuadMesh*)a,(const QuadMesh*)b);
+  }
+
+  /*! sets a buffer of a geometry to the data of an existing buffer view */
+  static void shareBuffer(Geometry* geom, RTCBufferType type, unsigned int slot, const RawBufferView& view)
+  {
+    if (!view) return;
+    geom->setBuffer(type,slot,view.getFormat(),view.buffer,view.getPtr()-view.buffer->getPtr(),view.getStride(),(unsigned int)view.size());
+  }
+
+  /*! creates a mesh that shares the index and vertex buffers of the specified mesh */
+  static Ref<Geometry> createSharedMesh(Device* device, const Geometry* mesh)
+  {
+    Ref<Geometry> geom;
+    if (mesh->getType() == Geometry::GTY_TRIANGLE_MESH)
+    {
+#if defined(EMBREE_GEOMETRY_TRIANGLE)
+      createTriangleMeshTy createTriangleMesh = nullptr;
+      SELECT_SYMBOL_DEFAULT_AVX_AVX2_AVX512KNL_AVX512SKX(device->enabled_cpu_features,createTriangleMesh);
+      const TriangleMesh* src = (const TriangleMesh*) mesh;
+      geom = createTriangleMesh(device);
+      shareBuffer(geom.ptr,RTC_BUFFER_TYPE_INDEX,0,src->triangles);
+      shareBuffer(geom.ptr,RTC_BUFFER_TYPE_INDEX,1,src->meshletBases);
+      shareBuffer(geom.ptr,RTC_BUFFER_TYPE_VERTEX,0,src->vertices0);
+#endif
+    }
+    else
+    {
+#if defined(EMBREE_GEOMETRY_QUAD)
+      createQuadMeshTy createQuadMesh = nullptr;
+      SELECT_SYMBOL_DEFAULT_AVX_AVX2_AVX512KNL_AVX512SKX(device->enabled_cpu_features,createQuadMesh);
+      const QuadMesh* src = (const QuadMesh*) mesh;
+      geom = createQuadMesh(device);
+      shareBuffer(geom.ptr,RTC_BUFFER_TYPE_INDEX,0,src->quads);
+      shareBuffer(geom.ptr,RTC_BUFFER_TYPE_INDEX,1,src->meshletBases);
+      shareBuffer(geom.ptr,RTC_BUFFER_TYPE_VERTEX,0,src->vertices0);
+#endif
+    }
+    geom->commit();
+    return geom;
+  }
+
+#endif
+
+  std::vector<Geometry*> Scene::getAutoInstanceCandidates()
+  {
+    /* static triangle and quad meshes without filter functions, context filter functions would see the geometry IDs of the prototypes */
+    std::vector<Geometry*> candidates;
+#if defined(EMBREE_GEOMETRY_INSTANCE)
+    if (!isAutoInstancing() || hasContextFilterFunction())
+      return candidates;
+
+    for (size_t i=0; i<geometries.size(); i++)
+    {
+      Geometry* geom = geometries[i].ptr;
+      if (geom == nullptr || !geom->isEnabled()) continue;
+      if (!(geom->getTypeMask() & (Geometry::MTY_TRIANGLE_MESH | Geometry::MTY_QUAD_MESH))) continue;
+      if (geom->numTimeSteps != 1 || geom->size() < AUTO_INSTANCE_MIN_PRIMITIVES) continue;
+      if (geom->hasIntersectionFilter() || geom->hasOcclusionFilter() || geom->hasOpacityFunction() || geom->hasOpacityMicromap()) continue;
+      candidates.push_back(geom);
+    }
+#endif
+    return candidates;
+  }
+
+  bool Scene::autoInstancesModified(const std::vector<Geometry*>& candidates)
+  {
+    if (candidates != autoInstanceCandidates) return true;
+    if (autoInstances && (autoInstances->getSceneFlags() != (scene_flags & ~RTC_SCENE_FLAG_AUTO_INSTANCING) || autoInstances->getBuildQuality() != quality_flags)) return true;
+    for (Geometry* geom : candidates)
+      if (geom->isModified()) return true;
+    return false;
+  }
+
+  void Scene::createAutoInstances(const std::vector<Geometry*>& candidates)
+  {
+#if defined(EMBREE_GEOMETRY_INSTANCE)
+
+    autoInstanceCandidates = candidates;
+
+    /* remove the instances of the previous build */
+    if (autoInstances) {
+      accels.erase(std::find(accels.begin(),accels.end(),(Accel*)autoInstances));
+      delete autoInstances; autoInstances = nullptr;
+    }
+
+    std::vector<bool> wasInstanced(geometries.size());
+    for (size_t i=0; i<geometries.size(); i++) {
+      if (geometries[i] == null) continue;
+      wasInstanced[i] = geometries[i]->instanced;
+      geometries[i]->instanced = false;
+    }
+
+    if (candidates.size() > 1)
+    {
+      /* sort candidates by hash such that duplicates become neighbors */
+      std::vector<std::pair<uint64_t,Geometry*>> hashes(candidates.size());
+      parallel_for(candidates.size(), [&] ( const size_t i ) {
+          hashes[i] = std::make_pair(hashGeometry(candidates[i]),candidates[i]);
+        });
+      std::sort(hashes.begin(),hashes.end(),[] (const std::pair<uint64_t,Geometry*>& a, const std::pair<uint64_t,Geometry*>& b) {
+          return a.first < b.first || (a.first == b.first && a.second->geomID < b.second->geomID);
+        });
+
+      const RTCSceneFlags flags = (RTCSceneFlags)(scene_flags & ~RTC_SCENE_FLAG_AUTO_INSTANCING);
+      createInstanceTy createInstance = nullptr;
+      SELECT_SYMBOL_DEFAULT_AVX_AVX2_AVX512KNL_AVX512SKX(device->enabled_cpu_features,createInstance);
+
+      for (size_t begin=0, end=0; begin<hashes.size(); begin=end)
+      {
+        for (end=begin+1; end<hashes.size() && hashes[end].first == hashes[begin].first; end++);
+
+        /* split meshes of equal hash into groups of identical meshes */
+        std::vector<Geometry*> todo;
+        for (size_t i=begin; i<end; i++) todo.push_back(hashes[i].second);
+        while (todo.size() > 1)
+        {
+          std::vector<Geometry*> group, rest;
+          group.push_back(todo[0]);
+          for (size_t i=1; i<todo.size(); i++) {
+            if (equalGeometries(todo[0],todo[i])) group.push_back(todo[i]);
+            else rest.push_back(todo[i]);
+          }
+          todo.swap(rest);
+          if (group.size() < 2) continue;
+
+          /* build the shared prototype */
+          Ref<Scene> prototype = new Scene(device);
+          prototype->setSceneFlags(flags);
+          prototype->setBuildQuality(quality_flags);
+          prototype->bind(RTC_INVALID_GEOMETRY_ID,createSharedMesh(device,group[0]));
+          prototype->commit_task();
+
+          if (autoInstances == nullptr) {
+            autoInstances = new Scene(device);
+            autoInstances->setSceneFlags(flags);
+            autoInstances->setBuildQuality(quality_flags);
+          }
+
+          /* replace each mesh by a translated instance of the prototype, with the geometry ID of the mesh */
+          const Vec3fa p0 = firstVertex(group[0]);
+          for (Geometry* mesh : group)
+          {
+            Instance* instance = createInstance(device);
+            Ref<Geometry> geom = instance;
+            instance->setInstancedScene(prototype);
+            instance->setTransform(AffineSpace3fa::translate(firstVertex(mesh)-p0),0);
+            instance->setMask(mesh->mask);
+            instance->autoInstance = true;
+            instance->commit();
+            autoInstances->bind(mesh->geomID,geom);
+            mesh->instanced = true;
+          }
+        }
+      }
+
+      if (autoInstances) {
+        autoInstances->commit_task();
+        accels_add(autoInstances);
+      }
+    }
+
+    /* meshes changing between instanced and not instanced have to get rebuilt by two level builders */
+    for (size_t i=0; i<geometries.size(); i++)
+      if (geometries[i] && geometries[i]->instanced != wasInstanced[i])
+        geometries[i]->setModified();
+#endif
+  }
+
   void Scene::clear() {
   }
 
@@ -609,13 +882,28 @@ namespace embree
     is_build = true;
   }
 
+  bool Scene::hasCompressedVertices() const
+  {
+    for (size_t i=0; i<geometries.size(); i++)
+    {
+      const Geometry* geom = geometries[i].ptr;
+      if (geom == nullptr || !geom->isEnabled()) continue;
+      if (geom->getType() == Geometry::GTY_TRIANGLE_MESH && ((const TriangleMesh*)geom)->compressedVertices()) return true;
+      if (geom->getType() == Geometry::GTY_QUAD_MESH     && ((const QuadMesh*    )geom)->compressedVertices()) return true;
+    }
+    return false;
+  }
+
   void Scene::commit_task ()
   {
+    TRACE_SCOPE("commit");
+
     /* print scene statistics */
     if (device->verbosity(2))
       printStatistics();
 
     progress_monitor_counter = 0;
+    buildReport.begin(hasBuildReport());
     
     /* call preCommit function of each geometry */
     parallel_for(geometries.size(), [&] ( const size_t i ) {
@@ -623,11 +911,18 @@ namespace embree
           geometries[i]->preCommit();
       });
     
+    /* test if duplicated meshes have to get replaced again, before all geometries get marked modified below */
+    const std::vector<Geometry*> autoInstanceMeshes = getAutoInstanceCandidates();
+    const bool recreateAutoInstances = autoInstancesModified(autoInstanceMeshes);
+
     /* select acceleration structures to build */
     unsigned int new_enabled_geometry_types = enabledGeometryTypesMask();
     if (flags_modified || new_enabled_geometry_types != enabled_geometry_types)
     {
+      /* the automatic instances get only recreated when their meshes changed */
+      if (autoInstances) accels.erase(std::find(accels.begin(),accels.end(),(Accel*)autoInstances));
       accels_init();
+      if (autoInstances) accels_add(autoInstances);
 
       /* we need to make all geometries modified, otherwise two level builder will 
         not rebuild currently not modified geometries */
@@ -654,6 +949,13 @@ namespace embree
       enabled_geometry_types = new_enabled_geometry_types;
     }
     
+    /* replace duplicated meshes by instances */
+    if (recreateAutoInstances)
+      createAutoInstances(autoInstanceMeshes);
+
+    /* indexed leaves take a slower path if any enabled mesh has compressed vertices */
+    compressedVertices = hasCompressedVertices();
+
     /* select fast code path if no filter function is present */
     accels_select(hasFilterFunction());
   
@@ -680,6 +982,8 @@ namespace embree
       std::cout << "selected scene intersector" << std::endl;
       intersectors.print(2);
     }
+
+    buildReport.end(TaskScheduler::threadCount());
     
     setModified(false);
   }
@@ -719,7 +1023,7 @@ namespace embree
       scheduler = this->scheduler;
       if (scheduler == null) {
         buildLock.lock();
-        this->scheduler = scheduler = new TaskScheduler;
+        this->scheduler = scheduler = new TaskScheduler((scene_flags & RTC_SCENE_FLAG_BACKGROUND_BUILD) ? TaskScheduler::BACKGROUND_BUILD : TaskScheduler::FOREGROUND_BUILD);
       }
     }
 
@@ -811,6 +1115,10 @@ namespace embree
       tbb::task_group_context ctx( tbb::task_group_context::isolated, tbb::task_group_context::default_traits | tbb::task_group_context::fp_settings );
 #endif
       //ctx.set_priority(tbb::priority_high);
+#if __TBB_TASK_PRIORITY
+      if (scene_flags & RTC_SCENE_FLAG_BACKGROUND_BUILD)
+        ctx.set_priority(tbb::priority_low);
+#endif
 
 #if USE_TASK_ARENA
       device->arena->execute([&]{
@@ -54,7 +54,7 @@ namespace embree
       {
         Geometry* geom = scene->geometries[i].ptr;
         if (geom == nullptr) return nullptr;
-        if (!all && !geom->isEnabled()) return nullptr;
+        if (!all && (!geom->isEnabled() || geom->isInstanced())) return nullptr;
         const size_t mask = geom->getTypeMask() & Ty::geom_type; 
         if (!(mask)) return nullptr;
         if ((geom->numTimeSteps != 1) != mblur) return nullptr;
@@ -112,7 +112,7 @@ namespace embree
       {
         Geometry* geom = scene->geometries[i].ptr;
         if (geom == nullptr) return nullptr;
-        if (!geom->isEnabled()) return nullptr;
+        if (!geom->isEnabled() || geom->isInstanced()) return nullptr;
         if (!(geom->getTypeMask() & typemask)) return nullptr;
         if ((geom->numTimeSteps != 1) != mblur) return nullptr;
         return geom;
@@ -161,6 +161,18 @@ namespace embree
     void createGridAccel();
     void createGridMBAccel();
 
+    /*! returns the meshes that may get replaced by automatic instances */
+    std::vector<Geometry*> getAutoInstanceCandidates();
+
+    /*! tests if the candidate meshes or the flags changed since the automatic instances got created */
+    bool autoInstancesModified(const std::vector<Geometry*>& candidates);
+
+    /*! replaces duplicated candidate meshes by instances of shared prototype scenes */
+    void createAutoInstances(const std::vector<Geometry*>& candidates);
+
+    /*! tests if any enabled triangle or quad mesh stores compressed vertices */
+    bool hasCompressedVertices() const;
+
     /*! prints statistics about the scene */
     void printStatistics();
 
@@ -233,6 +245,8 @@ namespace embree
     __forceinline bool isRobustAccel()  const { return scene_flags & RTC_SCENE_FLAG_ROBUST; }
     __forceinline bool isStaticAccel()  const { return !(scene_flags & RTC_SCENE_FLAG_DYNAMIC); }
     __forceinline bool isDynamicAccel() const { return scene_flags & RTC_SCENE_FLAG_DYNAMIC; }
+    __forceinline bool isAutoInstancing() const { return scene_flags & RTC_SCENE_FLAG_AUTO_INSTANCING; }
+    __forceinline bool hasBuildReport() const { return scene_flags & RTC_SCENE_FLAG_BUILD_REPORT; }
     
     __forceinline bool hasContextFilterFunction() const {
       return scene_flags & RTC_SCENE_FLAG_CONTEXT_FILTER_FUNCTION;
@@ -243,6 +257,9 @@ namespace embree
     __forceinline bool hasFilterFunction() {
       return hasContextFilterFunction() || hasGeometryFilterFunction();
     }
+    __forceinline bool hasOpacityMicromaps() const {
+      return numOpacityMicromaps != 0;
+    }
     
     /* test if scene got already build */
     __forceinline bool isBuild() const { return is_build; }
@@ -251,6 +268,9 @@ namespace embree
     IDPool<unsigned,0xFFFFFFFE> id_pool;
     vector<Ref<Geometry>> geometries; //!< list of all user geometries
     vector<float*> vertices;
+    bool compressedVertices; //!< set if an enabled mesh of the last commit has compressed vertices, indexed leaves take a slower path then
+    Scene* autoInstances;    //!< hidden scene of automatically created instances, owned by the accels list
+    std::vector<Geometry*> autoInstanceCandidates; //!< meshes considered when the automatic instances got created
     
   public:
     Device* device;
@@ -293,6 +313,9 @@ namespace embree
     void progressMonitor(double nprims);
     void setProgressMonitorFunction(RTCProgressMonitorFunction func, void* ptr);
 
+  public:
+    BuildReport buildReport; //!< phase timings and memory statistics of the last commit
+
   public:
     struct GeometryCounts 
     {
@@ -352,8 +375,21 @@ namespace embree
       Scene::Iterator<Mesh,mblur> iter(this);
       return iter.maxTimeStepsPerGeometry();
     }
+
+    /* returns true if some user geometry intersects multiple primitives per callback invocation */
+    template<bool mblur>
+    __forceinline bool hasBatchedUserGeometry()
+    {
+      Scene::Iterator<UserGeometry,mblur> iter(this);
+      for (size_t i=0; i<iter.size(); i++) {
+        UserGeometry* geom = iter.at(i);
+        if (geom && (geom->intersectBatched || geom->occludedBatched)) return true;
+      }
+      return false;
+    }
    
     std::atomic<size_t> numIntersectionFiltersN;   //!< number of enabled intersection/occlusion filters for N-wide ray packets
+    std::atomic<size_t> numOpacityMicromaps;       //!< number of enabled geometries with opacity micromaps
   };
 
   template<> __forceinline size_t Scene::getNumPrimitives<TriangleMesh,false>() const { return world.numTriangles; }
@@ -22,7 +22,7 @@ namespace embree
 #if defined(EMBREE_LOWEST_ISA)
 
   Instance::Instance (Device* device, Accel* object, unsigned int numTimeSteps) 
-    : Geometry(device,Geometry::GTY_INSTANCE,1,numTimeSteps), object(object), local2world(nullptr)
+    : Geometry(device,Geometry::GTY_INSTANCE,1,numTimeSteps), object(object), local2world(nullptr), autoInstance(false)
   {
     if (object) object->refInc();
     world2local0 = one;
@@ -35,6 +35,7 @@ namespace embree
   {
     alignedFree(local2world);
     if (object) object->refDec();
+    for (LevelOfDetail& lod : lods) lod.object->refDec();
   }
 
   void Instance::enabling () {
@@ -73,6 +74,37 @@ namespace embree
     if (object) object->refInc();
     Geometry::update();
   }
+
+  void Instance::setInstancedSceneLOD(unsigned int level, const Ref<Scene>& scene, float distance, float blendRange)
+  {
+    if (level == 0 || level > lods.size()+1)
+      throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"invalid level of detail");
+
+    /* passing no scene removes this and all coarser levels of detail */
+    if (!scene) {
+      for (size_t i=level-1; i<lods.size(); i++) lods[i].object->refDec();
+      lods.resize(level-1);
+      Geometry::update();
+      return;
+    }
+
+    if (!(distance >= 0.0f) || !(blendRange >= 0.0f))
+      throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"invalid level of detail distance");
+    if (level > 1 && distance < lods[level-2].distance)
+      throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"level of detail distances have to increase");
+
+    LevelOfDetail lod;
+    lod.object = scene.ptr;
+    lod.distance = distance;
+    lod.blendRange = blendRange;
+    lod.object->refInc();
+    if (level-1 < lods.size()) {
+      lods[level-1].object->refDec();
+      lods[level-1] = lod;
+    } else
+      lods.push_back(lod);
+    Geometry::update();
+  }
   
   void Instance::setTransform(const AffineSpace3fa& xfm, unsigned int timeStep)
   {
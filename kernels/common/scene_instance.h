@@ -40,6 +40,7 @@ namespace embree
     virtual void disabling();
     virtual void setNumTimeSteps (unsigned int numTimeSteps);
     virtual void setInstancedScene(const Ref<Scene>& scene);
+    virtual void setInstancedSceneLOD(unsigned int level, const Ref<Scene>& scene, float distance, float blendRange);
     virtual void setTransform(const AffineSpace3fa& local2world, unsigned int timeStep);
     virtual AffineSpace3fa getTransform(float time);
     virtual void setMask (unsigned mask);
@@ -47,16 +48,32 @@ namespace embree
 
   public:
 
+    /*! calculates the bounds of all levels of detail of the instanced scene */
+    __forceinline BBox3fa objectBounds() const
+    {
+      BBox3fa b = object->bounds.bounds();
+      for (const LevelOfDetail& lod : lods) b.extend(lod.object->bounds.bounds());
+      return b;
+    }
+
+    /*! calculates the bounds of all levels of detail of the instanced scene at time t */
+    __forceinline BBox3fa objectBounds(float t) const
+    {
+      BBox3fa b = object->getBounds(t);
+      for (const LevelOfDetail& lod : lods) b.extend(lod.object->getBounds(t));
+      return b;
+    }
+
      /*! calculates the bounds of instance */
     __forceinline BBox3fa bounds(size_t i) const {
       assert(i == 0);
-      return xfmBounds(local2world[0],object->bounds.bounds());
+      return xfmBounds(local2world[0],objectBounds());
     }
 
      /*! calculates the bounds of instance */
     __forceinline BBox3fa bounds(size_t i, size_t itime) const {
       assert(i == 0);
-      return xfmBounds(local2world[itime],object->getBounds(float(itime)/fnumTimeSegments));
+      return xfmBounds(local2world[itime],objectBounds(float(itime)/fnumTimeSegments));
     }
 
      /*! calculates the linear bounds at the itimeGlobal'th time segment */
@@ -81,6 +98,56 @@ namespace embree
       return true;
     }
       
+    /*! returns true if the instance has several levels of detail */
+    __forceinline bool hasLODs() const {
+      return !lods.empty();
+    }
+
+    /*! returns the instanced scene of some level of detail */
+    __forceinline Accel* getLOD(unsigned int level) const {
+      return level == 0 ? object : lods[level-1].object;
+    }
+
+    /*! returns a pseudo random number in [0,1) that is constant for a
+     *  ray ID and instance, rays without ID (ID 0) hash their origin and
+     *  direction instead as otherwise all of them would select the same
+     *  level */
+    __forceinline float lodRandom(unsigned int rayID, const Vec3fa& ray_org, const Vec3fa& ray_dir) const
+    {
+      unsigned int key = rayID;
+      if (key == 0) {
+        const float v[6] = { ray_org.x, ray_org.y, ray_org.z, ray_dir.x, ray_dir.y, ray_dir.z };
+        for (size_t i=0; i<6; i++) {
+          unsigned int bits; memcpy(&bits,&v[i],sizeof(bits));
+          key = (key ^ bits) * 0x01000193u;
+        }
+      }
+      unsigned int h = key ^ (geomID * 0x9E3779B9u);
+      h ^= h >> 16; h *= 0x7FEB352Du;
+      h ^= h >> 15; h *= 0x846CA68Bu;
+      h ^= h >> 16;
+      return float(h >> 8) * (1.0f/16777216.0f);
+    }
+
+    /*! selects the level of detail for a ray from the distance of its
+     *  origin (or the apex of its ray cone) to the center of the
+     *  instance, switching levels stochastically inside the blend ranges */
+    __forceinline unsigned int selectLOD(const AffineSpace3fa& local2world, const Vec3fa& ray_org, const Vec3fa& ray_dir, unsigned int rayID, const RTCRayCone* cone) const
+    {
+      float d = length(xfmPoint(local2world,center(object->bounds.bounds()))-ray_org);
+      if (cone && cone->spreadAngle > 0.0f) d += cone->width*rcp(cone->spreadAngle);
+      const float u = lodRandom(rayID,ray_org,ray_dir)-0.5f;
+      for (size_t i=lods.size(); i>0; i--)
+        if (d >= lods[i-1].distance + u*lods[i-1].blendRange) return unsigned(i);
+      return 0;
+    }
+
+    /*! returns the instance ID reported for hits inside the instanced
+     *  scene, automatic instances keep the ID of an enclosing instance */
+    __forceinline unsigned int hitInstID(unsigned int outerInstID) const {
+      return autoInstance ? outerInstID : geomID;
+    }
+
     __forceinline AffineSpace3fa getLocal2World() const {
       return local2world[0];
     }
@@ -124,9 +191,19 @@ namespace embree
     }
     
   public:
+    /*! coarser level of detail of the instanced scene */
+    struct LevelOfDetail
+    {
+      Accel* object;               //!< pointer to instanced acceleration structure of this level
+      float distance;              //!< distance from which on this level is used
+      float blendRange;            //!< width of the range around the distance in which levels are blended
+    };
+
     Accel* object;                 //!< pointer to instanced acceleration structure
+    vector<LevelOfDetail> lods;    //!< coarser levels of detail, ordered by increasing distance
     AffineSpace3fa* local2world;   //!< transformation from local space to world space for each timestep
     AffineSpace3fa world2local0;   //!< transformation from world space to local space for timestep 0
+    bool autoInstance;             //!< true if instance replaces a duplicated mesh, hits then report the geomID of the instance
   };
 
   namespace isa
@@ -59,13 +59,16 @@ namespace embree
   
   void QuadMesh::setBuffer(RTCBufferType type, unsigned int slot, RTCFormat format, const Ref<Buffer>& buffer, size_t offset, size_t stride, unsigned int num)
   { 
-    /* verify that all accesses are 4 bytes aligned */
-    if (((size_t(buffer->getPtr()) + offset) & 0x3) || (stride & 0x3)) 
-      throw_RTCError(RTC_ERROR_INVALID_OPERATION, "data must be 4 bytes aligned");
+    /* verify that all accesses are 4 bytes aligned, compressed vertices and 16 bit indices only need 2 bytes alignment */
+    const bool compressed = (type == RTC_BUFFER_TYPE_VERTEX && (format == RTC_FORMAT_HALF3 || format == RTC_FORMAT_USHORT3))
+                         || (type == RTC_BUFFER_TYPE_INDEX  && format == RTC_FORMAT_USHORT4);
+    const size_t align = compressed ? 0x1 : 0x3;
+    if (((size_t(buffer->getPtr()) + offset) & align) || (stride & align)) 
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION, compressed ? "data must be 2 bytes aligned" : "data must be 4 bytes aligned");
 
     if (type == RTC_BUFFER_TYPE_VERTEX) 
     {
-      if (format != RTC_FORMAT_FLOAT3)
+      if (format != RTC_FORMAT_FLOAT3 && !compressed)
         throw_RTCError(RTC_ERROR_INVALID_OPERATION, "invalid vertex buffer format");
 
       /* if buffer is larger than 16GB the premultiplied index optimization does not work */
@@ -76,7 +79,7 @@ namespace embree
         throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "invalid vertex buffer slot");
 
       vertices[slot].set(buffer, offset, stride, num, format);
-      vertices[slot].checkPadding16();
+      if (!compressed) vertices[slot].checkPadding16();
       vertices0 = vertices[0];
     } 
     else if (type >= RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE)
@@ -92,13 +95,23 @@ namespace embree
     }
     else if (type == RTC_BUFFER_TYPE_INDEX)
     {
-      if (slot != 0)
-        throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "invalid buffer slot");
-      if (format != RTC_FORMAT_UINT4)
-        throw_RTCError(RTC_ERROR_INVALID_OPERATION, "invalid index buffer format");
+      if (slot == 0)
+      {
+        if (format != RTC_FORMAT_UINT4 && format != RTC_FORMAT_USHORT4)
+          throw_RTCError(RTC_ERROR_INVALID_OPERATION, "invalid index buffer format");
+
+        quads.set(buffer, offset, stride, num, format);
+        setNumPrimitives(num);
+      }
+      else if (slot == 1)
+      {
+        if (format != RTC_FORMAT_UINT)
+          throw_RTCError(RTC_ERROR_INVALID_OPERATION, "invalid meshlet base buffer format");
 
-      quads.set(buffer, offset, stride, num, format);
-      setNumPrimitives(num);
+        meshletBases.set(buffer, offset, stride, num, format);
+      }
+      else
+        throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "invalid buffer slot");
     }
     else
       throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "unknown buffer type");
@@ -108,9 +121,9 @@ namespace embree
   {
     if (type == RTC_BUFFER_TYPE_INDEX)
     {
-      if (slot != 0)
+      if (slot > 1)
         throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "invalid buffer slot");
-      return quads.getPtr();
+      return slot == 0 ? quads.getPtr() : meshletBases.getPtr();
     }
     else if (type == RTC_BUFFER_TYPE_VERTEX)
     {
@@ -135,9 +148,10 @@ namespace embree
   {
     if (type == RTC_BUFFER_TYPE_INDEX)
     {
-      if (slot != 0)
+      if (slot > 1)
         throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "invalid buffer slot");
-      quads.setModified(true);
+      if (slot == 0) quads.setModified(true);
+      else           meshletBases.setModified(true);
     }
     else if (type == RTC_BUFFER_TYPE_VERTEX)
     {
@@ -166,6 +180,15 @@ namespace embree
       if (vertices[t].getStride() != vertices[0].getStride())
         throw_RTCError(RTC_ERROR_INVALID_OPERATION,"stride of vertex buffers have to be identical for each time step");
 
+    /* verify that format of all time steps are identical */
+    for (unsigned int t=0; t<numTimeSteps; t++)
+      if (vertices[t].getFormat() != vertices[0].getFormat())
+        throw_RTCError(RTC_ERROR_INVALID_OPERATION,"format of vertex buffers have to be identical for each time step");
+
+    /* verify that there is a base vertex for each meshlet of a 16 bit index buffer */
+    if (shortIndices() && meshletBases && meshletBases.size() < (size()+MESHLET_SIZE-1)/MESHLET_SIZE)
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"meshlet base buffer too small");
+
     Geometry::preCommit();
   }
 
@@ -174,6 +197,7 @@ namespace embree
     scene->vertices[geomID] = (float*) vertices0.getPtr();
 
     quads.setModified(false);
+    meshletBases.setModified(false);
     for (auto& buf : vertices)
       buf.setModified(false);
     for (auto& attrib : vertexAttribs)
@@ -192,21 +216,41 @@ namespace embree
 
     /*! verify quad indices */
     for (size_t i=0; i<size(); i++) {     
-      if (quads[i].v[0] >= numVertices()) return false; 
-      if (quads[i].v[1] >= numVertices()) return false; 
-      if (quads[i].v[2] >= numVertices()) return false; 
-      if (quads[i].v[3] >= numVertices()) return false; 
+      const Quad q = quad(i);
+      if (q.v[0] >= numVertices()) return false; 
+      if (q.v[1] >= numVertices()) return false; 
+      if (q.v[2] >= numVertices()) return false; 
+      if (q.v[3] >= numVertices()) return false; 
     }
 
-    /*! verify vertices */
-    for (const auto& buffer : vertices)
-      for (size_t i=0; i<buffer.size(); i++)
-	if (!isvalid(buffer[i])) 
+    /*! verify vertices, compressed vertices get decoded */
+    for (size_t t=0; t<vertices.size(); t++)
+      for (size_t i=0; i<vertices[t].size(); i++)
+	if (!isvalid(vertex(i,t))) 
 	  return false;
 
     return true;
   }
 
+  bool QuadMesh::prefetchPrimRefs(const range<size_t>& r) const
+  {
+    bool mapped = quads.isMapped();
+    for (const auto& buffer : vertices)
+      mapped |= buffer.isMapped();
+    if (!mapped) return false;
+
+    quads.prefetch(r.begin(),r.end());
+
+    /* reading the indices would fault the pages in synchronously, thus
+     * we guess the referenced vertex range assuming vertices are stored
+     * in about the order they are referenced */
+    const size_t v0 = r.begin()*numVertices()/size();
+    const size_t v1 = min((r.end()*numVertices()+size()-1)/size(),numVertices());
+    for (const auto& buffer : vertices)
+      buffer.prefetch(v0,v1);
+    return true;
+  }
+
   void QuadMesh::interpolate(const RTCInterpolateArguments* const args)
   {
     unsigned int primID = args->primID;
@@ -235,15 +279,24 @@ namespace embree
       stride = vertices[bufferSlot].getStride();
     }
 
+    /* compressed vertices get decoded, they only provide 3 values */
+    const bool decode = bufferType == RTC_BUFFER_TYPE_VERTEX && compressedVertices();
+    if (unlikely(decode && valueCount > 3))
+      throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"at most 3 values can get interpolated from compressed vertices");
+    auto load = [&] (const vbool4& valid, unsigned int vtx, size_t ofs) -> vfloat4 {
+      if (unlikely(decode)) return (vfloat4) vertices[bufferSlot].decode(vtx);
+      return vfloat4::loadu(valid,(float*)&src[vtx*stride+ofs]);
+    };
+
     for (unsigned int i=0; i<valueCount; i+=4)
     {
       const vbool4 valid = vint4((int)i)+vint4(step) < vint4(int(valueCount));
       const size_t ofs = i*sizeof(float);
       const Quad& tri = quad(primID);
-      const vfloat4 p0 = vfloat4::loadu(valid,(float*)&src[tri.v[0]*stride+ofs]);
-      const vfloat4 p1 = vfloat4::loadu(valid,(float*)&src[tri.v[1]*stride+ofs]);
-      const vfloat4 p2 = vfloat4::loadu(valid,(float*)&src[tri.v[2]*stride+ofs]);
-      const vfloat4 p3 = vfloat4::loadu(valid,(float*)&src[tri.v[3]*stride+ofs]);      
+      const vfloat4 p0 = load(valid,tri.v[0],ofs);
+      const vfloat4 p1 = load(valid,tri.v[1],ofs);
+      const vfloat4 p2 = load(valid,tri.v[2],ofs);
+      const vfloat4 p3 = load(valid,tri.v[3],ofs);      
       const vbool4 left = u+v <= 1.0f;
       const vfloat4 Q0 = select(left,p0,p2);
       const vfloat4 Q1 = select(left,p1,p3);
@@ -26,6 +26,9 @@ namespace embree
   {
     /*! type of this geometry */
     static const Geometry::GTypeMask geom_type = Geometry::MTY_QUAD_MESH;
+
+    /*! number of consecutive quads sharing a base vertex when using 16 bit indices */
+    static const size_t MESHLET_SIZE = 64;
     
     /*! triangle indices */
     struct Quad
@@ -56,6 +59,7 @@ namespace embree
     void preCommit();
     void postCommit();
     bool verify();
+    bool prefetchPrimRefs(const range<size_t>& r) const;
     void interpolate(const RTCInterpolateArguments* const args);
 
   public:
@@ -66,12 +70,32 @@ namespace embree
     }
     
     /*! returns i'th quad */
-    __forceinline const Quad& quad(size_t i) const {
+    __forceinline Quad quad(size_t i) const {
+      if (unlikely(shortIndices())) return decodeQuad(i);
       return quads[i];
     }
 
+    /*! returns true if the indices are stored as RTC_FORMAT_USHORT4 */
+    __forceinline bool shortIndices() const {
+      return quads.getFormat() == RTC_FORMAT_USHORT4;
+    }
+
+    /*! decodes the i'th quad of a 16 bit index buffer by adding the base vertex of its meshlet */
+    __forceinline Quad decodeQuad(size_t i) const
+    {
+      const unsigned short* idx = (const unsigned short*) quads.getPtr(i);
+      const unsigned int base = meshletBases ? meshletBases[i/MESHLET_SIZE] : 0;
+      Quad q;
+      q.v[0] = base + idx[0];
+      q.v[1] = base + idx[1];
+      q.v[2] = base + idx[2];
+      q.v[3] = base + idx[3];
+      return q;
+    }
+
     /*! returns i'th vertex of itime'th timestep */
     __forceinline const Vec3fa vertex(size_t i) const {
+      if (unlikely(compressedVertices())) return vertices0.decode(i);
       return vertices0[i];
     }
 
@@ -82,9 +106,26 @@ namespace embree
 
     /*! returns i'th vertex of itime'th timestep */
     __forceinline const Vec3fa vertex(size_t i, size_t itime) const {
+      if (unlikely(compressedVertices())) return vertices[itime].decode(i);
       return vertices[itime][i];
     }
 
+    /*! returns true if the vertices are stored as RTC_FORMAT_HALF3 or RTC_FORMAT_USHORT3 */
+    __forceinline bool compressedVertices() const {
+      return vertices0.getFormat() == RTC_FORMAT_HALF3 || vertices0.getFormat() == RTC_FORMAT_USHORT3;
+    }
+
+    /*! returns the vertex offset multiplier used by indexed leaves */
+    __forceinline unsigned int leafVertexStride() const {
+      return compressedVertices() ? 1 : vertices0.getStride()/4;
+    }
+
+    /*! returns the vertex referenced by an offset stored in an indexed leaf */
+    __forceinline const Vec3fa leafVertex(unsigned int ofs, size_t itime) const {
+      if (unlikely(compressedVertices())) return vertices[itime].decode(ofs);
+      return Vec3fa::loadu((const float*)vertexPtr(0,itime)+ofs);
+    }
+
     /*! returns i'th vertex of itime'th timestep */
     __forceinline const char* vertexPtr(size_t i, size_t itime) const {
       return vertices[itime].getPtr(i);
@@ -207,11 +248,12 @@ namespace embree
 
     /* returns true if topology changed */
     bool topologyChanged() const {
-      return quads.isModified() || numPrimitivesChanged;
+      return quads.isModified() || meshletBases.isModified() || numPrimitivesChanged;
     }
 
   public:
     BufferView<Quad> quads;                 //!< array of quads
+    BufferView<unsigned int> meshletBases;  //!< base vertex of each meshlet for 16 bit indices
     BufferView<Vec3fa> vertices0;           //!< fast access to first vertex buffer
     vector<BufferView<Vec3fa>> vertices;    //!< vertex array for each timestep
     vector<BufferView<char>> vertexAttribs; //!< vertex attribute buffers
@@ -914,6 +914,86 @@ namespace embree
       }
     }
     
+    void SubdivMeshISA::interpolateSortedN(const int* valid, const unsigned* primIDs, const float* u, const float* v, const size_t N,
+                                           const char* src, const size_t stride, std::vector<SharedLazyTessellationCache::CacheEntry>& baseEntry, const Topology& topo,
+                                           float* P, float* dPdu, float* dPdv, float* ddPdudu, float* ddPdvdv, float* ddPdudv, const unsigned int valueCount)
+    {
+      /* sort all valid samples by primID, the sample index is kept in the lower bits */
+      dynamic_large_stack_array(uint64_t,sample_array,N,1024*sizeof(uint64_t));
+      uint64_t* samples = sample_array;
+      size_t numSamples = 0;
+      for (size_t i=0; i<N; i++) {
+        if (valid && valid[i] != -1) continue;
+        samples[numSamples++] = (uint64_t(primIDs[i]) << 32) | uint64_t(i);
+      }
+
+      /* typical batches are sorted serially on the calling thread, only very large ones use the parallel radix sort */
+      if (numSamples <= 8192)
+        std::sort(samples,samples+numSamples);
+      else {
+        std::vector<uint64_t> temp(numSamples);
+        radix_sort_u64(samples,temp.data(),numSamples);
+      }
+
+      /* results of one SIMD evaluation are stored with stride 4 before scattered to the output arrays */
+      dynamic_large_stack_array(float,Pt,P ? 4*valueCount : 0,4*256*sizeof(float));
+      dynamic_large_stack_array(float,dPdut,dPdu ? 4*valueCount : 0,4*256*sizeof(float));
+      dynamic_large_stack_array(float,dPdvt,dPdv ? 4*valueCount : 0,4*256*sizeof(float));
+      dynamic_large_stack_array(float,ddPdudut,ddPdudu ? 4*valueCount : 0,4*256*sizeof(float));
+      dynamic_large_stack_array(float,ddPdvdvt,ddPdvdv ? 4*valueCount : 0,4*256*sizeof(float));
+      dynamic_large_stack_array(float,ddPdudvt,ddPdudv ? 4*valueCount : 0,4*256*sizeof(float));
+
+      for (size_t i=0; i<numSamples; i+=4)
+      {
+        const size_t n = min(size_t(4),numSamples-i);
+        unsigned index[4], primID_i[4];
+        float u_i[4], v_i[4];
+        for (size_t k=0; k<4; k++) {
+          const uint64_t sample = samples[i+min(k,n-1)];
+          index[k] = unsigned(sample);
+          primID_i[k] = unsigned(sample >> 32);
+          u_i[k] = u[index[k]];
+          v_i[k] = v[index[k]];
+        }
+        const vbool4 valid1 = vint4(step) < vint4(int(n));
+        const vuint4 primID = vuint4::loadu(primID_i);
+        const vfloat4 uu = vfloat4::loadu(u_i);
+        const vfloat4 vv = vfloat4::loadu(v_i);
+
+        foreach_unique(valid1,primID,[&](const vbool4& valid1, const unsigned int primID)
+                       {
+                         for (unsigned int j=0; j<valueCount; j+=4)
+                         {
+                           const size_t M = min(4u,valueCount-j);
+                           isa::PatchEvalSimd<vbool4,vint4,vfloat4,vfloat4>(baseEntry.at(interpolationSlot(primID,j/4,stride)),commitCounter,
+                                                                            topo.getHalfEdge(primID),src+j*sizeof(float),stride,valid1,uu,vv,
+                                                                            P ? Pt+j*4 : nullptr,
+                                                                            dPdu ? dPdut+j*4 : nullptr,
+                                                                            dPdv ? dPdvt+j*4 : nullptr,
+                                                                            ddPdudu ? ddPdudut+j*4 : nullptr,
+                                                                            ddPdvdv ? ddPdvdvt+j*4 : nullptr,
+                                                                            ddPdudv ? ddPdudvt+j*4 : nullptr,
+                                                                            4,M);
+                         }
+                       });
+
+        /* scatter results back into the original sample order */
+        for (size_t k=0; k<n; k++)
+        {
+          for (size_t j=0; j<valueCount; j++)
+          {
+            const size_t dst = j*N+index[k];
+            if (P) P[dst] = Pt[j*4+k];
+            if (dPdu) dPdu[dst] = dPdut[j*4+k];
+            if (dPdv) dPdv[dst] = dPdvt[j*4+k];
+            if (ddPdudu) ddPdudu[dst] = ddPdudut[j*4+k];
+            if (ddPdvdv) ddPdvdv[dst] = ddPdvdvt[j*4+k];
+            if (ddPdudv) ddPdudv[dst] = ddPdudvt[j*4+k];
+          }
+        }
+      }
+    }
+
     void SubdivMeshISA::interpolateN(const RTCInterpolateNArguments* const args)
     {
       const void* valid_i = args->valid;
@@ -954,6 +1034,13 @@ namespace embree
       }
       
       const int* valid = (const int*) valid_i;
+
+      /* large batches get sorted by face, such that all samples of a face
+       * are evaluated together in SIMD using the same cached patch */
+      if (N > 64) {
+        interpolateSortedN(valid,primIDs,u,v,N,src,stride,*baseEntry,*topo,P,dPdu,dPdv,ddPdudu,ddPdvdv,ddPdudv,valueCount);
+        return;
+      }
       
       for (size_t i=0; i<N; i+=4) 
       {
@@ -333,6 +333,13 @@ namespace embree
 
       void interpolate(const RTCInterpolateArguments* const args);
       void interpolateN(const RTCInterpolateNArguments* const args);
+
+    private:
+
+      /*! interpolates large batches of samples grouped by face */
+      void interpolateSortedN(const int* valid, const unsigned* primIDs, const float* u, const float* v, const size_t N,
+                              const char* src, const size_t stride, std::vector<SharedLazyTessellationCache::CacheEntry>& baseEntry, const Topology& topo,
+                              float* P, float* dPdu, float* dPdv, float* ddPdudu, float* ddPdvdv, float* ddPdudv, const unsigned int valueCount);
     };
   }
 
@@ -22,7 +22,7 @@ namespace embree
 #if defined(EMBREE_LOWEST_ISA)
 
   TriangleMesh::TriangleMesh (Device* device)
-    : Geometry(device,GTY_TRIANGLE_MESH,0,1)
+    : Geometry(device,GTY_TRIANGLE_MESH,0,1), micromapLevel(0)
   {
     vertices.resize(numTimeSteps);
   }
@@ -59,13 +59,16 @@ namespace embree
   
   void TriangleMesh::setBuffer(RTCBufferType type, unsigned int slot, RTCFormat format, const Ref<Buffer>& buffer, size_t offset, size_t stride, unsigned int num)
   {
-    /* verify that all accesses are 4 bytes aligned */
-    if (((size_t(buffer->getPtr()) + offset) & 0x3) || (stride & 0x3)) 
-      throw_RTCError(RTC_ERROR_INVALID_OPERATION, "data must be 4 bytes aligned");
+    /* verify that all accesses are 4 bytes aligned, compressed vertices and 16 bit indices only need 2 bytes alignment */
+    const bool compressed = (type == RTC_BUFFER_TYPE_VERTEX && (format == RTC_FORMAT_HALF3 || format == RTC_FORMAT_USHORT3))
+                         || (type == RTC_BUFFER_TYPE_INDEX  && format == RTC_FORMAT_USHORT3);
+    const size_t align = compressed ? 0x1 : 0x3;
+    if (type != RTC_BUFFER_TYPE_OPACITY_MICROMAP && (((size_t(buffer->getPtr()) + offset) & align) || (stride & align)))
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION, compressed ? "data must be 2 bytes aligned" : "data must be 4 bytes aligned");
 
     if (type == RTC_BUFFER_TYPE_VERTEX)
     {
-      if (format != RTC_FORMAT_FLOAT3)
+      if (format != RTC_FORMAT_FLOAT3 && !compressed)
         throw_RTCError(RTC_ERROR_INVALID_OPERATION, "invalid vertex buffer format");
 
       /* if buffer is larger than 16GB the premultiplied index optimization does not work */
@@ -76,7 +79,7 @@ namespace embree
         throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "invalid vertex buffer slot");
 
       vertices[slot].set(buffer, offset, stride, num, format);
-      vertices[slot].checkPadding16();
+      if (!compressed) vertices[slot].checkPadding16();
       vertices0 = vertices[0];
     }
     else if (type == RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE)
@@ -91,14 +94,41 @@ namespace embree
       vertexAttribs[slot].checkPadding16();
     }
     else if (type == RTC_BUFFER_TYPE_INDEX)
+    {
+      if (slot == 0)
+      {
+        if (format != RTC_FORMAT_UINT3 && format != RTC_FORMAT_USHORT3)
+          throw_RTCError(RTC_ERROR_INVALID_OPERATION, "invalid index buffer format");
+
+        triangles.set(buffer, offset, stride, num, format);
+        setNumPrimitives(num);
+      }
+      else if (slot == 1)
+      {
+        if (format != RTC_FORMAT_UINT)
+          throw_RTCError(RTC_ERROR_INVALID_OPERATION, "invalid meshlet base buffer format");
+
+        meshletBases.set(buffer, offset, stride, num, format);
+      }
+      else
+        throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "invalid buffer slot");
+    }
+    else if (type == RTC_BUFFER_TYPE_OPACITY_MICROMAP)
     {
       if (slot != 0)
         throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "invalid buffer slot");
-      if (format != RTC_FORMAT_UINT3)
-        throw_RTCError(RTC_ERROR_INVALID_OPERATION, "invalid index buffer format");
 
-      triangles.set(buffer, offset, stride, num, format);
-      setNumPrimitives(num);
+      /* the format selects the subdivision level, storing 4^level bits per triangle */
+      switch (format) {
+      case RTC_FORMAT_UCHAR  : micromapLevel = 1; break;
+      case RTC_FORMAT_USHORT : micromapLevel = 2; break;
+      case RTC_FORMAT_ULLONG : micromapLevel = 3; break;
+      case RTC_FORMAT_ULLONG4: micromapLevel = 4; break;
+      default: throw_RTCError(RTC_ERROR_INVALID_OPERATION, "invalid opacity micromap buffer format");
+      }
+
+      opacityMicromap.set(buffer, offset, stride, num, format);
+      setOpacityMicromap(true);
     }
     else 
       throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "unknown buffer type");
@@ -108,9 +138,9 @@ namespace embree
   {
     if (type == RTC_BUFFER_TYPE_INDEX)
     {
-      if (slot != 0)
+      if (slot > 1)
         throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "invalid buffer slot");
-      return triangles.getPtr();
+      return slot == 0 ? triangles.getPtr() : meshletBases.getPtr();
     }
     else if (type == RTC_BUFFER_TYPE_VERTEX)
     {
@@ -124,6 +154,12 @@ namespace embree
         throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "invalid buffer slot");
       return vertexAttribs[slot].getPtr();
     }
+    else if (type == RTC_BUFFER_TYPE_OPACITY_MICROMAP)
+    {
+      if (slot != 0)
+        throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "invalid buffer slot");
+      return opacityMicromap.getPtr();
+    }
     else
     {
       throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "unknown buffer type");
@@ -135,9 +171,10 @@ namespace embree
   {
     if (type == RTC_BUFFER_TYPE_INDEX)
     {
-      if (slot != 0)
+      if (slot > 1)
         throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "invalid buffer slot");
-      triangles.setModified(true);
+      if (slot == 0) triangles.setModified(true);
+      else           meshletBases.setModified(true);
     }
     else if (type == RTC_BUFFER_TYPE_VERTEX)
     {
@@ -151,6 +188,12 @@ namespace embree
         throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "invalid buffer slot");
       vertexAttribs[slot].setModified(true);
     }
+    else if (type == RTC_BUFFER_TYPE_OPACITY_MICROMAP)
+    {
+      if (slot != 0)
+        throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "invalid buffer slot");
+      opacityMicromap.setModified(true);
+    }
     else
     {
       throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "unknown buffer type");
@@ -166,6 +209,19 @@ namespace embree
       if (vertices[t].getStride() != vertices[0].getStride())
         throw_RTCError(RTC_ERROR_INVALID_OPERATION,"stride of vertex buffers have to be identical for each time step");
 
+    /* verify that format of all time steps are identical */
+    for (unsigned int t=0; t<numTimeSteps; t++)
+      if (vertices[t].getFormat() != vertices[0].getFormat())
+        throw_RTCError(RTC_ERROR_INVALID_OPERATION,"format of vertex buffers have to be identical for each time step");
+
+    /* verify that there is a base vertex for each meshlet of a 16 bit index buffer */
+    if (shortIndices() && meshletBases && meshletBases.size() < (size()+MESHLET_SIZE-1)/MESHLET_SIZE)
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"meshlet base buffer too small");
+
+    /* verify that there is an opacity micromap for each triangle */
+    if (opacityMicromap && opacityMicromap.size() < size())
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"opacity micromap buffer too small");
+
     Geometry::preCommit();
   }
 
@@ -174,6 +230,8 @@ namespace embree
     scene->vertices[geomID] = (float*) vertices0.getPtr();
 
     triangles.setModified(false);
+    meshletBases.setModified(false);
+    opacityMicromap.setModified(false);
     for (auto& buf : vertices)
       buf.setModified(false);
     for (auto& attrib : vertexAttribs)
@@ -197,20 +255,40 @@ namespace embree
 
     /*! verify triangle indices */
     for (size_t i=0; i<size(); i++) {     
-      if (triangles[i].v[0] >= numVertices()) return false; 
-      if (triangles[i].v[1] >= numVertices()) return false; 
-      if (triangles[i].v[2] >= numVertices()) return false; 
+      const Triangle t = triangle(i);
+      if (t.v[0] >= numVertices()) return false; 
+      if (t.v[1] >= numVertices()) return false; 
+      if (t.v[2] >= numVertices()) return false; 
     }
 
-    /*! verify vertices */
-    for (const auto& buffer : vertices)
-      for (size_t i=0; i<buffer.size(); i++)
-	if (!isvalid(buffer[i])) 
+    /*! verify vertices, compressed vertices get decoded */
+    for (size_t t=0; t<vertices.size(); t++)
+      for (size_t i=0; i<vertices[t].size(); i++)
+	if (!isvalid(vertex(i,t))) 
 	  return false;
 
     return true;
   }
   
+  bool TriangleMesh::prefetchPrimRefs(const range<size_t>& r) const
+  {
+    bool mapped = triangles.isMapped();
+    for (const auto& buffer : vertices)
+      mapped |= buffer.isMapped();
+    if (!mapped) return false;
+
+    triangles.prefetch(r.begin(),r.end());
+
+    /* reading the indices would fault the pages in synchronously, thus
+     * we guess the referenced vertex range assuming vertices are stored
+     * in about the order they are referenced */
+    const size_t v0 = r.begin()*numVertices()/size();
+    const size_t v1 = min((r.end()*numVertices()+size()-1)/size(),numVertices());
+    for (const auto& buffer : vertices)
+      buffer.prefetch(v0,v1);
+    return true;
+  }
+
   void TriangleMesh::interpolate(const RTCInterpolateArguments* const args)
   {
     unsigned int primID = args->primID;
@@ -238,6 +316,15 @@ namespace embree
       src    = vertices[bufferSlot].getPtr();
       stride = vertices[bufferSlot].getStride();
     }
+
+    /* compressed vertices get decoded, they only provide 3 values */
+    const bool decode = bufferType == RTC_BUFFER_TYPE_VERTEX && compressedVertices();
+    if (unlikely(decode && valueCount > 3))
+      throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"at most 3 values can get interpolated from compressed vertices");
+    auto load = [&] (const vbool4& valid, unsigned int vtx, size_t ofs) -> vfloat4 {
+      if (unlikely(decode)) return (vfloat4) vertices[bufferSlot].decode(vtx);
+      return vfloat4::loadu(valid,(float*)&src[vtx*stride+ofs]);
+    };
     
     for (unsigned int i=0; i<valueCount; i+=4)
     {
@@ -245,9 +332,9 @@ namespace embree
       const float w = 1.0f-u-v;
       const Triangle& tri = triangle(primID);
       const vbool4 valid = vint4((int)i)+vint4(step) < vint4(int(valueCount));
-      const vfloat4 p0 = vfloat4::loadu(valid,(float*)&src[tri.v[0]*stride+ofs]);
-      const vfloat4 p1 = vfloat4::loadu(valid,(float*)&src[tri.v[1]*stride+ofs]);
-      const vfloat4 p2 = vfloat4::loadu(valid,(float*)&src[tri.v[2]*stride+ofs]);
+      const vfloat4 p0 = load(valid,tri.v[0],ofs);
+      const vfloat4 p1 = load(valid,tri.v[1],ofs);
+      const vfloat4 p2 = load(valid,tri.v[2],ofs);
       
       if (P) {
         vfloat4::storeu(valid,P+i,madd(w,p0,madd(u,p1,v*p2)));
@@ -27,6 +27,9 @@ namespace embree
     /*! type of this geometry */
     static const Geometry::GTypeMask geom_type = Geometry::MTY_TRIANGLE_MESH;
 
+    /*! number of consecutive triangles sharing a base vertex when using 16 bit indices */
+    static const size_t MESHLET_SIZE = 64;
+
     /*! triangle indices */
     struct Triangle 
     {
@@ -56,6 +59,7 @@ namespace embree
     void preCommit();
     void postCommit();
     bool verify();
+    bool prefetchPrimRefs(const range<size_t>& r) const;
     void interpolate(const RTCInterpolateArguments* const args);
 
   public:
@@ -65,13 +69,46 @@ namespace embree
       return vertices[0].size();
     }
     
-    /*! returns i'th triangle*/
-    __forceinline const Triangle& triangle(size_t i) const {
+    /*! returns i'th triangle */
+    __forceinline Triangle triangle(size_t i) const {
+      if (unlikely(shortIndices())) return decodeTriangle(i);
       return triangles[i];
     }
 
+    /*! returns true if the indices are stored as RTC_FORMAT_USHORT3 */
+    __forceinline bool shortIndices() const {
+      return triangles.getFormat() == RTC_FORMAT_USHORT3;
+    }
+
+    /*! decodes the i'th triangle of a 16 bit index buffer by adding the base vertex of its meshlet */
+    __forceinline Triangle decodeTriangle(size_t i) const
+    {
+      const unsigned short* idx = (const unsigned short*) triangles.getPtr(i);
+      const unsigned int base = meshletBases ? meshletBases[i/MESHLET_SIZE] : 0;
+      Triangle t;
+      t.v[0] = base + idx[0];
+      t.v[1] = base + idx[1];
+      t.v[2] = base + idx[2];
+      return t;
+    }
+
+    /*! tests if the hit at barycentric coordinates u,v of the i'th triangle lies on an opaque micro triangle of the opacity micromap */
+    __forceinline bool opaque(size_t i, float u, float v) const
+    {
+      /* locate the micro triangle row by row, each row holds alternating lower and upper micro triangles */
+      const int N = 1 << micromapLevel;
+      const float fu = u*float(N), fv = v*float(N);
+      const int iv = clamp(int(fv),0,N-1);
+      const int iu = clamp(int(fu),0,N-1-iv);
+      const bool upper = iu+iv < N-1 && (fu-float(iu))+(fv-float(iv)) > 1.0f;
+      const unsigned int idx = iv*(2*N-iv) + 2*iu + int(upper);
+      const unsigned char* bits = (const unsigned char*) opacityMicromap.getPtr(i);
+      return (bits[idx >> 3] >> (idx & 7)) & 1;
+    }
+
     /*! returns i'th vertex of the first time step  */
     __forceinline const Vec3fa vertex(size_t i) const {
+      if (unlikely(compressedVertices())) return vertices0.decode(i);
       return vertices0[i];
     }
 
@@ -82,9 +119,26 @@ namespace embree
 
     /*! returns i'th vertex of itime'th timestep */
     __forceinline const Vec3fa vertex(size_t i, size_t itime) const {
+      if (unlikely(compressedVertices())) return vertices[itime].decode(i);
       return vertices[itime][i];
     }
 
+    /*! returns true if the vertices are stored as RTC_FORMAT_HALF3 or RTC_FORMAT_USHORT3 */
+    __forceinline bool compressedVertices() const {
+      return vertices0.getFormat() == RTC_FORMAT_HALF3 || vertices0.getFormat() == RTC_FORMAT_USHORT3;
+    }
+
+    /*! returns the vertex offset multiplier used by indexed leaves */
+    __forceinline unsigned int leafVertexStride() const {
+      return compressedVertices() ? 1 : vertices0.getStride()/4;
+    }
+
+    /*! returns the vertex referenced by an offset stored in an indexed leaf */
+    __forceinline const Vec3fa leafVertex(unsigned int ofs, size_t itime) const {
+      if (unlikely(compressedVertices())) return vertices[itime].decode(ofs);
+      return Vec3fa::loadu((const float*)vertexPtr(0,itime)+ofs);
+    }
+
     /*! returns i'th vertex of itime'th timestep */
     __forceinline const char* vertexPtr(size_t i, size_t itime) const {
       return vertices[itime].getPtr(i);
@@ -205,14 +259,17 @@ namespace embree
 
     /* returns true if topology changed */
     bool topologyChanged() const {
-      return triangles.isModified() || numPrimitivesChanged;
+      return triangles.isModified() || meshletBases.isModified() || numPrimitivesChanged;
     }
 
   public:
-    BufferView<Triangle> triangles;      //!< array of triangles
-    BufferView<Vec3fa> vertices0;        //!< fast access to first vertex buffer
-    vector<BufferView<Vec3fa>> vertices; //!< vertex array for each timestep
-    vector<RawBufferView> vertexAttribs; //!< vertex attributes
+    BufferView<Triangle> triangles;        //!< array of triangles
+    BufferView<unsigned int> meshletBases; //!< base vertex of each meshlet for 16 bit indices
+    RawBufferView opacityMicromap;         //!< opacity bitmask over the micro triangles of each triangle
+    unsigned int micromapLevel;            //!< subdivision level of the opacity micromap
+    BufferView<Vec3fa> vertices0;          //!< fast access to first vertex buffer
+    vector<BufferView<Vec3fa>> vertices;   //!< vertex array for each timestep
+    vector<RawBufferView> vertexAttribs;   //!< vertex attributes
   };
 
   namespace isa
@@ -44,12 +44,14 @@ namespace embree
     this->boundsFunc = bounds;
   }
 
-  void UserGeometry::setIntersectFunctionN (RTCIntersectFunctionN intersect) {
+  void UserGeometry::setIntersectFunctionN (RTCIntersectFunctionN intersect, bool batched) {
     intersectorN.intersect = intersect;
+    intersectBatched = batched;
   }
 
-  void UserGeometry::setOccludedFunctionN (RTCOccludedFunctionN occluded) {
+  void UserGeometry::setOccludedFunctionN (RTCOccludedFunctionN occluded, bool batched) {
     intersectorN.occluded = occluded;
+    occludedBatched = batched;
   }
   
 #endif
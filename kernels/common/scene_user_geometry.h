@@ -32,8 +32,8 @@ namespace embree
     virtual void disabling();
     virtual void setMask (unsigned mask);
     virtual void setBoundsFunction (RTCBoundsFunction bounds, void* userPtr);
-    virtual void setIntersectFunctionN (RTCIntersectFunctionN intersect);
-    virtual void setOccludedFunctionN (RTCOccludedFunctionN occluded);
+    virtual void setIntersectFunctionN (RTCIntersectFunctionN intersect, bool batched);
+    virtual void setOccludedFunctionN (RTCOccludedFunctionN occluded, bool batched);
     virtual void build() {}
   };
 
@@ -19,6 +19,8 @@
 namespace embree
 {
   Stat Stat::instance; 
+
+  std::atomic<size_t> TraversalCounters::numEnabledDevices(0);
   
   Stat::Stat () {
   }
@@ -138,4 +140,89 @@ namespace embree
     cout << "#user7/user3 " << 100.0f*float(cntrs.user[7])/float(cntrs.user[3]) << "%" << std::endl;
     cout << std::endl;
   }
+
+  /* the tick accumulators last used by a thread, tagged with the ID of their commit */
+  static std::atomic<size_t> g_build_report_id(1);
+  static __thread size_t thread_build_report_id = 0;
+  static __thread BuildReport::ThreadTicks* thread_build_report_ticks = nullptr;
+
+  /* unique key of a thread to find its accumulators again after working on other commits */
+  static std::atomic<size_t> g_build_report_thread_key(1);
+  static __thread size_t thread_build_report_key = 0;
+
+  void BuildReport::begin(bool enabled_i)
+  {
+    Lock<MutexSys> lock(mutex);
+    enabled = enabled_i;
+    id = g_build_report_id++;
+    threads.clear();
+    sahWeighted = 0.0;
+    current = Result();
+    t0 = getSeconds();
+    c0 = read_tsc();
+  }
+
+  BuildReport::ThreadTicks* BuildReport::threadTicks()
+  {
+    if (likely(thread_build_report_id == id))
+      return thread_build_report_ticks;
+
+    if (thread_build_report_key == 0)
+      thread_build_report_key = g_build_report_thread_key++;
+
+    /* register the accumulators of this thread with the commit only once */
+    Lock<MutexSys> lock(mutex);
+    ThreadTicks* ticks = nullptr;
+    for (auto& t : threads)
+      if (t->threadKey == thread_build_report_key) ticks = t.get();
+    if (ticks == nullptr) {
+      ticks = new ThreadTicks(thread_build_report_key);
+      threads.push_back(std::unique_ptr<ThreadTicks>(ticks));
+    }
+    thread_build_report_id = id;
+    thread_build_report_ticks = ticks;
+    return ticks;
+  }
+
+  void BuildReport::addBVH(size_t numPrimitives, double sah, size_t bytesAllocated, size_t bytesUsed, size_t bytesWasted)
+  {
+    Lock<MutexSys> lock(mutex);
+    current.numBVHs++;
+    current.numPrimitives += numPrimitives;
+    current.bytesAllocated += bytesAllocated;
+    current.bytesUsed += bytesUsed;
+    current.bytesWasted += bytesWasted;
+    sahWeighted += sah*double(numPrimitives);
+  }
+
+  void BuildReport::end(size_t numThreads)
+  {
+    const double dt = getSeconds()-t0;
+    const uint64_t dc = read_tsc()-c0;
+
+    Lock<MutexSys> lock(mutex);
+    if (!enabled) {
+      last = Result();
+      return;
+    }
+
+    /* sum up the ticks of all threads and calibrate the TSC against the wall clock time of the commit */
+    const double secondsPerTick = (dt > 0.0 && dc > 0) ? dt/double(dc) : 0.0;
+    current.commitTime = dt;
+    for (size_t i=0; i<NUM_PHASES; i++)
+    {
+      uint64_t ticks = 0;
+      for (auto& t : threads) ticks += t->ticks[i];
+      current.phaseTimes[i] = double(ticks)*secondsPerTick;
+    }
+    current.sah = current.numPrimitives ? sahWeighted/double(current.numPrimitives) : 0.0;
+    current.numThreads = numThreads;
+    last = current;
+  }
+
+  BuildReport::Result BuildReport::get()
+  {
+    Lock<MutexSys> lock(mutex);
+    return last;
+  }
 }
@@ -17,6 +17,7 @@
 #pragma once
 
 #include "default.h"
+#include "../../common/sys/tracer.h"
 
 /* Macros to gather statistics */
 #ifdef EMBREE_STAT_COUNTERS
@@ -125,4 +126,157 @@ namespace embree
   private:
     static Stat instance;
   };
+
+  /*! Traversal counters of a single thread. Unlike the statistics
+   *  above these counters can get enabled at runtime per device. The
+   *  traversal kernels receive the counters of the calling thread
+   *  through the intersect context, which stores a NULL pointer when
+   *  counting is disabled. The counters are cache line aligned to
+   *  avoid false sharing between threads. */
+  struct __aligned(64) TraversalCounters
+  {
+    ALIGNED_STRUCT_(64);
+
+    /*! Counter that only its own thread increments. Relaxed loads and
+     *  stores make concurrent reads and resets well defined without
+     *  the cost of atomic read-modify-write operations, an increment
+     *  that overlaps a reset may thus restore its old value. */
+    struct Counter
+    {
+      __forceinline Counter () : v(0) {}
+
+      __forceinline operator size_t() const { return v.load(std::memory_order_relaxed); }
+      __forceinline Counter& operator= (size_t x) { v.store(x,std::memory_order_relaxed); return *this; }
+      __forceinline Counter& operator+=(size_t x) { return *this = size_t(*this)+x; }
+      __forceinline size_t   operator++(int) { const size_t x = *this; *this = x+1; return x; }
+
+    private:
+      std::atomic<size_t> v;
+    };
+
+  public:
+    TraversalCounters (size_t threadIndex = 0)
+      : threadIndex(threadIndex) { clear(); }
+
+    void clear()
+    {
+      travs = 0;
+      nodes = 0;
+      leaves = 0;
+      prims = 0;
+      filters = 0;
+      instances = 0;
+      stack_depth = 0;
+    }
+
+    /*! records the current depth of the traversal stack */
+    __forceinline void stack(size_t depth) {
+      if (depth > stack_depth) stack_depth = depth;
+    }
+
+  public:
+    size_t threadIndex;   //!< index of the thread in order of its first counted traversal
+    Counter travs;        //!< number of BVH traversals
+    Counter nodes;        //!< number of visited inner nodes
+    Counter leaves;       //!< number of visited leaf nodes
+    Counter prims;        //!< number of primitive tests
+    Counter filters;      //!< number of filter function invocations
+    Counter instances;    //!< number of transitions into instanced scenes
+    Counter stack_depth;  //!< maximal depth of the traversal stack
+
+  public:
+    static std::atomic<size_t> numEnabledDevices; //!< number of devices that count traversal operations
+  };
+
+  /*! Gathers phase timings and memory statistics of a single scene
+   *  commit. Phases are timed in TSC ticks that get converted to
+   *  seconds once the commit finished. */
+  struct BuildReport
+  {
+    enum Phase { PRIMREFS = 0, HIERARCHY = 1, SPATIAL_SPLITS = 2, LEAVES = 3, NUM_PHASES = 4 };
+
+    /*! adds the ticks spent inside some scope to a build phase, the
+     *  primref and hierarchy phases are also recorded as trace events */
+    struct Timer
+    {
+      __forceinline Timer (BuildReport& report, Phase phase)
+        : report(report.enabled ? &report : nullptr), phase(phase),
+          trace(phase <= HIERARCHY && Tracer::enabled()), t0(report.enabled || trace ? read_tsc() : 0) {}
+
+      __forceinline ~Timer()
+      {
+        if (likely(report == nullptr && !trace)) return;
+        const uint64_t t1 = read_tsc();
+        if (report) report->threadTicks()->ticks[phase] += t1-t0;
+        if (trace) Tracer::record(phase == PRIMREFS ? "build_primrefs" : "build_hierarchy",t0,t1);
+      }
+
+    private:
+      BuildReport* report;
+      Phase phase;
+      bool trace;
+      uint64_t t0;
+    };
+
+    /*! ticks accumulated by a single thread, cache line aligned to
+     *  avoid false sharing, and summed up once the commit finished */
+    struct __aligned(64) ThreadTicks
+    {
+      ALIGNED_STRUCT_(64);
+    public:
+      ThreadTicks (size_t threadKey)
+        : threadKey(threadKey) { for (size_t i=0; i<NUM_PHASES; i++) ticks[i] = 0; }
+
+    public:
+      size_t threadKey;             //!< unique key of the owning thread
+      uint64_t ticks[NUM_PHASES];   //!< accumulated ticks of each phase
+    };
+
+    struct Result
+    {
+      Result () { memset(this,0,sizeof(Result)); }
+
+    public:
+      double commitTime;              //!< duration of the commit in seconds
+      double phaseTimes[NUM_PHASES];  //!< durations of the build phases in seconds
+      size_t numThreads;              //!< number of threads used for the commit
+      size_t numBVHs;                 //!< number of built hierarchies
+      size_t numPrimitives;           //!< number of primitives in all built hierarchies
+      size_t bytesAllocated;          //!< bytes allocated by the BVH allocators
+      size_t bytesUsed;               //!< bytes used by nodes and leaves
+      size_t bytesWasted;             //!< bytes lost to alignment and unused block ends
+      double sah;                     //!< SAH cost of all built hierarchies weighted by their number of primitives
+    };
+
+  public:
+    BuildReport () : enabled(false), id(0), t0(0.0), c0(0), sahWeighted(0.0) {}
+
+    /*! starts gathering statistics for a new commit */
+    void begin(bool enabled);
+
+    /*! adds the statistics of a finished hierarchy build */
+    void addBVH(size_t numPrimitives, double sah, size_t bytesAllocated, size_t bytesUsed, size_t bytesWasted);
+
+    /*! finishes the commit and publishes the gathered statistics */
+    void end(size_t numThreads);
+
+    /*! returns the statistics of the last finished commit */
+    Result get();
+
+    /*! returns the tick accumulators of the calling thread for the running commit */
+    ThreadTicks* threadTicks();
+
+  public:
+    bool enabled;                           //!< statistics get only gathered when enabled
+
+  private:
+    size_t id;           //!< unique ID of the running commit to detect stale thread local references
+    double t0;           //!< time at the start of the commit
+    uint64_t c0;         //!< TSC at the start of the commit
+    double sahWeighted;  //!< SAH cost of the built hierarchies multiplied by their number of primitives
+    Result current;      //!< statistics of the running commit
+    Result last;         //!< statistics of the last finished commit
+    std::vector<std::unique_ptr<ThreadTicks>> threads; //!< tick accumulators of all threads of the running commit
+    MutexSys mutex;
+  };
 }
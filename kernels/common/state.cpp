@@ -96,6 +96,7 @@ namespace embree
     max_spatial_split_replications = 2.0f;
 
     tessellation_cache_size = 128*1024*1024;
+    build_memory_budget = 0;
 
     subdiv_accel = "default";
     subdiv_accel_mb = "default";
@@ -135,6 +136,10 @@ namespace embree
     hugepages = false;
 #endif
     hugepages_success = true;
+    numa_replication = false;
+    traversal_counters = false;
+    trace_file = "";
+    trace_buffer_size = 64*1024;
 
     alloc_main_block_size = 0;
     alloc_num_main_slots = 0;
@@ -278,6 +283,20 @@ namespace embree
       else if (tok == Token::Id("hugepages") && cin->trySymbol("=")) {
         hugepages = cin->get().Int();
       }
+      else if (tok == Token::Id("numa_replication") && cin->trySymbol("=")) {
+        numa_replication = cin->get().Int();
+      }
+      else if (tok == Token::Id("traversal_counters") && cin->trySymbol("=")) {
+        traversal_counters = cin->get().Int();
+      }
+      else if (tok == Token::Id("trace_file") && cin->trySymbol("=")) {
+        trace_file = cin->get().String();
+      }
+      else if (tok == Token::Id("trace_buffer_size") && cin->trySymbol("=")) {
+        const int size = cin->get().Int();
+        if (size < 1) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"trace_buffer_size has to be at least 1");
+        trace_buffer_size = size;
+      }
 
       else if (tok == Token::Id("ignore_config_files") && cin->trySymbol("="))
         ignore_config_files = cin->get().Int();
@@ -417,6 +436,9 @@ namespace embree
       else if (tok == Token::Id("cache_size") && cin->trySymbol("="))
         tessellation_cache_size = size_t(cin->get().Float()*1024.0f*1024.0f);
 
+      else if (tok == Token::Id("build_memory_budget") && cin->trySymbol("="))
+        build_memory_budget = size_t(cin->get().Float()*1024.0f*1024.0f);
+
       else if (tok == Token::Id("alloc_main_block_size") && cin->trySymbol("="))
         alloc_main_block_size = cin->get().Int();
        else if (tok == Token::Id("alloc_num_main_slots") && cin->trySymbol("="))
@@ -446,9 +468,14 @@ namespace embree
     else if (hugepages_success) std::cout << "enabled" << std::endl;
     else std::cout << "failed" << std::endl;
 
+    std::cout << "  numa_replication = " << numa_replication << std::endl;
+    std::cout << "  traversal_counters = " << traversal_counters << std::endl;
+    std::cout << "  trace_file    = " << trace_file << std::endl;
+    std::cout << "  trace_buffer_size = " << trace_buffer_size << std::endl;
     std::cout << "  verbosity     = " << verbose << std::endl;
     std::cout << "  cache_size    = " << float(tessellation_cache_size)*1E-6 << " MB" << std::endl;
     std::cout << "  max_spatial_split_replications = " << max_spatial_split_replications << std::endl;
+    std::cout << "  build_memory_budget = " << float(build_memory_budget)*1E-6 << " MB" << std::endl;
     
     std::cout << "triangles:" << std::endl;
     std::cout << "  accel         = " << tri_accel << std::endl;
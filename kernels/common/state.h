@@ -118,6 +118,7 @@ namespace embree
   public:
     float max_spatial_split_replications;  //!< maximally replications*N many primitives in accel for spatial splits
     size_t tessellation_cache_size;        //!< size of the shared tessellation cache 
+    size_t build_memory_budget;            //!< maximal size of the primitive reference array of a build, 0 means unbounded
 
   public:
     size_t instancing_open_min;            //!< instancing opens tree to minimally that number of subtrees
@@ -143,6 +144,10 @@ namespace embree
     bool enable_selockmemoryprivilege;     //!< configures the SeLockMemoryPrivilege under Windows to enable huge pages
     bool hugepages;                        //!< true if huge pages should get used
     bool hugepages_success;                //!< status for enabling huge pages
+    bool numa_replication;                 //!< replicates the top levels of each BVH per CPU socket
+    bool traversal_counters;               //!< counts traversal operations per thread
+    std::string trace_file;                //!< writes scheduler and builder trace events to this file
+    size_t trace_buffer_size;              //!< number of trace events stored per thread
 
   public:
     size_t alloc_main_block_size;          //!< main allocation block size (shared between threads)
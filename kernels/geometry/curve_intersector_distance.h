@@ -68,7 +68,7 @@ namespace embree
                                    const Vec3fa& v0, const Vec3fa& v1, const Vec3fa& v2, const Vec3fa& v3,
                                    const Epilog& epilog)
       {
-        const int N = geom->tessellationRate;
+        const int N = coneTessellationRate(epilog.context,ray.org,ray.dir,v0,v1,v2,v3,geom->tessellationRate);
         
         /* transform control points into ray space */
         const NativeCurve3fa curve3D(v0,v1,v2,v3);
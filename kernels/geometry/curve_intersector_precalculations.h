@@ -18,6 +18,7 @@
 
 #include "../common/ray.h"
 #include "../common/geometry.h"
+#include "../common/context.h"
 
 namespace embree
 {
@@ -58,5 +59,17 @@ namespace embree
         }
       }
     };
+
+    /* reduces the tessellation rate of a curve segment such that the
+     * tessellated segments are not shorter than the ray cone is wide */
+    __forceinline int coneTessellationRate(const IntersectContext* context, const Vec3fa& ray_org, const Vec3fa& ray_dir,
+                                           const Vec3fa& v0, const Vec3fa& v1, const Vec3fa& v2, const Vec3fa& v3, const int N)
+    {
+      if (likely(context->cone == nullptr)) return N;
+      const float width = context->coneWidth(ray_org,ray_dir,0.25f*(v0+v1+v2+v3));
+      const float length = embree::length(v1-v0)+embree::length(v2-v1)+embree::length(v3-v2);
+      if (width <= 0.0f || length >= float(N)*width) return N;
+      return max(1,(int)ceil(length*rcp(width)));
+    }
   }
 }
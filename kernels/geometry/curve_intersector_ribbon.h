@@ -187,7 +187,7 @@ namespace embree
                                    const Vec3fa& v0, const Vec3fa& v1, const Vec3fa& v2, const Vec3fa& v3,
                                    const Epilog& epilog)
       {
-        const int N = geom->tessellationRate;
+        const int N = coneTessellationRate(epilog.context,ray.org,ray.dir,v0,v1,v2,v3,geom->tessellationRate);
         const NativeCurve3fa curve(v0,v1,v2,v3);
         return intersect_ribbon<NativeCurve3fa>(ray.org,ray.dir,ray.tnear(),ray.tfar,
                                                 pre.ray_space,pre.depth_scale,
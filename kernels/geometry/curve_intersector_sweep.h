@@ -33,6 +33,11 @@ namespace embree
     static const size_t numBezierSubdivisions = 3;
 #endif
 
+    /* segments whose control points deviate from the segment chord by less
+     * than this fraction of the radius are treated as cones and terminate
+     * subdivision early */
+    static const float curveFlatnessThreshold = 0.1f;
+
     struct BezierCurveHit
     {
       __forceinline BezierCurveHit() {}
@@ -127,7 +132,8 @@ namespace embree
 
     template<typename NativeCurve3fa, typename Ray, typename Epilog>
     bool intersect_bezier_recursive_jacobian(const Ray& ray, const float dt, const NativeCurve3fa& curve,
-                                             const float u0, const float u1, const size_t depth, const Epilog& epilog)
+                                             const float u0, const float u1, const size_t depth, const Epilog& epilog,
+                                             const float footprint = 0.0f)
     {
       int maxDepth = numBezierSubdivisions;
       //int maxDepth = Device::debug_int1+1;
@@ -149,8 +155,10 @@ namespace embree
       const vfloatx maxr12 = sqrt(max(rr1,rr2));
       const vfloatx one_plus_ulp  = 1.0f+2.0f*float(ulp);
       const vfloatx one_minus_ulp = 1.0f-2.0f*float(ulp);
-      vfloatx r_outer = max(P0.w,P1.w,P2.w,P3.w)+maxr12;
-      vfloatx r_inner = min(P0.w,P1.w,P2.w,P3.w)-maxr12;
+      const vfloatx r_min = min(P0.w,P1.w,P2.w,P3.w);
+      const vfloatx r_max = max(P0.w,P1.w,P2.w,P3.w);
+      vfloatx r_outer = r_max+maxr12;
+      vfloatx r_inner = r_min-maxr12;
       r_outer = one_plus_ulp*r_outer;
       r_inner = max(0.0f,one_minus_ulp*r_inner);
       const CylinderN<VSIZEX> cylinder_outer(Vec3vfx(P0),Vec3vfx(P3),r_outer);
@@ -186,6 +194,19 @@ namespace embree
       /* at the unstable area we subdivide deeper */
       const vboolx unstable0 = (!valid_inner) | (abs(dot(Vec3vfx(normalize(ray.dir)),normalize(Ng_inner0))) < 0.3f);
       const vboolx unstable1 = (!valid_inner) | (abs(dot(Vec3vfx(normalize(ray.dir)),normalize(Ng_inner1))) < 0.3f);
+
+      /* adapt subdivision depth to the shape of each segment, almost straight segments
+       * terminate early and segments that bend more than their radius get subdivided deeper */
+      const vboolx flat   = maxr12 <= curveFlatnessThreshold*r_min;
+      const vboolx curved = maxr12 > r_max;
+
+      /* segments that are covered by the footprint of a ray cone are not subdivided further */
+      const vboolx covered = vfloatx(footprint) >= length(Vec3vfx(P3-P0))+maxr12+r_max;
+      auto terminationDepth = [&] (const vboolx& unstable, const size_t i) -> size_t {
+        if (footprint > 0.0f && covered[i]) return depth;
+        const size_t termDepth = unstable[i] ? maxDepth+1 : (flat[i] && depth >= 2 ? depth : maxDepth);
+        return curved[i] ? termDepth+1 : termDepth;
+      };
       
       /* subtract the inner interval from the current hit interval */
       BBox<vfloatx> tp0, tp1;
@@ -199,10 +220,10 @@ namespace embree
       while (any(valid0))
       {
         const size_t i = select_min(valid0,tp0.lower); clear(valid0,i);
-        const size_t termDepth = unstable0[i] ? maxDepth+1 : maxDepth;
+        const size_t termDepth = terminationDepth(unstable0,i);
         if (depth >= termDepth) found = found | intersect_bezier_iterative_jacobian(ray,dt,curve,u_outer0[i],tp0.lower[i],epilog);
         //if (depth >= maxDepth) found = found | intersect_bezier_iterative_debug   (ray,dt,curve,i,u_outer0,tp0,h0,h1,Ng_outer0,dP0du,dP3du,epilog);
-        else                   found = found | intersect_bezier_recursive_jacobian(ray,dt,curve,vu0[i+0],vu0[i+1],depth+1,epilog);
+        else                   found = found | intersect_bezier_recursive_jacobian(ray,dt,curve,vu0[i+0],vu0[i+1],depth+1,epilog,footprint);
         valid0 &= tp0.lower+dt <= ray.tfar;
       }
       valid1 &= tp1.lower+dt <= ray.tfar;
@@ -211,10 +232,10 @@ namespace embree
       while (any(valid1))
       {
         const size_t i = select_min(valid1,tp1.lower); clear(valid1,i);
-        const size_t termDepth = unstable1[i] ? maxDepth+1 : maxDepth;
+        const size_t termDepth = terminationDepth(unstable1,i);
         if (depth >= termDepth) found = found | intersect_bezier_iterative_jacobian(ray,dt,curve,u_outer1[i],tp1.upper[i],epilog);
         //if (depth >= maxDepth) found = found | intersect_bezier_iterative_debug   (ray,dt,curve,i,u_outer1,tp1,h0,h1,Ng_outer1,dP0du,dP3du,epilog);
-        else                   found = found | intersect_bezier_recursive_jacobian(ray,dt,curve,vu0[i+0],vu0[i+1],depth+1,epilog);
+        else                   found = found | intersect_bezier_recursive_jacobian(ray,dt,curve,vu0[i+0],vu0[i+1],depth+1,epilog,footprint);
         valid1 &= tp1.lower+dt <= ray.tfar;
       }
       return found;
@@ -236,7 +257,10 @@ namespace embree
         const float dt = dot(curve0.center()-ray.org,ray.dir)*rcp(dot(ray.dir,ray.dir));
         const Vec3fa ref(madd(Vec3fa(dt),ray.dir,ray.org),0.0f);
         const NativeCurve3fa curve1 = curve0-ref;
-        return intersect_bezier_recursive_jacobian(ray,dt,curve1,0.0f,1.0f,1,epilog);
+
+        /* width of the ray cone at the curve, which limits the useful subdivision depth */
+        const float footprint = epilog.context->coneWidth(ray.org,ray.dir,curve0.center());
+        return intersect_bezier_recursive_jacobian(ray,dt,curve1,0.0f,1.0f,1,epilog,footprint);
       }
     };
 
@@ -31,6 +31,7 @@ namespace embree
       {
         assert(context->scene->hasGeometryFilterFunction());
         geometry->intersectionFilterN(args);
+        TRAV_COUNTER(context,filters++);
 
         if (args->valid[0] == 0)
           return false;
@@ -39,10 +40,17 @@ namespace embree
       if (context->user->filter) {
         assert(context->scene->hasContextFilterFunction());
         context->user->filter(args);
+        TRAV_COUNTER(context,filters++);
 
         if (args->valid[0] == 0)
           return false;
       }
+
+      /* multi-hit queries collect the hit and continue traversal */
+      if (unlikely(context->multiHit)) {
+        context->multiHit->insert(((RayHit*)args->ray)->tfar,*(RTCHit*)args->hit);
+        return false;
+      }
       
       copyHitToRay(*(RayHit*)args->ray,*(Hit*)args->hit);
       return true;
@@ -69,6 +77,7 @@ namespace embree
       if (geometry->intersectionFilterN) {
         assert(context->scene->hasGeometryFilterFunction());
         geometry->intersectionFilterN(filter_args);
+        TRAV_COUNTER(context,filters++);
       }
       
       //if (args->valid[0] == 0)
@@ -77,16 +86,39 @@ namespace embree
       if (context->user->filter) {
         assert(context->scene->hasContextFilterFunction());
         context->user->filter(filter_args);
+        TRAV_COUNTER(context,filters++);
+      }
+
+      /* multi-hit queries collect the hit and reject it */
+      if (unlikely(context->multiHit) && filter_args->valid[0] != 0) {
+        context->multiHit->insert(((RayHit*)filter_args->ray)->tfar,*(RTCHit*)filter_args->hit);
+        filter_args->valid[0] = 0;
       }
 #endif
     }
     
+    __forceinline bool accumulateTransmittance1(const RTCFilterFunctionNArguments* args, const Geometry* const geometry, IntersectContext* context)
+    {
+      float opacity = 1.0f;
+      if (geometry->hasOpacityFunction())
+      {
+        RTCOpacityFunctionArguments oargs;
+        oargs.geometryUserPtr = geometry->userPtr;
+        oargs.context = context->user;
+        oargs.ray = (RTCRay*)args->ray;
+        oargs.hit = (RTCHit*)args->hit;
+        opacity = geometry->opacityFunction(&oargs);
+      }
+      return context->transmittance->accumulate(((Ray*)args->ray)->tfar,*(RTCHit*)args->hit,opacity);
+    }
+
     __forceinline bool runOcclusionFilter1Helper(RTCFilterFunctionNArguments* args, const Geometry* const geometry, IntersectContext* context)
     {
       if (geometry->occlusionFilterN)
       {
         assert(context->scene->hasGeometryFilterFunction());
         geometry->occlusionFilterN(args);
+        TRAV_COUNTER(context,filters++);
 
         if (args->valid[0] == 0)
           return false;
@@ -95,10 +127,16 @@ namespace embree
       if (context->user->filter) {
         assert(context->scene->hasContextFilterFunction());
         context->user->filter(args);
+        TRAV_COUNTER(context,filters++);
 
         if (args->valid[0] == 0)
           return false;
       }
+
+      /* transmittance queries continue traversal until the ray got occluded */
+      if (unlikely(context->transmittance))
+        return accumulateTransmittance1(args,geometry,context);
+
       return true;
     }
 
@@ -123,6 +161,7 @@ namespace embree
       if (geometry->occlusionFilterN) {
         assert(context->scene->hasGeometryFilterFunction());
         geometry->occlusionFilterN(filter_args);
+        TRAV_COUNTER(context,filters++);
       }
       
       //if (args->valid[0] == 0)
@@ -131,6 +170,13 @@ namespace embree
       if (context->user->filter) {
         assert(context->scene->hasContextFilterFunction());
         context->user->filter(filter_args);
+        TRAV_COUNTER(context,filters++);
+      }
+
+      /* transmittance queries reject the hit until the ray got occluded */
+      if (unlikely(context->transmittance) && filter_args->valid[0] != 0) {
+        if (!accumulateTransmittance1(filter_args,geometry,context))
+          filter_args->valid[0] = 0;
       }
 #endif
     }
@@ -143,6 +189,7 @@ namespace embree
       {
         assert(context->scene->hasGeometryFilterFunction());
         geometry->intersectionFilterN(args);
+        TRAV_COUNTER(context,filters++);
       }
 
       vbool<K> valid_o = *mask != vint<K>(zero);
@@ -151,6 +198,7 @@ namespace embree
       if (context->user->filter) {
         assert(context->scene->hasContextFilterFunction());
         context->user->filter(args);
+        TRAV_COUNTER(context,filters++);
       }
 
       valid_o = *mask != vint<K>(zero);
@@ -182,6 +230,7 @@ namespace embree
       {
         assert(context->scene->hasGeometryFilterFunction());
         geometry->occlusionFilterN(args);
+        TRAV_COUNTER(context,filters++);
       }
 
       vbool<K> valid_o = *mask != vint<K>(zero);
@@ -191,6 +240,7 @@ namespace embree
       if (context->user->filter) {
         assert(context->scene->hasContextFilterFunction());
         context->user->filter(args);
+        TRAV_COUNTER(context,filters++);
       }
 
       valid_o = *mask != vint<K>(zero);
@@ -21,6 +21,21 @@ namespace embree
 {
   namespace isa
   {
+    /* selects the level of detail of an instance for each active ray of a packet */
+    template<int K>
+    __forceinline vint<K> selectLOD(const vbool<K>& valid, const Instance* instance, const RayK<K>& ray, bool mblur)
+    {
+      vint<K> level(zero);
+      if (likely(!instance->hasLODs())) return level;
+      size_t mask = movemask(valid);
+      while (mask) {
+        const size_t k = bscf(mask);
+        const AffineSpace3fa local2world = mblur ? instance->getLocal2World(ray.time()[k]) : instance->getLocal2World();
+        level[k] = instance->selectLOD(local2world,Vec3fa(ray.org.x[k],ray.org.y[k],ray.org.z[k]),Vec3fa(ray.dir.x[k],ray.dir.y[k],ray.dir.z[k]),ray.id[k],nullptr);
+      }
+      return level;
+    }
+
     void InstanceIntersector1::intersect(const Precalculations& pre, RayHit& ray, IntersectContext* context, const InstancePrimitive& prim)
     {
       const Instance* instance = prim.instance;
@@ -35,14 +50,27 @@ namespace embree
       const AffineSpace3fa world2local = instance->getWorld2Local();
       const Vec3fa ray_org = ray.org;
       const Vec3fa ray_dir = ray.dir;
+      Accel* object = instance->object;
+      if (unlikely(instance->hasLODs())) object = instance->getLOD(instance->selectLOD(instance->getLocal2World(),ray_org,ray_dir,ray.id,context->cone));
       ray.org = Vec3fa(xfmPoint (world2local,ray_org),ray.tnear());
       ray.dir = Vec3fa(xfmVector(world2local,ray_dir),ray.time());      
-      user_context->instID[0] = instance->geomID;
-      IntersectContext newcontext((Scene*)instance->object,user_context);
-      instance->object->intersectors.intersect((RTCRayHit&)ray,&newcontext);
-      user_context->instID[0] = -1;
+      const float ray_tfar = ray.tfar;
+      const unsigned int instID = user_context->instID[0];
+      user_context->instID[0] = instance->hitInstID(instID);
+      MultiHitCollector* multiHit = context->multiHit;
+      if (unlikely(multiHit && instance->autoInstance)) multiHit->geomID = instance->geomID;
+      RTCRayCone cone; if (unlikely(context->cone)) cone = transformRayCone(*context->cone,ray_dir,ray.dir);
+      IntersectContext newcontext((Scene*)object,user_context,multiHit,nullptr,context->cone ? &cone : nullptr);
+      TRAV_COUNTER(context,instances++);
+      object->intersectors.intersect((RTCRayHit&)ray,&newcontext);
+      if (unlikely(multiHit)) multiHit->geomID = RTC_INVALID_GEOMETRY_ID;
+      user_context->instID[0] = instID;
       ray.org = ray_org;
       ray.dir = ray_dir;
+
+      /* hits inside automatic instances report the geomID of the replaced mesh */
+      if (unlikely(instance->autoInstance) && ray.tfar < ray_tfar)
+        ray.geomID = instance->geomID;
     }
     
     bool InstanceIntersector1::occluded(const Precalculations& pre, Ray& ray, IntersectContext* context, const InstancePrimitive& prim)
@@ -59,12 +87,17 @@ namespace embree
       const AffineSpace3fa world2local = instance->getWorld2Local();
       const Vec3fa ray_org = ray.org;
       const Vec3fa ray_dir = ray.dir;
+      Accel* object = instance->object;
+      if (unlikely(instance->hasLODs())) object = instance->getLOD(instance->selectLOD(instance->getLocal2World(),ray_org,ray_dir,ray.id,context->cone));
       ray.org = Vec3fa(xfmPoint (world2local,ray_org),ray.tnear());
       ray.dir = Vec3fa(xfmVector(world2local,ray_dir),ray.time());
-      user_context->instID[0] = instance->geomID;
-      IntersectContext newcontext((Scene*)instance->object,user_context);
-      instance->object->intersectors.occluded((RTCRay&)ray,&newcontext);
-      user_context->instID[0] = -1;
+      const unsigned int instID = user_context->instID[0];
+      user_context->instID[0] = instance->hitInstID(instID);
+      RTCRayCone cone; if (unlikely(context->cone)) cone = transformRayCone(*context->cone,ray_dir,ray.dir);
+      IntersectContext newcontext((Scene*)object,user_context,nullptr,context->transmittance,context->cone ? &cone : nullptr);
+      TRAV_COUNTER(context,instances++);
+      object->intersectors.occluded((RTCRay&)ray,&newcontext);
+      user_context->instID[0] = instID;
       ray.org = ray_org;
       ray.dir = ray_dir;
       return ray.tfar < 0.0f;
@@ -84,11 +117,15 @@ namespace embree
       const AffineSpace3fa world2local = instance->getWorld2Local(ray.time());
       const Vec3fa ray_org = ray.org;
       const Vec3fa ray_dir = ray.dir;
+      Accel* object = instance->object;
+      if (unlikely(instance->hasLODs())) object = instance->getLOD(instance->selectLOD(instance->getLocal2World(ray.time()),ray_org,ray_dir,ray.id,context->cone));
       ray.org = Vec3fa(xfmPoint (world2local,ray_org),ray.tnear());
       ray.dir = Vec3fa(xfmVector(world2local,ray_dir),ray.time());      
       user_context->instID[0] = instance->geomID;
-      IntersectContext newcontext((Scene*)instance->object,user_context);
-      instance->object->intersectors.intersect((RTCRayHit&)ray,&newcontext);
+      RTCRayCone cone; if (unlikely(context->cone)) cone = transformRayCone(*context->cone,ray_dir,ray.dir);
+      IntersectContext newcontext((Scene*)object,user_context,context->multiHit,nullptr,context->cone ? &cone : nullptr);
+      TRAV_COUNTER(context,instances++);
+      object->intersectors.intersect((RTCRayHit&)ray,&newcontext);
       user_context->instID[0] = -1;
       ray.org = ray_org;
       ray.dir = ray_dir;
@@ -108,11 +145,15 @@ namespace embree
       const AffineSpace3fa world2local = instance->getWorld2Local(ray.time());
       const Vec3fa ray_org = ray.org;
       const Vec3fa ray_dir = ray.dir;
+      Accel* object = instance->object;
+      if (unlikely(instance->hasLODs())) object = instance->getLOD(instance->selectLOD(instance->getLocal2World(ray.time()),ray_org,ray_dir,ray.id,context->cone));
       ray.org = Vec3fa(xfmPoint (world2local,ray_org),ray.tnear());
       ray.dir = Vec3fa(xfmVector(world2local,ray_dir),ray.time());
       user_context->instID[0] = instance->geomID;
-      IntersectContext newcontext((Scene*)instance->object,user_context);
-      instance->object->intersectors.occluded((RTCRay&)ray,&newcontext);
+      RTCRayCone cone; if (unlikely(context->cone)) cone = transformRayCone(*context->cone,ray_dir,ray.dir);
+      IntersectContext newcontext((Scene*)object,user_context,nullptr,context->transmittance,context->cone ? &cone : nullptr);
+      TRAV_COUNTER(context,instances++);
+      object->intersectors.occluded((RTCRay&)ray,&newcontext);
       user_context->instID[0] = -1;
       ray.org = ray_org;
       ray.dir = ray_dir;
@@ -135,14 +176,25 @@ namespace embree
       AffineSpace3vf<K> world2local = instance->getWorld2Local();
       const Vec3vf<K> ray_org = ray.org;
       const Vec3vf<K> ray_dir = ray.dir;
+      const vint<K> level = selectLOD(valid,instance,ray,false);
       ray.org = xfmPoint (world2local,ray_org);
       ray.dir = xfmVector(world2local,ray_dir);
-      user_context->instID[0] = instance->geomID;
-      IntersectContext newcontext((Scene*)instance->object,user_context);
-      instance->object->intersectors.intersect(valid,ray,&newcontext);
-      user_context->instID[0] = -1;
+      const vfloat<K> ray_tfar = ray.tfar;
+      const unsigned int instID = user_context->instID[0];
+      user_context->instID[0] = instance->hitInstID(instID);
+      foreach_unique(valid,level,[&](const vbool<K>& valid_level, int l) {
+        Accel* object = instance->getLOD(l);
+        IntersectContext newcontext((Scene*)object,user_context);
+        TRAV_COUNTER(context,instances += popcnt(valid_level));
+        object->intersectors.intersect(valid_level,ray,&newcontext);
+      });
+      user_context->instID[0] = instID;
       ray.org = ray_org;
       ray.dir = ray_dir;
+
+      /* hits inside automatic instances report the geomID of the replaced mesh */
+      if (unlikely(instance->autoInstance))
+        ray.geomID = select(valid & (ray.tfar < ray_tfar), vuint<K>(instance->geomID), ray.geomID);
     }
 
     template<int K>
@@ -161,12 +213,18 @@ namespace embree
       AffineSpace3vf<K> world2local = instance->getWorld2Local();
       const Vec3vf<K> ray_org = ray.org;
       const Vec3vf<K> ray_dir = ray.dir;
+      const vint<K> level = selectLOD(valid,instance,ray,false);
       ray.org = xfmPoint (world2local,ray_org);
       ray.dir = xfmVector(world2local,ray_dir);
-      user_context->instID[0] = instance->geomID;
-      IntersectContext newcontext((Scene*)instance->object,user_context);
-      instance->object->intersectors.occluded(valid,ray,&newcontext);
-      user_context->instID[0] = -1;
+      const unsigned int instID = user_context->instID[0];
+      user_context->instID[0] = instance->hitInstID(instID);
+      foreach_unique(valid,level,[&](const vbool<K>& valid_level, int l) {
+        Accel* object = instance->getLOD(l);
+        IntersectContext newcontext((Scene*)object,user_context);
+        TRAV_COUNTER(context,instances += popcnt(valid_level));
+        object->intersectors.occluded(valid_level,ray,&newcontext);
+      });
+      user_context->instID[0] = instID;
       ray.org = ray_org;
       ray.dir = ray_dir;
       return ray.tfar < 0.0f;
@@ -188,11 +246,16 @@ namespace embree
       AffineSpace3vf<K> world2local = instance->getWorld2Local<K>(valid,ray.time());
       const Vec3vf<K> ray_org = ray.org;
       const Vec3vf<K> ray_dir = ray.dir;
+      const vint<K> level = selectLOD(valid,instance,ray,true);
       ray.org = xfmPoint (world2local,ray_org);
       ray.dir = xfmVector(world2local,ray_dir);
       user_context->instID[0] = instance->geomID;
-      IntersectContext newcontext((Scene*)instance->object,user_context);
-      instance->object->intersectors.intersect(valid,ray,&newcontext);
+      foreach_unique(valid,level,[&](const vbool<K>& valid_level, int l) {
+        Accel* object = instance->getLOD(l);
+        IntersectContext newcontext((Scene*)object,user_context);
+        TRAV_COUNTER(context,instances += popcnt(valid_level));
+        object->intersectors.intersect(valid_level,ray,&newcontext);
+      });
       user_context->instID[0] = -1;
       ray.org = ray_org;
       ray.dir = ray_dir;
@@ -214,11 +277,16 @@ namespace embree
       AffineSpace3vf<K> world2local = instance->getWorld2Local<K>(valid,ray.time());
       const Vec3vf<K> ray_org = ray.org;
       const Vec3vf<K> ray_dir = ray.dir;
+      const vint<K> level = selectLOD(valid,instance,ray,true);
       ray.org = xfmPoint (world2local,ray_org);
       ray.dir = xfmVector(world2local,ray_dir);
       user_context->instID[0] = instance->geomID;
-      IntersectContext newcontext((Scene*)instance->object,user_context);
-      instance->object->intersectors.occluded(valid,ray,&newcontext);
+      foreach_unique(valid,level,[&](const vbool<K>& valid_level, int l) {
+        Accel* object = instance->getLOD(l);
+        IntersectContext newcontext((Scene*)object,user_context);
+        TRAV_COUNTER(context,instances += popcnt(valid_level));
+        object->intersectors.occluded(valid_level,ray,&newcontext);
+      });
       user_context->instID[0] = -1;
       ray.org = ray_org;
       ray.dir = ray_dir;
@@ -29,6 +29,36 @@ namespace embree
       __forceinline void operator() (vfloat<M>& u, vfloat<M>& v) const {}
     };
 
+    /* removes hits of a single ray on transparent micro triangles of opacity micromaps */
+    template<int M, int Mx, typename Hit>
+    __forceinline vbool<Mx> opacityMicromapMask(const vbool<Mx>& valid_i, Scene* scene, const vuint<M>& geomIDs, const vuint<M>& primIDs, Hit& hit)
+    {
+      vbool<Mx> valid = valid_i;
+      for (size_t m=movemask(valid_i), i=bsf(m); m!=0; m=btc(m,i), i=bsf(m))
+      {
+        const Geometry* geometry = scene->get(geomIDs[i]);
+        if (likely(!geometry->hasOpacityMicromap())) continue;
+        const Vec2f uv = hit.uv(i);
+        if (!((const TriangleMesh*)geometry)->opaque(primIDs[i],uv.x,uv.y))
+          clear(valid,i);
+      }
+      return valid;
+    }
+
+    /* removes hits of a ray packet on transparent micro triangles of the opacity micromap of a single primitive */
+    template<int K>
+    __forceinline vbool<K> opacityMicromapMaskK(const vbool<K>& valid_i, const Geometry* geometry, unsigned int primID, const vfloat<K>& u, const vfloat<K>& v)
+    {
+      if (likely(!geometry->hasOpacityMicromap())) return valid_i;
+      vbool<K> valid = valid_i;
+      for (size_t m=movemask(valid_i), k=bsf(m); m!=0; m=btc(m,k), k=bsf(m))
+      {
+        if (!((const TriangleMesh*)geometry)->opaque(primID,u[k],v[k]))
+          clear(valid,k);
+      }
+      return valid;
+    }
+
     template<bool filter>
     struct Intersect1Epilog1
     {
@@ -62,7 +92,7 @@ namespace embree
             const float old_t = ray.tfar;
             ray.tfar = hit.t;
             bool found = runIntersectionFilter1(geometry,ray,context,h);
-            if (!found) ray.tfar = old_t;
+            if (!found) ray.tfar = context->rejectTfar(old_t);
             return found;
           }
         }
@@ -244,6 +274,13 @@ namespace embree
         vbool<Mx> valid = valid_i;
         if (Mx > M) valid &= (1<<M)-1;
         hit.finalize();
+
+        /* opacity micromap test */
+        if (unlikely(scene->hasOpacityMicromaps())) {
+          valid = opacityMicromapMask(valid,scene,geomIDs,primIDs,hit);
+          if (unlikely(none(valid))) return false;
+        }
+
         size_t i = select_min(valid,hit.vt);
         unsigned int geomID = geomIDs[i];
 
@@ -277,7 +314,7 @@ namespace embree
               const float old_t = ray.tfar;
               ray.tfar = hit.t(i);
               const bool found = runIntersectionFilter1(geometry,ray,context,h);
-              if (!found) ray.tfar = old_t;
+              if (!found) ray.tfar = context->rejectTfar(old_t);
               foundhit |= found;
               clear(valid,i);
               valid &= hit.vt <= ray.tfar; // intersection filters may modify tfar value
@@ -328,6 +365,13 @@ namespace embree
         vbool<Mx> valid = valid_i;
         if (Mx > M) valid &= (1<<M)-1;
         hit.finalize();
+
+        /* opacity micromap test */
+        if (unlikely(scene->hasOpacityMicromaps())) {
+          valid = opacityMicromapMask(valid,scene,geomIDs,primIDs,hit);
+          if (unlikely(none(valid))) return false;
+        }
+
         size_t i = select_min(valid,hit.vt);
         unsigned int geomID = geomIDs[i];
 
@@ -361,7 +405,7 @@ namespace embree
               const float old_t = ray.tfar;
               ray.tfar = hit.t(i);
               const bool found = runIntersectionFilter1(geometry,ray,context,h);
-              if (!found) ray.tfar = old_t;
+              if (!found) ray.tfar = context->rejectTfar(old_t);
               foundhit |= found;
               clear(valid,i);
               valid &= hit.vt <= ray.tfar; // intersection filters may modify tfar value
@@ -400,12 +444,22 @@ namespace embree
       __forceinline bool operator() (const vbool<Mx>& valid_i, Hit& hit) const
       {
         Scene* scene = context->scene;
+
+        /* opacity micromap test */
+        vbool<Mx> valid_m = valid_i;
+        if (unlikely(scene->hasOpacityMicromaps())) {
+          if (Mx > M) valid_m &= (1<<M)-1;
+          hit.finalize();
+          valid_m = opacityMicromapMask(valid_m,scene,geomIDs,primIDs,hit);
+          if (unlikely(none(valid_m))) return false;
+        }
+
         /* intersection filter test */
 #if defined(EMBREE_FILTER_FUNCTION) || defined(EMBREE_RAY_MASK)
         if (unlikely(filter))
           hit.finalize(); /* called only once */
 
-        vbool<Mx> valid = valid_i;
+        vbool<Mx> valid = valid_m;
         if (Mx > M) valid &= (1<<M)-1;
         size_t m=movemask(valid);
         goto entry;
@@ -493,7 +547,7 @@ namespace embree
             ray.tfar = hit.t(i);
             HitK<1> h(context->instID,geomID,primID,uv.x,uv.y,hit.Ng(i));
             const bool found = runIntersectionFilter1(geometry,ray,context,h);
-            if (!found) ray.tfar = old_t;
+            if (!found) ray.tfar = context->rejectTfar(old_t);
             foundhit |= found;
             clear(valid,i);
             valid &= hit.vt <= ray.tfar; // intersection filters may modify tfar value
@@ -602,6 +656,10 @@ namespace embree
         if (unlikely(none(valid))) return false;
 #endif
 
+        /* opacity micromap test */
+        valid = opacityMicromapMaskK(valid,geometry,primID,u,v);
+        if (unlikely(none(valid))) return false;
+
         /* occlusion filter test */
 #if defined(EMBREE_FILTER_FUNCTION)
         if (filter) {
@@ -663,6 +721,16 @@ namespace embree
         if (unlikely(none(valid))) return valid;
 #endif
 
+        /* opacity micromap test */
+        if (unlikely(geometry->hasOpacityMicromap()))
+        {
+          vfloat<K> u, v, t;
+          Vec3vf<K> Ng;
+          std::tie(u,v,t,Ng) = hit();
+          valid = opacityMicromapMaskK(valid,geometry,primID,u,v);
+          if (unlikely(none(valid))) return valid;
+        }
+
         /* intersection filter test */
 #if defined(EMBREE_FILTER_FUNCTION)
         if (filter) {
@@ -717,6 +785,10 @@ namespace embree
         if (unlikely(none(valid))) return false;
 #endif
 
+        /* opacity micromap test */
+        valid = opacityMicromapMaskK(valid,geometry,primID,u,v);
+        if (unlikely(none(valid))) return false;
+
         /* intersection filter test */
 #if defined(EMBREE_FILTER_FUNCTION)
         if (filter) {
@@ -773,6 +845,16 @@ namespace embree
         if (unlikely(none(valid))) return false;
 #endif
 
+        /* opacity micromap test */
+        if (unlikely(geometry->hasOpacityMicromap()))
+        {
+          vfloat<K> u, v, t;
+          Vec3vf<K> Ng;
+          std::tie(u,v,t,Ng) = hit();
+          valid = opacityMicromapMaskK(valid,geometry,primID,u,v);
+          if (unlikely(none(valid))) return false;
+        }
+
         /* occlusion filter test */
 #if defined(EMBREE_FILTER_FUNCTION)
         if (filter) {
@@ -818,6 +900,13 @@ namespace embree
         vbool<Mx> valid = valid_i;
         hit.finalize();
         if (Mx > M) valid &= (1<<M)-1;
+
+        /* opacity micromap test */
+        if (unlikely(scene->hasOpacityMicromaps())) {
+          valid = opacityMicromapMask(valid,scene,geomIDs,primIDs,hit);
+          if (unlikely(none(valid))) return false;
+        }
+
         size_t i = select_min(valid,hit.vt);
         assert(i<M);
         unsigned int geomID = geomIDs[i];
@@ -905,12 +994,21 @@ namespace embree
       {
         Scene* scene = context->scene;
 
+        /* opacity micromap test */
+        vbool<Mx> valid_m = valid_i;
+        if (unlikely(scene->hasOpacityMicromaps())) {
+          if (Mx > M) valid_m &= (1<<M)-1;
+          hit.finalize();
+          valid_m = opacityMicromapMask(valid_m,scene,geomIDs,primIDs,hit);
+          if (unlikely(none(valid_m))) return false;
+        }
+
         /* intersection filter test */
 #if defined(EMBREE_FILTER_FUNCTION) || defined(EMBREE_RAY_MASK)
         if (unlikely(filter))
           hit.finalize(); /* called only once */
 
-        vbool<Mx> valid = valid_i;
+        vbool<Mx> valid = valid_m;
         if (Mx > M) valid &= (1<<M)-1;
         size_t m=movemask(valid);
         goto entry;
@@ -135,5 +135,130 @@ namespace embree
           return epilog(valid,hit);
         }
       };
+
+    template<int M>
+      struct RoundLinearCurveIntersector
+      {
+        /* intersects the ray with the linear swept sphere (cone with spherical end caps) in closed form */
+        static __forceinline vbool<M> intersect(const vbool<M>& valid_i,
+                                               const Vec3vf<M>& ray_org, const Vec3vf<M>& ray_dir, const vfloat<M>& depth_scale,
+                                               const vfloat<M>& ray_tnear, const vfloat<M>& ray_tfar,
+                                               const Vec4vf<M>& v0, const Vec4vf<M>& v1,
+                                               LineIntersectorHitM<M>& hit)
+        {
+          /* we operate on the normalized ray direction */
+          const Vec3vf<M> rd = ray_dir*depth_scale;
+          const vfloat<M> ra = v0.w;
+          const vfloat<M> rb = v1.w;
+          const Vec3vf<M> ba = v1.xyz()-v0.xyz();
+          const Vec3vf<M> oa = ray_org-v0.xyz();
+          const Vec3vf<M> ob = ray_org-v1.xyz();
+          const vfloat<M> rr = ra-rb;
+          const vfloat<M> m0 = dot(ba,ba);
+          const vfloat<M> m1 = dot(ba,oa);
+          const vfloat<M> m2 = dot(ba,rd);
+          const vfloat<M> m3 = dot(rd,oa);
+          const vfloat<M> m5 = dot(oa,oa);
+          const vfloat<M> m6 = dot(ob,rd);
+          const vfloat<M> m7 = dot(ob,ob);
+
+          /* intersect with cone between the two spheres */
+          const vfloat<M> d2 = m0-rr*rr;
+          const vfloat<M> k2 = d2-m2*m2;
+          const vfloat<M> k1 = d2*m3-m1*m2+m2*rr*ra;
+          const vfloat<M> k0 = d2*m5-m1*m1+2.0f*m1*rr*ra-m0*ra*ra;
+          const vfloat<M> h  = k1*k1-k0*k2;
+          const vfloat<M> sqrt_h = sqrt(max(h,vfloat<M>(zero)));
+          const vfloat<M> rcp_k2 = rcp(k2);
+          const vfloat<M> tc0 = (-sqrt_h-k1)*rcp_k2;
+          const vfloat<M> tc1 = (+sqrt_h-k1)*rcp_k2;
+          const vfloat<M> yc0 = madd(tc0,m2,m1-ra*rr);
+          const vfloat<M> yc1 = madd(tc1,m2,m1-ra*rr);
+          const vbool<M> valid_c0 = (h >= 0.0f) & (yc0 > 0.0f) & (yc0 < d2);
+          const vbool<M> valid_c1 = (h >= 0.0f) & (yc1 > 0.0f) & (yc1 < d2);
+
+          /* intersect with spheres at start and end point */
+          const vfloat<M> ha = m3*m3-m5+ra*ra;
+          const vfloat<M> hb = m6*m6-m7+rb*rb;
+          const vfloat<M> sqrt_ha = sqrt(max(ha,vfloat<M>(zero)));
+          const vfloat<M> sqrt_hb = sqrt(max(hb,vfloat<M>(zero)));
+          const vbool<M> valid_a = ha >= 0.0f;
+          const vbool<M> valid_b = hb >= 0.0f;
+          const vfloat<M> ta0 = -m3-sqrt_ha, ta1 = -m3+sqrt_ha;
+          const vfloat<M> tb0 = -m6-sqrt_hb, tb1 = -m6+sqrt_hb;
+
+          /* the shape is convex, thus entry and exit distance are the min and max over all parts */
+          vfloat<M> t_in = select(valid_c0,tc0,vfloat<M>(pos_inf));
+          t_in = min(t_in,select(valid_c1,tc1,vfloat<M>(pos_inf)));
+          t_in = min(t_in,select(valid_a,ta0,vfloat<M>(pos_inf)));
+          t_in = min(t_in,select(valid_b,tb0,vfloat<M>(pos_inf)));
+          vfloat<M> t_out = select(valid_c0,tc0,vfloat<M>(neg_inf));
+          t_out = max(t_out,select(valid_c1,tc1,vfloat<M>(neg_inf)));
+          t_out = max(t_out,select(valid_a,ta1,vfloat<M>(neg_inf)));
+          t_out = max(t_out,select(valid_b,tb1,vfloat<M>(neg_inf)));
+
+          /* use entry point if in ray range, otherwise exit point */
+          const vfloat<M> tr_in  = t_in *depth_scale;
+          const vfloat<M> tr_out = t_out*depth_scale;
+          const vbool<M> valid_hit = valid_i & (valid_c0 | valid_c1 | valid_a | valid_b);
+          const vbool<M> valid_in  = valid_hit & (ray_tnear < tr_in ) & (tr_in  <= ray_tfar);
+          const vbool<M> valid_out = valid_hit & !valid_in & (ray_tnear < tr_out) & (tr_out <= ray_tfar);
+          const vbool<M> valid = valid_in | valid_out;
+          if (unlikely(none(valid))) return valid;
+          const vfloat<M> t = select(valid_in,t_in,t_out);
+
+          /* calculate curve parameter and geometry normal of the part we hit */
+          const vbool<M> hit_cone = (valid_c0 & (t == tc0)) | (valid_c1 & (t == tc1));
+          const vbool<M> hit_b = !hit_cone & valid_b & ((t == tb0) | (t == tb1));
+          const Vec3vf<M> pa = oa+t*rd;
+          const Vec3vf<M> pb = ob+t*rd;
+          const vfloat<M> y = madd(t,m2,m1-ra*rr);
+          const Vec3vf<M> Ng_cone = d2*pa-ba*y;
+          const vfloat<M> u = select(hit_cone,clamp(y*rcp(d2),vfloat<M>(zero),vfloat<M>(one)),select(hit_b,vfloat<M>(one),vfloat<M>(zero)));
+          const Vec3vf<M> Ng = select(hit_cone,Ng_cone,select(hit_b,pb,pa));
+          hit = LineIntersectorHitM<M>(u,zero,select(valid_in,tr_in,tr_out),Ng);
+          return valid;
+        }
+      };
+
+    template<int M>
+      struct RoundLinearCurveIntersector1
+      {
+        typedef CurvePrecalculations1 Precalculations;
+
+        template<typename Epilog>
+        static __forceinline bool intersect(const vbool<M>& valid_i,
+                                            Ray& ray, const Precalculations& pre,
+                                            const Vec4vf<M>& v0, const Vec4vf<M>& v1,
+                                            const Epilog& epilog)
+        {
+          LineIntersectorHitM<M> hit;
+          const vbool<M> valid = RoundLinearCurveIntersector<M>::intersect(valid_i,Vec3vf<M>(ray.org),Vec3vf<M>(ray.dir),vfloat<M>(pre.depth_scale),
+                                                                           vfloat<M>(ray.tnear()),vfloat<M>(ray.tfar),v0,v1,hit);
+          if (unlikely(none(valid))) return false;
+          return epilog(valid,hit);
+        }
+      };
+
+    template<int M, int K>
+      struct RoundLinearCurveIntersectorK
+      {
+        typedef CurvePrecalculationsK<K> Precalculations;
+
+        template<typename Epilog>
+        static __forceinline bool intersect(const vbool<M>& valid_i,
+                                            RayK<K>& ray, size_t k, const Precalculations& pre,
+                                            const Vec4vf<M>& v0, const Vec4vf<M>& v1,
+                                            const Epilog& epilog)
+        {
+          const Vec3vf<M> ray_org(ray.org.x[k],ray.org.y[k],ray.org.z[k]);
+          const Vec3vf<M> ray_dir(ray.dir.x[k],ray.dir.y[k],ray.dir.z[k]);
+          LineIntersectorHitM<M> hit;
+          const vbool<M> valid = RoundLinearCurveIntersector<M>::intersect(valid_i,ray_org,ray_dir,vfloat<M>(pre.depth_scale[k]),
+                                                                           vfloat<M>(ray.tnear()[k]),vfloat<M>(ray.tfar[k]),v0,v1,hit);
+          if (unlikely(none(valid))) return false;
+          return epilog(valid,hit);
+        }
+      };
   }
 }
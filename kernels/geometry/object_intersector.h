@@ -17,6 +17,7 @@
 #pragma once
 
 #include "object.h"
+#include "intersector_iterators.h"
 #include "../common/ray.h"
 
 namespace embree
@@ -121,6 +122,169 @@ namespace embree
       }
     };
 
+    /*! collects the primitive IDs of all objects of a leaf that belong to the geometry of the i'th object, and removes them from the todo mask */
+    __forceinline size_t gatherObjects(const Object* prim, size_t i, size_t& todo, unsigned int* primIDs)
+    {
+      const unsigned int geomID = prim[i].geomID();
+      size_t num = 0;
+      primIDs[num++] = prim[i].primID();
+      for (size_t bits=todo; bits!=0; )
+      {
+        const size_t j = bscf(bits);
+        if (prim[j].geomID() != geomID) continue;
+        primIDs[num++] = prim[j].primID();
+        todo = btc(todo,j);
+      }
+      return num;
+    }
+
+    /*! intersects a leaf of objects, user geometries with batched callbacks see all their primitives of the leaf in a single invocation */
+    template<bool mblur>
+    struct ObjectArrayIntersector1 : public ArrayIntersector1<ObjectIntersector1<mblur>>
+    {
+      typedef ObjectIntersector1<mblur> Intersector;
+      typedef typename Intersector::Primitive Primitive;
+      typedef typename Intersector::Precalculations Precalculations;
+
+      template<int N, int Nx, bool robust>
+      static __forceinline void intersect(const Accel::Intersectors* This, Precalculations& pre, RayHit& ray, IntersectContext* context, const Primitive* prim, size_t num, const TravRay<N,Nx,robust> &tray, size_t& lazy_node)
+      {
+        assert(num < 8*sizeof(size_t));
+        for (size_t todo=((size_t)1 << num)-1; todo!=0; )
+        {
+          const size_t i = bscf(todo);
+          AccelSet* accel = (AccelSet*) context->scene->get(prim[i].geomID());
+          if (likely(!accel->intersectBatched)) {
+            Intersector::intersect(pre,ray,context,prim[i]);
+            continue;
+          }
+
+          unsigned int primIDs[8*sizeof(size_t)];
+          const size_t numPrimIDs = gatherObjects(prim,i,todo,primIDs);
+
+          /* perform ray mask test */
+#if defined(EMBREE_RAY_MASK)
+          if ((ray.mask & accel->mask) == 0) 
+            continue;
+#endif
+          accel->intersect(ray,primIDs,numPrimIDs,context,reportIntersection1);
+        }
+      }
+
+      template<int N, int Nx, bool robust>
+      static __forceinline bool occluded(const Accel::Intersectors* This, Precalculations& pre, Ray& ray, IntersectContext* context, const Primitive* prim, size_t num, const TravRay<N,Nx,robust> &tray, size_t& lazy_node)
+      {
+        assert(num < 8*sizeof(size_t));
+        for (size_t todo=((size_t)1 << num)-1; todo!=0; )
+        {
+          const size_t i = bscf(todo);
+          AccelSet* accel = (AccelSet*) context->scene->get(prim[i].geomID());
+          if (likely(!accel->occludedBatched)) {
+            if (Intersector::occluded(pre,ray,context,prim[i]))
+              return true;
+            continue;
+          }
+
+          unsigned int primIDs[8*sizeof(size_t)];
+          const size_t numPrimIDs = gatherObjects(prim,i,todo,primIDs);
+
+          /* perform ray mask test */
+#if defined(EMBREE_RAY_MASK)
+          if ((ray.mask & accel->mask) == 0) 
+            continue;
+#endif
+          accel->occluded(ray,primIDs,numPrimIDs,context,&reportOcclusion1);
+          if (ray.tfar < 0.0f)
+            return true;
+        }
+        return false;
+      }
+    };
+
+    template<int K, bool mblur>
+    struct ObjectArrayIntersectorK_1
+    {
+      typedef ObjectIntersectorK<K,mblur> Intersector;
+      typedef typename Intersector::Primitive Primitive;
+      typedef typename Intersector::Precalculations Precalculations;
+
+      static __forceinline void intersect(const vbool<K>& valid_i, Precalculations& pre, RayHitK<K>& ray, IntersectContext* context, const Primitive* prim, size_t num)
+      {
+        assert(num < 8*sizeof(size_t));
+        for (size_t todo=((size_t)1 << num)-1; todo!=0; )
+        {
+          const size_t i = bscf(todo);
+          AccelSet* accel = (AccelSet*) context->scene->get(prim[i].geomID());
+          if (likely(!accel->intersectBatched)) {
+            Intersector::intersect(valid_i,pre,ray,context,prim[i]);
+            continue;
+          }
+
+          unsigned int primIDs[8*sizeof(size_t)];
+          const size_t numPrimIDs = gatherObjects(prim,i,todo,primIDs);
+
+          /* perform ray mask test */
+          vbool<K> valid = valid_i;
+#if defined(EMBREE_RAY_MASK)
+          valid &= (ray.mask & accel->mask) != 0;
+          if (none(valid)) continue;
+#endif
+          accel->intersect(valid,ray,primIDs,numPrimIDs,context,&reportIntersection1);
+        }
+      }
+
+      static __forceinline vbool<K> occluded(const vbool<K>& valid, Precalculations& pre, RayK<K>& ray, IntersectContext* context, const Primitive* prim, size_t num)
+      {
+        assert(num < 8*sizeof(size_t));
+        vbool<K> valid0 = valid;
+        for (size_t todo=((size_t)1 << num)-1; todo!=0; )
+        {
+          const size_t i = bscf(todo);
+          AccelSet* accel = (AccelSet*) context->scene->get(prim[i].geomID());
+          if (likely(!accel->occludedBatched)) {
+            valid0 &= !Intersector::occluded(valid0,pre,ray,context,prim[i]);
+            if (none(valid0)) break;
+            continue;
+          }
+
+          unsigned int primIDs[8*sizeof(size_t)];
+          const size_t numPrimIDs = gatherObjects(prim,i,todo,primIDs);
+
+          /* perform ray mask test */
+          vbool<K> valid1 = valid0;
+#if defined(EMBREE_RAY_MASK)
+          valid1 &= (ray.mask & accel->mask) != 0;
+          if (none(valid1)) continue;
+#endif
+          accel->occluded(valid1,ray,primIDs,numPrimIDs,context,&reportOcclusion1);
+          valid0 &= ray.tfar >= 0.0f;
+          if (none(valid0)) break;
+        }
+        return !valid0;
+      }
+
+      template<bool robust>
+      static __forceinline void intersect(const vbool<K>& valid, const Accel::Intersectors* This, Precalculations& pre, RayHitK<K>& ray, IntersectContext* context, const Primitive* prim, size_t num, const TravRayK<K, robust> &tray, size_t& lazy_node) {
+        intersect(valid,pre,ray,context,prim,num);
+      }
+
+      template<bool robust>
+      static __forceinline vbool<K> occluded(const vbool<K>& valid, const Accel::Intersectors* This, Precalculations& pre, RayK<K>& ray, IntersectContext* context, const Primitive* prim, size_t num, const TravRayK<K, robust> &tray, size_t& lazy_node) {
+        return occluded(valid,pre,ray,context,prim,num);
+      }
+
+      template<int N, int Nx, bool robust>
+      static __forceinline void intersect(const Accel::Intersectors* This, Precalculations& pre, RayHitK<K>& ray, size_t k, IntersectContext* context, const Primitive* prim, size_t num, const TravRay<N,Nx,robust> &tray, size_t& lazy_node) {
+        intersect(vbool<K>(1<<int(k)),pre,ray,context,prim,num);
+      }
+
+      template<int N, int Nx, bool robust>
+      static __forceinline bool occluded(const Accel::Intersectors* This, Precalculations& pre, RayK<K>& ray, size_t k, IntersectContext* context, const Primitive* prim, size_t num, const TravRay<N,Nx,robust> &tray, size_t& lazy_node) {
+        occluded(vbool<K>(1<<int(k)),pre,ray,context,prim,num);
+        return ray.tfar[k] < 0.0f;
+      }
+    };
+
     typedef ObjectIntersectorK<4,false>  ObjectIntersector4;
     typedef ObjectIntersectorK<8,false>  ObjectIntersector8;
     typedef ObjectIntersectorK<16,false> ObjectIntersector16;
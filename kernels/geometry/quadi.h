@@ -79,8 +79,12 @@ namespace embree
     __forceinline const vuint<M>& primID() const { return primIDs; }
     __forceinline unsigned int primID(const size_t i) const { assert(i<M); return primIDs[i]; }
 
-    __forceinline Vec3f& getVertex(const vuint<M>& v, const size_t index, const Scene *const scene) const
+    __forceinline Vec3f getVertex(const vuint<M>& v, const size_t index, const Scene *const scene) const
     {
+      if (unlikely(scene->compressedVertices)) {
+        const Vec3fa p = scene->get<QuadMesh>(geomID(index))->leafVertex(v[index],0);
+        return Vec3f(p.x,p.y,p.z);
+      }
       const float* vertices = scene->vertices[geomID(index)];
       return (Vec3f&) vertices[v[index]];
     }
@@ -89,10 +93,8 @@ namespace embree
     __forceinline Vec3<T> getVertex(const vuint<M> &v, const size_t index, const Scene *const scene, const size_t itime, const T& ftime) const
     {
       const QuadMesh* mesh = scene->get<QuadMesh>(geomID(index));
-      const float* vertices0 = (const float*) mesh->vertexPtr(0,itime+0);
-      const float* vertices1 = (const float*) mesh->vertexPtr(0,itime+1);
-      const Vec3fa v0 = Vec3fa::loadu(vertices0+v[index]);
-      const Vec3fa v1 = Vec3fa::loadu(vertices1+v[index]);
+      const Vec3fa v0 = mesh->leafVertex(v[index],itime+0);
+      const Vec3fa v1 = mesh->leafVertex(v[index],itime+1);
       const Vec3<T> p0(v0.x,v0.y,v0.z);
       const Vec3<T> p1(v1.x,v1.y,v1.z);
       return lerp(p0,p1,ftime);
@@ -106,10 +108,8 @@ namespace embree
 
       for (size_t mask=movemask(valid), i=bsf(mask); mask; mask=btc(mask,i), i=bsf(mask))
       {
-        const float* vertices0 = (const float*) mesh->vertexPtr(0,itime[i]+0);
-        const float* vertices1 = (const float*) mesh->vertexPtr(0,itime[i]+1);
-        const Vec3fa v0 = Vec3fa::loadu(vertices0+v[index]);
-        const Vec3fa v1 = Vec3fa::loadu(vertices1+v[index]);
+        const Vec3fa v0 = mesh->leafVertex(v[index],itime[i]+0);
+        const Vec3fa v1 = mesh->leafVertex(v[index],itime[i]+1);
         p0.x[i] = v0.x; p0.y[i] = v0.y; p0.z[i] = v0.z;
         p1.x[i] = v1.x; p1.y[i] = v1.y; p1.z[i] = v1.z;
       }
@@ -123,6 +123,23 @@ namespace embree
                               Vec3vf<M>& p3,
                               const Scene *const scene) const;
 
+    /* Gather the quads lane by lane, required when the scene contains compressed vertices */
+    __forceinline void gatherCompressed(Vec3vf<M>& p0, Vec3vf<M>& p1, Vec3vf<M>& p2, Vec3vf<M>& p3, const Scene* const scene, const QuadMesh* mesh, const size_t itime) const
+    {
+      for (size_t i=0; i<M; i++)
+      {
+        const QuadMesh* m = mesh ? mesh : scene->get<QuadMesh>(geomID(i));
+        const Vec3fa a = m->leafVertex(v0[i],itime);
+        const Vec3fa b = m->leafVertex(v1[i],itime);
+        const Vec3fa c = m->leafVertex(v2[i],itime);
+        const Vec3fa d = m->leafVertex(v3[i],itime);
+        p0.x[i] = a.x; p0.y[i] = a.y; p0.z[i] = a.z;
+        p1.x[i] = b.x; p1.y[i] = b.y; p1.z[i] = b.z;
+        p2.x[i] = c.x; p2.y[i] = c.y; p2.z[i] = c.z;
+        p3.x[i] = d.x; p3.y[i] = d.y; p3.z[i] = d.z;
+      }
+    }
+
 #if defined(__AVX512F__)
     __forceinline void gather(Vec3vf16& p0,
                               Vec3vf16& p1,
@@ -183,11 +200,11 @@ namespace embree
       BBox3fa bounds = empty;
       for (size_t i=0; i<M && valid(i); i++)
       {
-        const float* vertices = (const float*) scene->get<QuadMesh>(geomID(i))->vertexPtr(0,itime);
-        bounds.extend(Vec3fa::loadu(vertices+v0[i]));
-        bounds.extend(Vec3fa::loadu(vertices+v1[i]));
-        bounds.extend(Vec3fa::loadu(vertices+v2[i]));
-        bounds.extend(Vec3fa::loadu(vertices+v3[i]));
+        const QuadMesh* mesh = scene->get<QuadMesh>(geomID(i));
+        bounds.extend(mesh->leafVertex(v0[i],itime));
+        bounds.extend(mesh->leafVertex(v1[i],itime));
+        bounds.extend(mesh->leafVertex(v2[i],itime));
+        bounds.extend(mesh->leafVertex(v3[i],itime));
       }
       return bounds;
     }
@@ -235,7 +252,7 @@ namespace embree
         if (begin<end) {
           geomID[i] = prim->geomID();
           primID[i] = prim->primID();
-          unsigned int_stride = mesh->vertices0.getStride()/4;
+          unsigned int_stride = mesh->leafVertexStride();
           v0[i] = q.v[0] * int_stride;
           v1[i] = q.v[1] * int_stride;
           v2[i] = q.v[2] * int_stride;
@@ -312,6 +329,10 @@ namespace embree
   {
     prefetchL1(((char*)this)+0*64);
     prefetchL1(((char*)this)+1*64);
+    if (unlikely(scene->compressedVertices)) {
+      gatherCompressed(p0,p1,p2,p3,scene,nullptr,0);
+      return;
+    }
     const float* vertices0 = scene->vertices[geomID(0)];
     const float* vertices1 = scene->vertices[geomID(1)];
     const float* vertices2 = scene->vertices[geomID(2)];
@@ -346,6 +367,15 @@ namespace embree
                                        Vec3vf16& p3,
                                        const Scene *const scene) const // FIXME: why do we have this special path here and not for triangles?
   {
+    if (unlikely(scene->compressedVertices))
+    {
+      Vec3vf4 a0,a1,a2,a3; gatherCompressed(a0,a1,a2,a3,scene,nullptr,0);
+      p0 = Vec3vf16(vfloat16(a0.x,a0.x,a0.x,a0.x),vfloat16(a0.y,a0.y,a0.y,a0.y),vfloat16(a0.z,a0.z,a0.z,a0.z));
+      p1 = Vec3vf16(vfloat16(a1.x,a1.x,a1.x,a1.x),vfloat16(a1.y,a1.y,a1.y,a1.y),vfloat16(a1.z,a1.z,a1.z,a1.z));
+      p2 = Vec3vf16(vfloat16(a2.x,a2.x,a2.x,a2.x),vfloat16(a2.y,a2.y,a2.y,a2.y),vfloat16(a2.z,a2.z,a2.z,a2.z));
+      p3 = Vec3vf16(vfloat16(a3.x,a3.x,a3.x,a3.x),vfloat16(a3.y,a3.y,a3.y,a3.y),vfloat16(a3.z,a3.z,a3.z,a3.z));
+      return;
+    }
     const vint16 perm(0,4,8,12,1,5,9,13,2,6,10,14,3,7,11,15);
     const float* vertices0 = scene->vertices[geomID(0)];
     const float* vertices1 = scene->vertices[geomID(1)];
@@ -402,6 +432,10 @@ namespace embree
                                        const QuadMesh* mesh,
                                        const int itime) const
   {
+    if (unlikely(mesh->compressedVertices())) {
+      gatherCompressed(p0,p1,p2,p3,nullptr,mesh,itime);
+      return;
+    }
     const float* vertices0 = (const float*) mesh->vertexPtr(0,itime);
     const float* vertices1 = (const float*) mesh->vertexPtr(0,itime);
     const float* vertices2 = (const float*) mesh->vertexPtr(0,itime);
@@ -55,12 +55,67 @@ namespace embree
         return false;
       }
 
+      /*! The corners of a grid stored as a 2x2 grid. */
+      struct GridCorners
+      {
+        __forceinline GridCorners (const Primitive* grid)
+        {
+          const float* const grid_x = grid->gridData(0);
+          const size_t w = grid->width;
+          const size_t h = grid->height;
+          const size_t index[4] = { 0, w-1, (h-1)*w, h*w-1 };
+          for (size_t d=0; d<4; d++) {
+            for (size_t i=0; i<4; i++) data[d][i] = grid_x[d*grid->dim_offset+index[i]];
+            for (size_t i=4; i<8; i++) data[d][i] = 0.0f; // padding for the gather
+          }
+        }
+
+        __forceinline Vec3fa vertex(size_t i) const {
+          return Vec3fa(data[0][i],data[1][i],data[2][i]);
+        }
+
+        float data[4][8]; //!< x, y, z, and uv of the 4 corners
+      };
+
+      /*! Returns true if the ray cone is wider than the grid, in which case only the corners of the grid are intersected. */
+      static __forceinline bool coarseLOD(const Ray& ray, IntersectContext* context, const GridCorners& corners)
+      {
+        const Vec3fa p0 = corners.vertex(0), p1 = corners.vertex(1), p2 = corners.vertex(2), p3 = corners.vertex(3);
+        const float extent = max(length(p3-p0),length(p2-p1));
+        return context->coneWidth(ray.org,ray.dir,0.25f*(p0+p1+p2+p3)) >= extent;
+      }
+
+      static __forceinline void intersectCorners(RayHit& ray, IntersectContext* context, const Primitive* prim, const GridCorners& corners)
+      {
+        Vec3vf4 v0, v1, v2;
+        GridSOA::Gather2x3::gather(corners.data[0],corners.data[1],corners.data[2],2,2,v0,v1,v2);
+        GridSOA::MapUV<GridSOA::Gather2x3> mapUV(corners.data[3],2,2);
+        PlueckerIntersector1<4> intersector(ray,nullptr);
+        intersector.intersect(ray,v0,v1,v2,mapUV,Intersect1EpilogMU<4,true>(ray,context,prim->geomID(),prim->primID()));
+      }
+
+      static __forceinline bool occludedCorners(Ray& ray, IntersectContext* context, const Primitive* prim, const GridCorners& corners)
+      {
+        Vec3vf4 v0, v1, v2;
+        GridSOA::Gather2x3::gather(corners.data[0],corners.data[1],corners.data[2],2,2,v0,v1,v2);
+        GridSOA::MapUV<GridSOA::Gather2x3> mapUV(corners.data[3],2,2);
+        PlueckerIntersector1<4> intersector(ray,nullptr);
+        return intersector.intersect(ray,v0,v1,v2,mapUV,Occluded1EpilogMU<4,true>(ray,context,prim->geomID(),prim->primID()));
+      }
+
       /*! Intersect a ray with the primitive. */
       template<int N, int Nx, bool robust>
         static __forceinline void intersect(const Accel::Intersectors* This, Precalculations& pre, RayHit& ray, IntersectContext* context, const Primitive* prim, size_t ty, const TravRay<N,Nx,robust> &tray, size_t& lazy_node) 
       {
         if (likely(ty == 0)) GridSOAIntersector1::intersect(pre,ray,context,prim,lazy_node);
-        else                 processLazyNode(pre,context,prim,lazy_node);
+        else if (unlikely(context->cone)) 
+        {
+          /* grids narrower than the ray cone are not descended into */
+          const GridCorners corners(prim);
+          if (coarseLOD(ray,context,corners)) intersectCorners(ray,context,prim,corners);
+          else processLazyNode(pre,context,prim,lazy_node);
+        }
+        else processLazyNode(pre,context,prim,lazy_node);
       }
 
       template<int N, int Nx, bool robust>
@@ -73,7 +128,14 @@ namespace embree
       static __forceinline bool occluded(const Accel::Intersectors* This, Precalculations& pre, Ray& ray, IntersectContext* context, const Primitive* prim, size_t ty, const TravRay<N,Nx,robust> &tray, size_t& lazy_node)
       {
         if (likely(ty == 0)) return GridSOAIntersector1::occluded(pre,ray,context,prim,lazy_node);
-        else                 return processLazyNode(pre,context,prim,lazy_node);
+        else if (unlikely(context->cone))
+        {
+          /* grids narrower than the ray cone are not descended into */
+          const GridCorners corners(prim);
+          if (coarseLOD(ray,context,corners)) return occludedCorners(ray,context,prim,corners);
+          else return processLazyNode(pre,context,prim,lazy_node);
+        }
+        else return processLazyNode(pre,context,prim,lazy_node);
       }
 
       template<int N, int Nx, bool robust>
@@ -77,8 +77,12 @@ namespace embree
     __forceinline unsigned int primID(const size_t i) const { assert(i<M); return primIDs[i]; }
 
     /* loads a single vertex */
-    __forceinline Vec3f& getVertex(const vuint<M>& v, const size_t index, const Scene *const scene) const
+    __forceinline Vec3f getVertex(const vuint<M>& v, const size_t index, const Scene *const scene) const
     {
+      if (unlikely(scene->compressedVertices)) {
+        const Vec3fa p = scene->get<TriangleMesh>(geomID(index))->leafVertex(v[index],0);
+        return Vec3f(p.x,p.y,p.z);
+      }
       const float* vertices = scene->vertices[geomID(index)];
       return (Vec3f&) vertices[v[index]];
     }
@@ -87,10 +91,8 @@ namespace embree
     __forceinline Vec3<T> getVertex(const vuint<M>& v, const size_t index, const Scene *const scene, const size_t itime, const T& ftime) const
     {
       const TriangleMesh* mesh = scene->get<TriangleMesh>(geomID(index));
-      const float* vertices0 = (const float*) mesh->vertexPtr(0,itime+0);
-      const float* vertices1 = (const float*) mesh->vertexPtr(0,itime+1);
-      const Vec3fa v0 = Vec3fa::loadu(vertices0+v[index]);
-      const Vec3fa v1 = Vec3fa::loadu(vertices1+v[index]);
+      const Vec3fa v0 = mesh->leafVertex(v[index],itime+0);
+      const Vec3fa v1 = mesh->leafVertex(v[index],itime+1);
       const Vec3<T> p0(v0.x,v0.y,v0.z);
       const Vec3<T> p1(v1.x,v1.y,v1.z);
       return lerp(p0,p1,ftime);
@@ -104,10 +106,8 @@ namespace embree
 
       for (size_t mask=movemask(valid), i=bsf(mask); mask; mask=btc(mask,i), i=bsf(mask))
       {
-        const float* vertices0 = (const float*) mesh->vertexPtr(0,itime[i]+0);
-        const float* vertices1 = (const float*) mesh->vertexPtr(0,itime[i]+1);
-        const Vec3fa v0 = Vec3fa::loadu(vertices0+v[index]);
-        const Vec3fa v1 = Vec3fa::loadu(vertices1+v[index]);
+        const Vec3fa v0 = mesh->leafVertex(v[index],itime[i]+0);
+        const Vec3fa v1 = mesh->leafVertex(v[index],itime[i]+1);
         p0.x[i] = v0.x; p0.y[i] = v0.y; p0.z[i] = v0.z;
         p1.x[i] = v1.x; p1.y[i] = v1.y; p1.z[i] = v1.z;
       }
@@ -117,6 +117,21 @@ namespace embree
     /* Gather the triangles */
     __forceinline void gather(Vec3vf<M>& p0, Vec3vf<M>& p1, Vec3vf<M>& p2, const Scene* const scene) const;
 
+    /* Gather the triangles lane by lane, required when the scene contains compressed vertices */
+    __forceinline void gatherCompressed(Vec3vf<M>& p0, Vec3vf<M>& p1, Vec3vf<M>& p2, const Scene* const scene, const TriangleMesh* mesh, const size_t itime) const
+    {
+      for (size_t i=0; i<M; i++)
+      {
+        const TriangleMesh* m = mesh ? mesh : scene->get<TriangleMesh>(geomID(i));
+        const Vec3fa a = m->leafVertex(v0[i],itime);
+        const Vec3fa b = m->leafVertex(v1[i],itime);
+        const Vec3fa c = m->leafVertex(v2[i],itime);
+        p0.x[i] = a.x; p0.y[i] = a.y; p0.z[i] = a.z;
+        p1.x[i] = b.x; p1.y[i] = b.y; p1.z[i] = b.z;
+        p2.x[i] = c.x; p2.y[i] = c.y; p2.z[i] = c.z;
+      }
+    }
+
     template<int K>
     __forceinline void gather(const vbool<K>& valid,
                               Vec3vf<K>& p0,
@@ -162,10 +177,10 @@ namespace embree
       BBox3fa bounds = empty;
       for (size_t i=0; i<M && valid(i); i++)
       {
-        const float* vertices = (const float*) scene->get<TriangleMesh>(geomID(i))->vertexPtr(0,itime);
-        bounds.extend(Vec3fa::loadu(vertices+v0[i]));
-        bounds.extend(Vec3fa::loadu(vertices+v1[i]));
-        bounds.extend(Vec3fa::loadu(vertices+v2[i]));
+        const TriangleMesh* mesh = scene->get<TriangleMesh>(geomID(i));
+        bounds.extend(mesh->leafVertex(v0[i],itime));
+        bounds.extend(mesh->leafVertex(v1[i],itime));
+        bounds.extend(mesh->leafVertex(v2[i],itime));
       }
       return bounds;
     }
@@ -222,7 +237,7 @@ namespace embree
         if (begin<end) {
           geomID[i] = prim->geomID();
           primID[i] = prim->primID();
-          unsigned int int_stride = mesh->vertices0.getStride()/4;
+          unsigned int int_stride = mesh->leafVertexStride();
           v0[i] = tri.v[0] * int_stride;
           v1[i] = tri.v[1] * int_stride;
           v2[i] = tri.v[2] * int_stride;
@@ -287,6 +302,10 @@ namespace embree
                                            Vec3vf4& p2,
                                            const Scene* const scene) const
   {
+    if (unlikely(scene->compressedVertices)) {
+      gatherCompressed(p0,p1,p2,scene,nullptr,0);
+      return;
+    }
     const float* vertices0 = scene->vertices[geomID(0)];
     const float* vertices1 = scene->vertices[geomID(1)];
     const float* vertices2 = scene->vertices[geomID(2)];
@@ -315,6 +334,10 @@ namespace embree
                                            const TriangleMesh* mesh,
                                            const int itime) const
   {
+    if (unlikely(mesh->compressedVertices())) {
+      gatherCompressed(p0,p1,p2,nullptr,mesh,itime);
+      return;
+    }
     const float* vertices = (const float*) mesh->vertexPtr(0,itime);
     const vfloat4 a0 = vfloat4::loadu(vertices + v0[0]);
     const vfloat4 a1 = vfloat4::loadu(vertices + v0[1]);
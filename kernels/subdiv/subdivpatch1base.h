@@ -158,12 +158,5 @@ namespace embree
                   float *__restrict__ const grid_u,
                   float *__restrict__ const grid_v,
                   const SubdivMesh* const geom);
-
-    /* eval grid over patch and stich edges when required */      
-    BBox3fa evalGridBounds(const SubdivPatch1Base& patch,
-                           const unsigned x0, const unsigned x1,
-                           const unsigned y0, const unsigned y1,
-                           const unsigned swidth, const unsigned sheight,
-                           const SubdivMesh* const geom);
   }
 }
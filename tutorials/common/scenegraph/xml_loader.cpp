@@ -1303,7 +1303,10 @@ namespace embree
         std::string str_subtype = xml->parm("type");
         if (str_type == "linear")
         {
-          type = RTC_GEOMETRY_TYPE_FLAT_LINEAR_CURVE;
+          if (str_subtype == "round" || str_subtype == "surface")
+            type = RTC_GEOMETRY_TYPE_ROUND_LINEAR_CURVE;
+          else
+            type = RTC_GEOMETRY_TYPE_FLAT_LINEAR_CURVE;
         }
         else if (str_type == "bezier")
         {
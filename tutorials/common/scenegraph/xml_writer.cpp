@@ -475,6 +475,11 @@ namespace embree
     std::string str_subtype = "";
 
     switch (mesh->type) {
+    case RTC_GEOMETRY_TYPE_ROUND_LINEAR_CURVE:
+      str_type = "linear";
+      str_subtype = "round";
+      break;
+
     case RTC_GEOMETRY_TYPE_FLAT_LINEAR_CURVE:
       str_type = "linear";
       str_subtype = "flat";
@@ -87,6 +87,17 @@ namespace embree
     float getAvg() const { return stat.getAvg(); }
     Statistics getStatistics() const { return stat; }
 
+    /* percentile over all samples including the filtered outlyers */
+    float getPercentile(float p) const
+    {
+      if (v.size() == 0) return 0.0f;
+      const float f = clamp(p,0.0f,1.0f)*float(v.size()-1);
+      const size_t i0 = (size_t) floor(f);
+      const size_t i1 = min(i0+1,v.size()-1);
+      return lerp(v[i0],v[i1],f-float(i0));
+    }
+    size_t size() const { return v.size(); }
+
   private:
     float fskip_small; // fraction of small outlyers to filter out
     float fskip_large; // fraction of large outlyers to filter out
@@ -879,7 +879,8 @@ namespace embree
     DISC_GEOMETRY,
     DISC_GEOMETRY_MB,
     ORIENTED_DISC_GEOMETRY,
-    ORIENTED_DISC_GEOMETRY_MB
+    ORIENTED_DISC_GEOMETRY_MB,
+    INSTANCED_TRIANGLE_MESH
   };
 
   inline std::string to_string(GeometryType gtype)
@@ -905,6 +906,24 @@ namespace embree
     case DISC_GEOMETRY_MB         : return "disc_mb";
     case ORIENTED_DISC_GEOMETRY   : return "oriented_disc";
     case ORIENTED_DISC_GEOMETRY_MB: return "oriented_disc_mb";
+    case INSTANCED_TRIANGLE_MESH  : return "instanced_triangles";
+    }
+    return "";
+  }
+
+  enum InstancingType
+  {
+    NO_INSTANCING,
+    USER_INSTANCING,
+    AUTO_INSTANCING
+  };
+
+  inline std::string to_string(InstancingType itype)
+  {
+    switch (itype) {
+    case NO_INSTANCING  : return "flat";
+    case USER_INSTANCING: return "instanced";
+    case AUTO_INSTANCING: return "auto_instanced";
     }
     return "";
   }
@@ -22,6 +22,7 @@
 #include "../../common/algorithms/parallel_for.h"
 #include <regex>
 #include <stack>
+#include <fstream>
 
 #define random  use_random_function_of_test // do use random_int() and random_float() from Test class
 #define drand48 use_random_function_of_test // do use random_int() and random_float() from Test class
@@ -364,6 +365,35 @@ namespace embree
       return std::make_pair(geomID,Ref<SceneGraph::Node>(nullptr));
     }
 
+    unsigned addInstance (const Ref<VerifyScene>& child, const AffineSpace3fa& xfm)
+    {
+      instancedScenes.push_back(child);
+      RTCGeometry geom = rtcNewGeometry (device, RTC_GEOMETRY_TYPE_INSTANCE);
+      AssertNoError(device);
+      rtcSetGeometryInstancedScene(geom,*child);
+      rtcSetGeometryTransform(geom,0,RTC_FORMAT_FLOAT4X4_COLUMN_MAJOR,&xfm.l.vx.x);
+      AssertNoError(device);
+      rtcCommitGeometry(geom);
+      unsigned int geomID = rtcAttachGeometry(scene,geom);
+      rtcReleaseGeometry(geom);
+      return geomID;
+    }
+
+    /* instances a single sphere into a 4x4x4 lattice around the origin */
+    void addInstancedSpheres (RTCBuildQuality quality, SceneFlags sflags, size_t numPhi)
+    {
+      Ref<VerifyScene> child = new VerifyScene(device,sflags);
+      child->addGeometry(quality,SceneGraph::createTriangleSphere(zero,one,max(numPhi/8,size_t(2))));
+      rtcCommitScene(*child);
+      AssertNoError(device);
+      for (size_t z=0; z<4; z++)
+        for (size_t y=0; y<4; y++)
+          for (size_t x=0; x<4; x++) {
+            const Vec3fa p = 0.5f*Vec3fa(float(x),float(y),float(z)) - Vec3fa(0.75f);
+            addInstance(child,AffineSpace3fa::translate(p)*AffineSpace3fa::scale(Vec3fa(0.2f)));
+          }
+    }
+
     void resizeRandomly (std::pair<unsigned,Ref<SceneGraph::Node>> geom, RandomSampler& sampler)
     {
       if (Ref<SceneGraph::TriangleMeshNode> mesh = geom.second.dynamicCast<SceneGraph::TriangleMeshNode>())
@@ -388,6 +418,7 @@ namespace embree
     const RTCDeviceRef& device;
     RTCSceneRef scene;
     std::vector<Ref<SceneGraph::Node>> nodes;
+    std::vector<Ref<VerifyScene>> instancedScenes;
   };
 
   VerifyApplication::TestReturnValue VerifyApplication::Test::execute(VerifyApplication* state, bool silent)
@@ -463,9 +494,9 @@ namespace embree
     return bestAvg;
   }
 
-  void VerifyApplication::Benchmark::updateDatabase(VerifyApplication* state, Statistics stat, double bestAvg)
+  /* load git hash from file */
+  static std::string loadGitHash()
   {
-    /* load git hash from file */
     std::fstream hashFile;
     std::string hash = "unknown";
     hashFile.open(FileName::executableFolder()+FileName("hash"), std::fstream::in);
@@ -473,6 +504,12 @@ namespace embree
       hashFile >> hash;
       hashFile.close();
     }
+    return hash;
+  }
+
+  void VerifyApplication::Benchmark::updateDatabase(VerifyApplication* state, Statistics stat, double bestAvg)
+  {
+    std::string hash = loadGitHash();
 
     /* update database */
     std::fstream db;
@@ -502,11 +539,11 @@ namespace embree
     plot.close();
   }
 
-  Statistics VerifyApplication::Benchmark::benchmark_loop(VerifyApplication* state)
+  FilteredStatistics VerifyApplication::Benchmark::benchmark_loop(VerifyApplication* state)
   {
     //sleepSeconds(0.1);
     const size_t skipBenchmarkFrames = 1;
-    const size_t numBenchmarkFrames = 8;
+    const size_t numBenchmarkFrames = state->benchmark_frames;
     FilteredStatistics stat(0.5f,0.0f);
     size_t numTotalFrames = skipBenchmarkFrames + numBenchmarkFrames;
     for (size_t i=0; i<skipBenchmarkFrames; i++) {
@@ -515,7 +552,7 @@ namespace embree
     for (size_t i=skipBenchmarkFrames; i<numTotalFrames; i++) {
       stat.add(benchmark(state));
     }
-    return stat.getStatistics();
+    return stat;
   }
 
   VerifyApplication::TestReturnValue VerifyApplication::Benchmark::execute(VerifyApplication* state, bool silent) try
@@ -537,14 +574,15 @@ namespace embree
       avgdb = readDatabase(state);
 
     /* execute benchmark */
-    Statistics curStat;
-    Statistics bestStat;
-    bool passed = false;
+    FilteredStatistics curStat(0.5f,0.0f);
+    FilteredStatistics bestStat(0.5f,0.0f);
+    bool curPassed = false;
+    bool passed = false; // whether bestStat passed, as all reported numbers come from bestStat
     
     /* retry if benchmark failed */
     //static size_t numRetries = 0;
     size_t i=0;
-    for (; i<max_attempts && !passed; i++)
+    for (; i<max_attempts && !curPassed; i++)
     {
       if (i != 0) {
         cleanup(state);
@@ -555,12 +593,6 @@ namespace embree
 
       try {
         curStat = benchmark_loop(state);
-        if (i == 0) bestStat = curStat;
-        if (higher_is_better) {
-          if (curStat.getAvg() > bestStat.getAvg()) bestStat = curStat;
-        } else {
-          if (curStat.getAvg() < bestStat.getAvg()) bestStat = curStat;
-        }
       } catch (TestReturnValue v) {
         return v;
       }
@@ -568,12 +600,19 @@ namespace embree
       /* check against database to see if test passed */
       if (state->database != "") {
         if (higher_is_better)
-          passed = !(curStat.getAvg()-avgdb < -state->benchmark_tolerance*avgdb); // !(a < b) on purpose for nan case
+          curPassed = !(curStat.getAvg()-avgdb < -state->benchmark_tolerance*avgdb); // !(a < b) on purpose for nan case
         else
-          passed = !(curStat.getAvg()-avgdb > +state->benchmark_tolerance*avgdb); // !(a > b) on purpose for nan case
+          curPassed = !(curStat.getAvg()-avgdb > +state->benchmark_tolerance*avgdb); // !(a > b) on purpose for nan case
       }
       else
-        passed = true;
+        curPassed = true;
+
+      /* keep the best attempt */
+      const bool better = higher_is_better ? curStat.getAvg() > bestStat.getAvg() : curStat.getAvg() < bestStat.getAvg();
+      if (i == 0 || better) {
+        bestStat = curStat;
+        passed = curPassed;
+      }
     }
 
     if (state->database == "" || avgdb == double(neg_inf))
@@ -581,7 +620,29 @@ namespace embree
 
     /* update database */
     if (state->database != "" && state->update_database)
-      updateDatabase(state,bestStat,avgdb);
+      updateDatabase(state,bestStat.getStatistics(),avgdb);
+
+    /* record result for JSON output */
+    if (state->benchmark_json != "")
+    {
+      BenchmarkResult result;
+      result.name = name;
+      result.unit = unit;
+      result.higher_is_better = higher_is_better;
+      result.avg = bestStat.getAvg();
+      result.sigma = bestStat.getAvgSigma();
+      result.min = bestStat.getMin();
+      result.max = bestStat.getMax();
+      result.p10 = bestStat.getPercentile(0.1f);
+      result.p50 = bestStat.getPercentile(0.5f);
+      result.p90 = bestStat.getPercentile(0.9f);
+      result.reference = avgdb;
+      result.samples = bestStat.size();
+      result.attempts = i;
+      result.passed = passed;
+      Lock<MutexSys> lock(state->mutex);
+      state->benchmark_results.push_back(result);
+    }
       
     /* print test result */
     std::cout << std::setw(8) << std::setprecision(3) << std::fixed << bestStat.getAvg() << " " << unit << " (+/-" << 100.0f*bestStat.getAvgSigma()/bestStat.getAvg() << "%)";
@@ -848,6 +909,68 @@ namespace embree
     }
   };
 
+  struct DisplacedBounds
+  {
+    MutexSys mutex;
+    BBox3fa bounds = empty;
+  };
+
+  void displacementBoundsFunc(const RTCDisplacementFunctionNArguments* args)
+  {
+    DisplacedBounds* displaced = (DisplacedBounds*) args->geometryUserPtr;
+    BBox3fa bounds = empty;
+    for (unsigned int i=0; i<args->N; i++)
+    {
+      const float d = 0.2f*sinf(10.0f*args->u[i])*cosf(7.0f*args->v[i]);
+      args->P_x[i] += d*args->Ng_x[i];
+      args->P_y[i] += d*args->Ng_y[i];
+      args->P_z[i] += d*args->Ng_z[i];
+      bounds.extend(Vec3fa(args->P_x[i],args->P_y[i],args->P_z[i]));
+    }
+    Lock<MutexSys> lock(displaced->mutex);
+    displaced->bounds.extend(bounds);
+  }
+
+  struct DisplacedSubdivBoundsTest : public VerifyApplication::Test
+  {
+    DisplacedSubdivBoundsTest (std::string name, int isa)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS) {}
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      VerifyScene scene(device,SceneFlags(RTC_SCENE_FLAG_NONE,RTC_BUILD_QUALITY_MEDIUM));
+      AssertNoError(device);
+
+      /* the brute force bounds are gathered over all displaced grid
+       * vertices, thus they have to match the bounds of the built grids */
+      RandomSampler sampler;
+      RandomSampler_init(sampler,0);
+      DisplacedBounds displaced;
+      unsigned geomID = scene.addSubdivSphere(sampler,RTC_BUILD_QUALITY_MEDIUM,zero,1.0f,8,6).first;
+      RTCGeometry geom = rtcGetGeometry(scene,geomID);
+      rtcSetGeometryUserData(geom,&displaced);
+      rtcSetGeometryDisplacementFunction(geom,displacementBoundsFunc);
+      rtcCommitGeometry(geom);
+      rtcCommitScene (scene);
+      AssertNoError(device);
+
+      BBox3fa bounds;
+      rtcGetSceneBounds(scene,(RTCBounds*)&bounds);
+      AssertNoError(device);
+
+      const BBox3fa& expected = displaced.bounds;
+      if (expected.empty()) return VerifyApplication::FAILED;
+      const float eps = 1E-5f*reduce_max(expected.size());
+      bool passed = true;
+      passed &= reduce_max(abs(bounds.lower-expected.lower)) <= eps;
+      passed &= reduce_max(abs(bounds.upper-expected.upper)) <= eps;
+      return (VerifyApplication::TestReturnValue) passed;
+    }
+  };
+
   struct GetUserDataTest : public VerifyApplication::Test
   {
     GetUserDataTest (std::string name, int isa)
@@ -1158,6 +1281,460 @@ namespace embree
     }
   };
 
+  /* minimal JSON syntax check of the trace files */
+  struct JSONChecker
+  {
+    const char* p;
+    JSONChecker (const char* p) : p(p) {}
+
+    void skip() { while (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r') p++; }
+    bool match(char c) { skip(); if (*p != c) return false; p++; return true; }
+
+    bool string()
+    {
+      if (!match('"')) return false;
+      while (*p != '"') {
+        if (*p == 0) return false;
+        if (*p == '\\' && *(++p) == 0) return false;
+        p++;
+      }
+      p++;
+      return true;
+    }
+
+    template<typename Element>
+      bool list(char close, const Element& element)
+    {
+      if (match(close)) return true;
+      do { if (!element()) return false; } while (match(','));
+      return match(close);
+    }
+
+    bool value()
+    {
+      skip();
+      if (*p == '"') return string();
+      if (match('{')) return list('}',[&] () { return string() && match(':') && value(); });
+      if (match('[')) return list(']',[&] () { return value(); });
+      char* end = nullptr;
+      strtod(p,&end);
+      if (end == p) return false;
+      p = end;
+      return true;
+    }
+
+    static bool valid(const std::string& text) {
+      JSONChecker checker(text.c_str());
+      if (!checker.value()) return false;
+      checker.skip();
+      return *checker.p == 0;
+    }
+  };
+
+  struct TraceFileTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+
+    TraceFileTest (std::string name, int isa, SceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      const std::string fileName = "verify_trace_"+stringOfISA(isa)+".json";
+
+      /* the second session reuses the trace buffers of the first one */
+      for (size_t session=0; session<2; session++)
+      {
+        std::remove(fileName.c_str());
+        {
+          std::string cfg = state->rtcore + ",isa="+stringOfISA(isa)+",trace_file=\""+fileName+"\",trace_buffer_size=256";
+          RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+          errorHandler(nullptr,rtcGetDeviceError(device));
+          VerifyScene scene(device,sflags);
+          scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createTriangleSphere(zero,1.0f,50));
+          scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createQuadSphere(zero,1.0f,50));
+          rtcCommitScene (scene);
+          AssertNoError(device);
+        }
+
+        /* the trace file gets written when the device is destroyed */
+        std::ifstream file(fileName);
+        const std::string text((std::istreambuf_iterator<char>(file)),std::istreambuf_iterator<char>());
+        file.close();
+        std::remove(fileName.c_str());
+        if (text.empty() || !JSONChecker::valid(text)) return VerifyApplication::FAILED;
+        if (text.find("\"traceEvents\"") == std::string::npos) return VerifyApplication::FAILED;
+      }
+
+      /* trace buffers need space for at least one event */
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa)+",trace_file=\""+fileName+"\",trace_buffer_size=0";
+      RTCDevice device = rtcNewDevice(cfg.c_str());
+      if (device) { rtcReleaseDevice(device); return VerifyApplication::FAILED; }
+      if (rtcGetDeviceError(nullptr) != RTC_ERROR_INVALID_ARGUMENT) return VerifyApplication::FAILED;
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct MappedBufferTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+
+    MappedBufferTest (std::string name, int isa, SceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    VerifyApplication::TestReturnValue run (VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      /* write a unit quad as 4 vertices behind some header bytes, the
+       * file also has to contain the padding of the last vertex */
+      const std::string fileName = "verify_mapped_"+stringOfISA(isa)+"_"+to_string(sflags)+".bin";
+      const size_t headerBytes = 16;
+      const float vertices[4*3+1] = { 0,0,0, 1,0,0, 1,1,0, 0,1,0, 0 };
+      {
+        std::ofstream file(fileName,std::ios::binary);
+        const char header[headerBytes] = { 0 };
+        file.write(header,headerBytes);
+        file.write((const char*)vertices,sizeof(vertices));
+      }
+
+      bool passed = true;
+      {
+        RTCBuffer buffer = rtcNewMappedBuffer(device,fileName.c_str(),headerBytes,sizeof(vertices));
+        AssertNoError(device);
+
+        VerifyScene scene(device,sflags);
+        RTCGeometry geom = rtcNewGeometry(device,RTC_GEOMETRY_TYPE_TRIANGLE);
+        rtcSetGeometryBuffer(geom,RTC_BUFFER_TYPE_VERTEX,0,RTC_FORMAT_FLOAT3,buffer,0,3*sizeof(float),4);
+        unsigned int* indices = (unsigned int*) rtcSetNewGeometryBuffer(geom,RTC_BUFFER_TYPE_INDEX,0,RTC_FORMAT_UINT3,3*sizeof(unsigned int),2);
+        indices[0] = 0; indices[1] = 1; indices[2] = 2;
+        indices[3] = 0; indices[4] = 2; indices[5] = 3;
+        rtcCommitGeometry(geom);
+        rtcAttachGeometry(scene,geom);
+        rtcReleaseGeometry(geom);
+        rtcCommitScene(scene);
+        AssertNoError(device);
+
+        /* the data has to come from the file */
+        const float* data = (const float*) rtcGetBufferData(buffer);
+        passed &= memcmp(data,vertices,sizeof(vertices)) == 0;
+
+        const Vec3fa org[3] = { Vec3fa(0.75f,0.25f,1.0f), Vec3fa(0.25f,0.75f,1.0f), Vec3fa(1.5f,0.5f,1.0f) };
+        const unsigned int primID[3] = { 0, 1, RTC_INVALID_GEOMETRY_ID };
+        for (size_t i=0; i<3; i++)
+        {
+          RTCRayHit ray = makeRay(org[i],Vec3fa(0,0,-1));
+          RTCIntersectContext context;
+          rtcInitIntersectContext(&context);
+          rtcIntersect1(scene,&context,&ray);
+          if (primID[i] == RTC_INVALID_GEOMETRY_ID) {
+            passed &= ray.hit.geomID == RTC_INVALID_GEOMETRY_ID;
+          } else {
+            passed &= ray.hit.geomID == 0;
+            passed &= ray.hit.primID == primID[i];
+            passed &= abs(ray.ray.tfar-1.0f) < 1E-5f;
+          }
+        }
+
+        /* writes through the buffer pointer must not reach the file */
+        ((float*)rtcGetBufferData(buffer))[0] = 7.0f;
+        rtcReleaseBuffer(buffer);
+        AssertNoError(device);
+      }
+
+      std::ifstream file(fileName,std::ios::binary);
+      const std::string text((std::istreambuf_iterator<char>(file)),std::istreambuf_iterator<char>());
+      file.close();
+      std::remove(fileName.c_str());
+      passed &= text.size() == headerBytes+sizeof(vertices) && memcmp(text.data()+headerBytes,vertices,sizeof(vertices)) == 0;
+
+      /* mapping a file that does not exist fails */
+      RTCBuffer missing = rtcNewMappedBuffer(device,(fileName+".missing").c_str(),0,sizeof(vertices));
+      passed &= missing == nullptr;
+      AssertError(device,RTC_ERROR_INVALID_ARGUMENT);
+
+      return (VerifyApplication::TestReturnValue) passed;
+    }
+  };
+
+  /* traces the same rays in both scenes with all intersect modes, the
+   * hits have to be identical, except for the primitive hit inside a
+   * geometry with overlapping primitives */
+  static bool compareHits(VerifyApplication* state, VerifyScene& scene0, VerifyScene& scene1, int seed, unsigned int overlappingGeomID = RTC_INVALID_GEOMETRY_ID)
+  {
+    const size_t numRays = 256;
+    RandomSampler sampler;
+    RandomSampler_init(sampler,seed);
+    for (auto imode : state->intersectModes)
+    {
+      for (auto ivariant : state->intersectVariants)
+      {
+        if (!has_variant(imode,ivariant)) continue;
+
+        RTCRayHit rays0[numRays], rays1[numRays];
+        for (size_t i=0; i<numRays; i++) {
+          Vec3fa org = 2.0f*RandomSampler_get3D(sampler) - Vec3fa(1.0f);
+          Vec3fa dir = 2.0f*RandomSampler_get3D(sampler) - Vec3fa(1.0f);
+          rays0[i] = rays1[i] = makeRay(org,dir);
+        }
+        IntersectWithMode(imode,ivariant,scene0,rays0,numRays);
+        IntersectWithMode(imode,ivariant,scene1,rays1,numRays);
+        for (size_t i=0; i<numRays; i++)
+        {
+          if (rays0[i].ray.tfar != rays1[i].ray.tfar) return false;
+          if (!(ivariant & VARIANT_INTERSECT)) continue;
+          if (rays0[i].hit.geomID != rays1[i].hit.geomID) return false;
+          if (rays0[i].hit.geomID == overlappingGeomID) continue;
+          if (rays0[i].hit.primID != rays1[i].hit.primID) return false;
+          if (rays0[i].hit.u != rays1[i].hit.u || rays0[i].hit.v != rays1[i].hit.v) return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  struct NumaReplicationTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+
+    NumaReplicationTest (std::string name, int isa, SceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device0 = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device0));
+      RTCDeviceRef device1 = rtcNewDevice((cfg+",numa_replication=1").c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device1));
+
+      /* the sphere BVH gets replicated fully, the large plane only its top levels */
+      Ref<SceneGraph::Node> sphere = SceneGraph::createTriangleSphere(zero,0.5f,50);
+      Ref<SceneGraph::TriangleMeshNode> plane = SceneGraph::createTrianglePlane(Vec3fa(-1.0f,-1.0f,-0.5f),Vec3fa(2,0,0),Vec3fa(0,2,0),200,200).dynamicCast<SceneGraph::TriangleMeshNode>();
+      VerifyScene scene0(device0,sflags);
+      VerifyScene scene1(device1,sflags);
+      scene0.addGeometry(RTC_BUILD_QUALITY_MEDIUM,sphere);
+      scene1.addGeometry(RTC_BUILD_QUALITY_MEDIUM,sphere);
+      const unsigned int planeID0 = scene0.addGeometry(RTC_BUILD_QUALITY_MEDIUM,plane.dynamicCast<SceneGraph::Node>());
+      const unsigned int planeID1 = scene1.addGeometry(RTC_BUILD_QUALITY_MEDIUM,plane.dynamicCast<SceneGraph::Node>());
+      rtcCommitScene(scene0);
+      rtcCommitScene(scene1);
+      AssertNoError(device0);
+      AssertNoError(device1);
+      if (!compareHits(state,scene0,scene1,1)) return VerifyApplication::FAILED;
+
+      /* moving the plane invalidates the copies, stale copies would still report the old hits */
+      for (auto& p : plane->positions[0]) p.z += 0.25f;
+      RTCGeometry geom0 = rtcGetGeometry(scene0,planeID0);
+      RTCGeometry geom1 = rtcGetGeometry(scene1,planeID1);
+      rtcUpdateGeometryBuffer(geom0,RTC_BUFFER_TYPE_VERTEX,0);
+      rtcUpdateGeometryBuffer(geom1,RTC_BUFFER_TYPE_VERTEX,0);
+      rtcCommitGeometry(geom0);
+      rtcCommitGeometry(geom1);
+      rtcCommitScene(scene0);
+      rtcCommitScene(scene1);
+      AssertNoError(device0);
+      AssertNoError(device1);
+      if (!compareHits(state,scene0,scene1,2)) return VerifyApplication::FAILED;
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct BuildMemoryBudgetTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+
+    BuildMemoryBudgetTest (std::string name, int isa, SceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      /* a sphere and many copies of the same triangle, which cannot get separated spatially */
+      Ref<SceneGraph::Node> sphere = SceneGraph::createTriangleSphere(zero,0.5f,50);
+      const size_t numCopies = 8000;
+      avector<Vec3fa> positions;
+      positions.push_back(Vec3fa(-0.2f,-0.2f,-0.7f));
+      positions.push_back(Vec3fa(+0.2f,-0.2f,-0.7f));
+      positions.push_back(Vec3fa( 0.0f,+0.2f,-0.7f));
+      std::vector<SceneGraph::TriangleMeshNode::Triangle> triangles(numCopies,SceneGraph::TriangleMeshNode::Triangle(0,1,2));
+      Ref<SceneGraph::TriangleMeshNode> copies = new SceneGraph::TriangleMeshNode(positions,avector<Vec3fa>(),std::vector<Vec2f>(),triangles,nullptr);
+      const size_t numPrims = sphere->numPrimitives()+numCopies;
+
+      /* the first budget leaves room to sort the primitive IDs by chunk, the
+       * second one streams each chunk from the scene, both result in chunks
+       * smaller than the number of copies, thus the copies get split by order */
+      const size_t budgets[2] = { 20*numPrims, 8*numPrims };
+
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device0 = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device0));
+      VerifyScene scene0(device0,sflags);
+      scene0.addGeometry(RTC_BUILD_QUALITY_MEDIUM,sphere);
+      scene0.addGeometry(RTC_BUILD_QUALITY_MEDIUM,copies.dynamicCast<SceneGraph::Node>());
+      rtcCommitScene(scene0);
+      AssertNoError(device0);
+
+      for (size_t budget : budgets)
+      {
+        RTCDeviceRef device1 = rtcNewDevice((cfg+",build_memory_budget="+std::to_string(float(budget)/(1024.0f*1024.0f))).c_str());
+        errorHandler(nullptr,rtcGetDeviceError(device1));
+        VerifyScene scene1(device1,sflags);
+        scene1.addGeometry(RTC_BUILD_QUALITY_MEDIUM,sphere);
+        const unsigned int copiesID = scene1.addGeometry(RTC_BUILD_QUALITY_MEDIUM,copies.dynamicCast<SceneGraph::Node>());
+        rtcCommitScene(scene1);
+        AssertNoError(device1);
+        if (!compareHits(state,scene0,scene1,int(budget),copiesID)) return VerifyApplication::FAILED;
+      }
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct BackgroundBuildTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+
+    BackgroundBuildTest (std::string name, int isa, SceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    struct BackgroundCommit
+    {
+      BackgroundCommit (RTCScene scene)
+        : scene(scene), finished(false) {}
+
+      RTCScene scene;
+      std::atomic<bool> finished;
+    };
+
+    static void commitThread(void* ptr)
+    {
+      BackgroundCommit* commit = (BackgroundCommit*) ptr;
+      rtcCommitScene(commit->scene);
+      commit->finished = true;
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      Ref<SceneGraph::Node> sphere = SceneGraph::createTriangleSphere(zero,0.5f,300);
+      Ref<SceneGraph::Node> plane = SceneGraph::createTrianglePlane(Vec3fa(-1.0f,-1.0f,-0.5f),Vec3fa(2,0,0),Vec3fa(0,2,0),20,20);
+      VerifyScene scene0(device,sflags);
+      scene0.addGeometry(RTC_BUILD_QUALITY_MEDIUM,sphere);
+      rtcCommitScene(scene0);
+      VerifyScene plane0(device,sflags);
+      plane0.addGeometry(RTC_BUILD_QUALITY_MEDIUM,plane);
+      rtcCommitScene(plane0);
+      AssertNoError(device);
+
+      /* the worker threads leave the background build for each foreground
+       * build and parallel loop committed meanwhile, and have to return */
+      SceneFlags bflags(RTCSceneFlags(sflags.sflags | RTC_SCENE_FLAG_BACKGROUND_BUILD),sflags.qflags);
+      VerifyScene scene1(device,bflags);
+      scene1.addGeometry(RTC_BUILD_QUALITY_MEDIUM,sphere);
+      BackgroundCommit commit(scene1);
+      thread_t thread = createThread(commitThread,&commit);
+      size_t numForegroundCommits = 0;
+      do {
+        VerifyScene plane1(device,sflags);
+        plane1.addGeometry(RTC_BUILD_QUALITY_MEDIUM,plane);
+        rtcCommitScene(plane1);
+        AssertNoError(device);
+        if (!compareHits(state,plane0,plane1,int(numForegroundCommits))) {
+          join(thread);
+          return VerifyApplication::FAILED;
+        }
+        numForegroundCommits++;
+      } while (!commit.finished);
+      join(thread);
+      AssertNoError(device);
+
+      if (!compareHits(state,scene0,scene1,1)) return VerifyApplication::FAILED;
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct BuildReportTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+
+    BuildReportTest (std::string name, int isa, SceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    /* creates a grid of numX*numY triangles or quads */
+    static void addGrid(RTCDevice device, RTCScene scene, RTCGeometryType type, size_t numX, size_t numY, float z)
+    {
+      const size_t vertsPerPrim = type == RTC_GEOMETRY_TYPE_QUAD ? 4 : 3;
+      const size_t numPrims = numX*numY;
+      RTCGeometry geom = rtcNewGeometry(device,type);
+      Vec3f* vertices = (Vec3f*) rtcSetNewGeometryBuffer(geom,RTC_BUFFER_TYPE_VERTEX,0,RTC_FORMAT_FLOAT3,sizeof(Vec3f),(numX+1)*(numY+1));
+      unsigned int* indices = (unsigned int*) rtcSetNewGeometryBuffer(geom,RTC_BUFFER_TYPE_INDEX,0,vertsPerPrim == 4 ? RTC_FORMAT_UINT4 : RTC_FORMAT_UINT3,vertsPerPrim*sizeof(unsigned int),numPrims);
+      for (size_t y=0; y<=numY; y++)
+        for (size_t x=0; x<=numX; x++)
+          vertices[y*(numX+1)+x] = Vec3f(float(x),float(y),z);
+      for (size_t y=0; y<numY; y++)
+      {
+        for (size_t x=0; x<numX; x++)
+        {
+          unsigned int* prim = &indices[vertsPerPrim*(y*numX+x)];
+          const unsigned int p = unsigned(y*(numX+1)+x);
+          if (vertsPerPrim == 4) { prim[0] = p; prim[1] = p+1; prim[2] = p+unsigned(numX)+2; prim[3] = p+unsigned(numX)+1; }
+          else                   { prim[0] = p; prim[1] = p+1; prim[2] = p+unsigned(numX)+1; }
+        }
+      }
+      rtcCommitGeometry(geom);
+      rtcAttachGeometry(scene,geom);
+      rtcReleaseGeometry(geom);
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      for (bool enabled : { true, false })
+      {
+        SceneFlags rflags = sflags;
+        if (enabled) rflags.sflags = (RTCSceneFlags)(rflags.sflags | RTC_SCENE_FLAG_BUILD_REPORT);
+        VerifyScene scene(device,rflags);
+        addGrid(device,scene,RTC_GEOMETRY_TYPE_TRIANGLE,64,32,0.0f);
+        addGrid(device,scene,RTC_GEOMETRY_TYPE_QUAD,32,16,1.0f);
+        rtcCommitScene (scene);
+        AssertNoError(device);
+
+        RTCSceneBuildReport report;
+        memset(&report,0xFF,sizeof(report));
+        rtcGetSceneBuildReport(scene,&report);
+        AssertNoError(device);
+
+        if (!enabled)
+        {
+          if (report.commitTime != 0.0 || report.primRefTime != 0.0 || report.hierarchyTime != 0.0 || report.spatialSplitTime != 0.0 || report.leafTime != 0.0)
+            return VerifyApplication::FAILED;
+          if (report.numThreads || report.numBVHs || report.numPrimitives || report.bytesAllocated || report.bytesUsed || report.bytesWasted || report.sahCost != 0.0f)
+            return VerifyApplication::FAILED;
+          continue;
+        }
+
+        if (!(report.commitTime > 0.0)) return VerifyApplication::FAILED;
+        if (report.primRefTime < 0.0 || report.hierarchyTime < 0.0 || report.spatialSplitTime < 0.0 || report.leafTime < 0.0) return VerifyApplication::FAILED;
+        if (report.numThreads == 0 || report.numBVHs == 0) return VerifyApplication::FAILED;
+        if (report.numPrimitives != 64*32+32*16) return VerifyApplication::FAILED;
+        if (report.bytesUsed == 0 || report.bytesUsed > report.bytesAllocated) return VerifyApplication::FAILED;
+        if (report.bytesWasted > report.bytesAllocated) return VerifyApplication::FAILED;
+        if (!(report.sahCost > 0.0f)) return VerifyApplication::FAILED;
+      }
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
   struct OverlappingGeometryTest : public VerifyApplication::Test
   {
     SceneFlags sflags;
@@ -1990,13 +2567,119 @@ namespace embree
     }
   };
 
-  struct InterpolateTrianglesTest : public VerifyApplication::Test
+  struct InterpolateNSubdivTest : public VerifyApplication::Test
   {
-    size_t N;
-    
-    InterpolateTrianglesTest (std::string name, int isa, size_t N)
-      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), N(N) {}
-    
+    unsigned int numSamples;
+
+    InterpolateNSubdivTest (std::string name, int isa, unsigned int numSamples)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), numSamples(numSamples) {}
+
+    /* compares a batch of samples with unsorted primIDs against single sample interpolation */
+    bool checkInterpolationN(RTCGeometry geom, RTCBufferType bufferType, unsigned int bufferSlot, unsigned int valueCount)
+    {
+      const unsigned int N = numSamples;
+      std::vector<int> valid(N);
+      std::vector<unsigned int> primIDs(N);
+      std::vector<float> u(N), v(N);
+      for (unsigned int i=0; i<N; i++) {
+        valid[i] = random_int()%8 ? -1 : 0;
+        primIDs[i] = random_int()%num_interpolation_quad_faces;
+        u[i] = random_float();
+        v[i] = random_float();
+      }
+
+      /* invalid samples must not be written */
+      const float untouched = 1234.0f;
+      std::vector<float> P(N*valueCount,untouched), dPdu(N*valueCount,untouched), dPdv(N*valueCount,untouched);
+      RTCInterpolateNArguments args;
+      args.geometry = geom;
+      args.valid = valid.data();
+      args.primIDs = primIDs.data();
+      args.u = u.data();
+      args.v = v.data();
+      args.N = N;
+      args.bufferType = bufferType;
+      args.bufferSlot = bufferSlot;
+      args.P = P.data();
+      args.dPdu = dPdu.data();
+      args.dPdv = dPdv.data();
+      args.ddPdudu = nullptr;
+      args.ddPdvdv = nullptr;
+      args.ddPdudv = nullptr;
+      args.valueCount = valueCount;
+      rtcInterpolateN(&args);
+
+      bool passed = true;
+      for (unsigned int i=0; i<N; i++)
+      {
+        float P1[16], dPdu1[16], dPdv1[16];
+        rtcInterpolate1(geom,primIDs[i],u[i],v[i],bufferType,bufferSlot,P1,dPdu1,dPdv1,valueCount);
+        for (unsigned int j=0; j<valueCount; j++)
+        {
+          const size_t k = size_t(j)*N+i;
+          if (valid[i] != -1) {
+            passed &= P[k] == untouched && dPdu[k] == untouched && dPdv[k] == untouched;
+            continue;
+          }
+          passed &= fabsf(P[k]-P1[j]) < 1E-4f;
+          passed &= fabsf(dPdu[k]-dPdu1[j]) < 1E-3f;
+          passed &= fabsf(dPdv[k]-dPdv1[j]) < 1E-3f;
+        }
+      }
+      return passed;
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      const unsigned int numAttributes = 5;
+      size_t M = num_interpolation_vertices*numAttributes+16; // padds the arrays with some valid data
+
+      RTCGeometry geom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_SUBDIVISION);
+      AssertNoError(device);
+      rtcSetGeometryVertexAttributeCount(geom,1);
+
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_INDEX,                0, RTC_FORMAT_UINT,  interpolation_quad_indices,          0, sizeof(unsigned int),   num_interpolation_quad_faces*4);
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_FACE,                 0, RTC_FORMAT_UINT,  interpolation_quad_faces,            0, sizeof(unsigned int),   num_interpolation_quad_faces);
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_EDGE_CREASE_INDEX,    0, RTC_FORMAT_UINT2, interpolation_edge_crease_indices,   0, 2*sizeof(unsigned int), 3);
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_EDGE_CREASE_WEIGHT,   0, RTC_FORMAT_FLOAT, interpolation_edge_crease_weights,   0, sizeof(float),          3);
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX_CREASE_INDEX,  0, RTC_FORMAT_UINT,  interpolation_vertex_crease_indices, 0, sizeof(unsigned int),   2);
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX_CREASE_WEIGHT, 0, RTC_FORMAT_FLOAT, interpolation_vertex_crease_weights, 0, sizeof(float),          2);
+      AssertNoError(device);
+
+      std::vector<float> vertices0(M);
+      for (size_t i=0; i<M; i++) vertices0[i] = random_float();
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3, vertices0.data(), 0, 3*sizeof(float), num_interpolation_vertices);
+      AssertNoError(device);
+
+      std::vector<float> user_vertices0(M);
+      for (size_t i=0; i<M; i++) user_vertices0[i] = random_float();
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE, 0, RTCFormat(RTC_FORMAT_FLOAT+numAttributes), user_vertices0.data(), 0, numAttributes*sizeof(float), num_interpolation_vertices);
+      AssertNoError(device);
+      rtcCommitGeometry(geom);
+      AssertNoError(device);
+
+      bool passed = true;
+      passed &= checkInterpolationN(geom,RTC_BUFFER_TYPE_VERTEX,0,3);
+      passed &= checkInterpolationN(geom,RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE,0,numAttributes);
+      passed &= checkInterpolationN(geom,RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE,0,1);
+
+      rtcReleaseGeometry(geom);
+      AssertNoError(device);
+
+      return (VerifyApplication::TestReturnValue) passed;
+    }
+  };
+
+  struct InterpolateTrianglesTest : public VerifyApplication::Test
+  {
+    size_t N;
+    
+    InterpolateTrianglesTest (std::string name, int isa, size_t N)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), N(N) {}
+    
     bool checkTriangleInterpolation(RTCGeometry geom, int primID, float u, float v, int v0, int v1, int v2, RTCBufferType bufferType, unsigned int bufferSlot, float* data, size_t N, size_t N_total)
     {
       assert(N<256);
@@ -2439,6 +3122,192 @@ namespace embree
     }
   };
   
+  struct CompressedVerticesTest : public VerifyApplication::IntersectTest
+  {
+    SceneFlags sflags;
+    GeometryType gtype;
+    RTCFormat format;
+    static const unsigned int N = 8;
+
+    CompressedVerticesTest (std::string name, int isa, SceneFlags sflags, GeometryType gtype, RTCFormat format, IntersectMode imode)
+      : VerifyApplication::IntersectTest(name,isa,imode,VARIANT_INTERSECT_INCOHERENT,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), gtype(gtype), format(format) {}
+
+    /* encodes small integers exactly as half precision float */
+    static unsigned short halfOfInt(unsigned int n)
+    {
+      if (n == 0) return 0;
+      const int e = bsr(n);
+      return (unsigned short)(((e+15) << 10) | (((n << 10) >> e) & 0x3ff));
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      if (!supportsIntersectMode(device,imode))
+        return VerifyApplication::SKIPPED;
+
+      /* (N+1)x(N+1) grid of vertices, padded to 8 bytes such that the stride differs from the element size */
+      const float scale = format == RTC_FORMAT_HALF3 ? 1.0f : float(65535/N)/65535.0f;
+      std::vector<unsigned short> vertices(4*(N+1)*(N+1));
+      for (unsigned int y=0; y<=N; y++) {
+        for (unsigned int x=0; x<=N; x++) {
+          unsigned short* v = &vertices[4*(y*(N+1)+x)];
+          v[0] = format == RTC_FORMAT_HALF3 ? halfOfInt(x) : (unsigned short)(x*(65535/N));
+          v[1] = format == RTC_FORMAT_HALF3 ? halfOfInt(y) : (unsigned short)(y*(65535/N));
+          v[2] = 0; v[3] = 0;
+        }
+      }
+      std::vector<unsigned int> indices;
+      for (unsigned int y=0; y<N; y++) {
+        for (unsigned int x=0; x<N; x++) {
+          const unsigned int v00 = y*(N+1)+x, v01 = v00+1, v10 = v00+N+1, v11 = v10+1;
+          if (gtype == QUAD_MESH) {
+            indices.push_back(v00); indices.push_back(v01); indices.push_back(v11); indices.push_back(v10);
+          } else {
+            indices.push_back(v00); indices.push_back(v01); indices.push_back(v10);
+            indices.push_back(v01); indices.push_back(v11); indices.push_back(v10);
+          }
+        }
+      }
+
+      RTCSceneRef scene = rtcNewScene(device);
+      rtcSetSceneFlags(scene,sflags.sflags);
+      rtcSetSceneBuildQuality(scene,sflags.qflags);
+      RTCGeometry geom = rtcNewGeometry (device, gtype == QUAD_MESH ? RTC_GEOMETRY_TYPE_QUAD : RTC_GEOMETRY_TYPE_TRIANGLE);
+      rtcSetGeometryBuildQuality(geom,sflags.qflags);
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0, format, vertices.data(), 0, 4*sizeof(unsigned short), (N+1)*(N+1));
+      if (gtype == QUAD_MESH) rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_INDEX, 0, RTC_FORMAT_UINT4, indices.data(), 0, 4*sizeof(unsigned int), N*N);
+      else                    rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_INDEX, 0, RTC_FORMAT_UINT3, indices.data(), 0, 3*sizeof(unsigned int), 2*N*N);
+      rtcCommitGeometry(geom);
+      rtcAttachGeometry(scene,geom);
+      rtcReleaseGeometry(geom);
+      rtcCommitScene (scene);
+      AssertNoError(device);
+
+      /* shoot one ray into the lower left triangle of each cell */
+      RTCRayHit rays[N*N];
+      for (unsigned int y=0; y<N; y++)
+        for (unsigned int x=0; x<N; x++)
+          rays[y*N+x] = makeRay(Vec3fa((float(x)+0.25f)*scale,(float(y)+0.25f)*scale,-1.0f),Vec3fa(0,0,1));
+      IntersectWithMode(imode,ivariant,scene,rays,N*N);
+
+      for (unsigned int i=0; i<N*N; i++)
+      {
+        const unsigned int primID = gtype == QUAD_MESH ? i : 2*i;
+        if (rays[i].hit.geomID != 0) return VerifyApplication::FAILED;
+        if (rays[i].hit.primID != primID) return VerifyApplication::FAILED;
+        if (abs(rays[i].ray.tfar - 1.0f) > 16.0f*float(ulp)) return VerifyApplication::FAILED;
+      }
+      AssertNoError(device);
+
+      /* interpolation decodes the vertices, which only provide 3 values */
+      float P[4] = { -1.0f, -1.0f, -1.0f, -1.0f };
+      RTCInterpolateArguments args;
+      memset(&args,0,sizeof(args));
+      args.geometry = rtcGetGeometry(scene,0);
+      args.primID = 0;
+      args.u = 1.0f;
+      args.v = 0.0f;
+      args.bufferType = RTC_BUFFER_TYPE_VERTEX;
+      args.bufferSlot = 0;
+      args.P = P;
+      args.valueCount = 3;
+      rtcInterpolate(&args);
+      AssertNoError(device);
+      if (abs(P[0]-scale) > 16.0f*float(ulp) || P[1] != 0.0f || P[2] != 0.0f || P[3] != -1.0f)
+        return VerifyApplication::FAILED;
+      args.valueCount = 4;
+      rtcInterpolate(&args);
+      AssertError(device,RTC_ERROR_INVALID_ARGUMENT);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct MeshletIndicesTest : public VerifyApplication::IntersectTest
+  {
+    SceneFlags sflags;
+    GeometryType gtype;
+    static const unsigned int N = 16;
+    static const unsigned int MESHLET_SIZE = 64;
+
+    MeshletIndicesTest (std::string name, int isa, SceneFlags sflags, GeometryType gtype, IntersectMode imode)
+      : VerifyApplication::IntersectTest(name,isa,imode,VARIANT_INTERSECT_INCOHERENT,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), gtype(gtype) {}
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      if (!supportsIntersectMode(device,imode))
+        return VerifyApplication::SKIPPED;
+
+      /* (N+1)x(N+1) grid of vertices, the last one is padding */
+      std::vector<Vec3fa> vertices((N+1)*(N+1)+1,Vec3fa(zero));
+      for (unsigned int y=0; y<=N; y++)
+        for (unsigned int x=0; x<=N; x++)
+          vertices[y*(N+1)+x] = Vec3fa(float(x),float(y),0.0f);
+
+      std::vector<unsigned int> indices;
+      for (unsigned int y=0; y<N; y++) {
+        for (unsigned int x=0; x<N; x++) {
+          const unsigned int v00 = y*(N+1)+x, v01 = v00+1, v10 = v00+N+1, v11 = v10+1;
+          if (gtype == QUAD_MESH) {
+            indices.push_back(v00); indices.push_back(v01); indices.push_back(v11); indices.push_back(v10);
+          } else {
+            indices.push_back(v00); indices.push_back(v01); indices.push_back(v10);
+            indices.push_back(v01); indices.push_back(v11); indices.push_back(v10);
+          }
+        }
+      }
+
+      /* store the indices of each meshlet relative to its smallest vertex index */
+      const unsigned int numVerts = gtype == QUAD_MESH ? 4 : 3;
+      const unsigned int numPrims = (unsigned int)indices.size()/numVerts;
+      const unsigned int numMeshlets = (numPrims+MESHLET_SIZE-1)/MESHLET_SIZE;
+      std::vector<unsigned int> bases(numMeshlets,unsigned(-1));
+      std::vector<unsigned short> shortIndices(indices.size());
+      for (size_t i=0; i<indices.size(); i++)
+        bases[i/numVerts/MESHLET_SIZE] = min(bases[i/numVerts/MESHLET_SIZE],indices[i]);
+      for (size_t i=0; i<indices.size(); i++)
+        shortIndices[i] = (unsigned short)(indices[i]-bases[i/numVerts/MESHLET_SIZE]);
+
+      RTCSceneRef scene = rtcNewScene(device);
+      rtcSetSceneFlags(scene,sflags.sflags);
+      rtcSetSceneBuildQuality(scene,sflags.qflags);
+      RTCGeometry geom = rtcNewGeometry (device, gtype == QUAD_MESH ? RTC_GEOMETRY_TYPE_QUAD : RTC_GEOMETRY_TYPE_TRIANGLE);
+      rtcSetGeometryBuildQuality(geom,sflags.qflags);
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3, vertices.data(), 0, sizeof(Vec3fa), (N+1)*(N+1));
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_INDEX, 0, gtype == QUAD_MESH ? RTC_FORMAT_USHORT4 : RTC_FORMAT_USHORT3, shortIndices.data(), 0, numVerts*sizeof(unsigned short), numPrims);
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_INDEX, 1, RTC_FORMAT_UINT, bases.data(), 0, sizeof(unsigned int), numMeshlets);
+      rtcCommitGeometry(geom);
+      rtcAttachGeometry(scene,geom);
+      rtcReleaseGeometry(geom);
+      rtcCommitScene (scene);
+      AssertNoError(device);
+
+      /* shoot one ray into the lower left triangle of each cell */
+      RTCRayHit rays[N*N];
+      for (unsigned int y=0; y<N; y++)
+        for (unsigned int x=0; x<N; x++)
+          rays[y*N+x] = makeRay(Vec3fa(float(x)+0.25f,float(y)+0.25f,-1.0f),Vec3fa(0,0,1));
+      IntersectWithMode(imode,ivariant,scene,rays,N*N);
+
+      for (unsigned int i=0; i<N*N; i++)
+      {
+        const unsigned int primID = gtype == QUAD_MESH ? i : 2*i;
+        if (rays[i].hit.geomID != 0) return VerifyApplication::FAILED;
+        if (rays[i].hit.primID != primID) return VerifyApplication::FAILED;
+        if (abs(rays[i].ray.tfar - 1.0f) > 16.0f*float(ulp)) return VerifyApplication::FAILED;
+      }
+      AssertNoError(device);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
   struct RayMasksTest : public VerifyApplication::IntersectTest
   {
     SceneFlags sflags; 
@@ -2495,102 +3364,987 @@ namespace embree
       }
       AssertNoError(device);
 
-      return (VerifyApplication::TestReturnValue) passed;
+      return (VerifyApplication::TestReturnValue) passed;
+    }
+  };
+
+  struct BackfaceCullingTest : public VerifyApplication::IntersectTest
+  {
+    SceneFlags sflags;
+    RTCBuildQuality quality;
+    GeometryType gtype;
+
+    BackfaceCullingTest (std::string name, int isa, SceneFlags sflags, RTCBuildQuality quality, GeometryType gtype, IntersectMode imode, IntersectVariant ivariant)
+      : VerifyApplication::IntersectTest(name,isa,imode,ivariant,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), quality(quality), gtype(gtype) {}
+    
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      if (!supportsIntersectMode(device,imode))
+        return VerifyApplication::SKIPPED;
+       
+      /* create triangle that is front facing for a right handed 
+         coordinate system if looking along the z direction */
+      VerifyScene scene(device,sflags);
+      AssertNoError(device);
+      const Vec3fa p0 = Vec3fa(0.0f);
+      const Vec3fa dx = Vec3fa(0.0f,1.0f,0.0f);
+      const Vec3fa dy = Vec3fa(1.0f,0.0f,0.0f);
+      switch (gtype) {
+      case TRIANGLE_MESH:    scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createTrianglePlane(p0,dx,dy,1,1)); break;
+      case TRIANGLE_MESH_MB: scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createTrianglePlane(p0,dx,dy,1,1)->set_motion_vector(zero)); break;
+      case QUAD_MESH:        scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createQuadPlane(p0,dx,dy,1,1)); break;
+      case QUAD_MESH_MB:     scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createQuadPlane(p0,dx,dy,1,1)->set_motion_vector(zero)); break;
+      case GRID_MESH:        scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createGridPlane(p0,dx,dy,1,1)); break;
+      case GRID_MESH_MB:     scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createGridPlane(p0,dx,dy,1,1)->set_motion_vector(zero)); break;
+      case SUBDIV_MESH:      scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createSubdivPlane(p0,dx,dy,1,1,4.0f)); break;
+      case SUBDIV_MESH_MB:   scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createSubdivPlane(p0,dx,dy,1,1,4.0f)->set_motion_vector(zero)); break;
+      default:               throw std::runtime_error("unsupported geometry type: "+to_string(gtype)); 
+      }
+      
+      AssertNoError(device);
+      rtcCommitScene (scene);
+      AssertNoError(device);
+
+      const size_t numRays = 1000;
+      RTCRayHit rays[numRays];
+      bool passed = true;
+
+      for (size_t i=0; i<numRays; i++) {
+        const float rx = random_float();
+        const float ry = random_float();
+        if (i%2) rays[i] = makeRay(Vec3fa(rx,ry,+1),Vec3fa(0,0,-1)); 
+        else     rays[i] = makeRay(Vec3fa(rx,ry,-1),Vec3fa(0,0,+1)); 
+      }
+      
+      IntersectWithMode(imode,ivariant,scene,rays,numRays);
+      
+      for (size_t i=0; i<numRays; i++) 
+      {
+        Vec3fa dir(rays[i].ray.dir_x,rays[i].ray.dir_y,rays[i].ray.dir_z);
+        Vec3fa Ng (rays[i].hit.Ng_x, rays[i].hit.Ng_y, rays[i].hit.Ng_z);
+        if (i%2) passed &= rays[i].hit.geomID == RTC_INVALID_GEOMETRY_ID;
+        else {
+          passed &= rays[i].hit.geomID == 0;
+          if (ivariant & VARIANT_INTERSECT)
+            passed &= dot(dir,Ng) < 0.0f;
+        }
+      }
+      AssertNoError(device);
+
+      return (VerifyApplication::TestReturnValue) passed;
+    }
+  };
+
+  struct RoundLinearCurveTest : public VerifyApplication::IntersectTest
+  {
+    SceneFlags sflags;
+
+    RoundLinearCurveTest (std::string name, int isa, SceneFlags sflags, IntersectMode imode, IntersectVariant ivariant)
+      : VerifyApplication::IntersectTest(name,isa,imode,ivariant,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      if (!supportsIntersectMode(device,imode))
+        return VerifyApplication::SKIPPED;
+
+      /* two segments with a right angle joint at (1,0,0), the radius grows from 0.1 to 0.2 towards the joint */
+      VerifyScene scene(device,sflags);
+      RTCGeometry geom = rtcNewGeometry(device,RTC_GEOMETRY_TYPE_ROUND_LINEAR_CURVE);
+      Vec3fa* vertices = (Vec3fa*) rtcSetNewGeometryBuffer(geom,RTC_BUFFER_TYPE_VERTEX,0,RTC_FORMAT_FLOAT4,sizeof(Vec3fa),3);
+      unsigned int* indices = (unsigned int*) rtcSetNewGeometryBuffer(geom,RTC_BUFFER_TYPE_INDEX,0,RTC_FORMAT_UINT,sizeof(unsigned int),2);
+      vertices[0] = Vec3fa(0.0f,0.0f,0.0f,0.1f);
+      vertices[1] = Vec3fa(1.0f,0.0f,0.0f,0.2f);
+      vertices[2] = Vec3fa(1.0f,1.0f,0.0f,0.1f);
+      indices[0] = 0; indices[1] = 1;
+      rtcCommitGeometry(geom);
+      rtcAttachGeometry(scene,geom);
+      rtcReleaseGeometry(geom);
+      rtcCommitScene (scene);
+      AssertNoError(device);
+
+      /* rays towards the outer corner of the joint only hit its sphere, rays
+       * from above the first segment measure its radius, which includes the
+       * slope of the swept sphere */
+      const Vec3fa dj = normalize(Vec3fa(-1,1,0));
+      const float sqrt2 = sqrtf(2.0f);
+      const float slope = sqrtf(1.0f+0.1f*0.1f);
+      struct Expected { Vec3fa org, dir; float t; };
+      const Expected expected[] = {
+        { Vec3fa(2.0f,-1.0f, 0.00f), dj, sqrt2-0.2f },
+        { Vec3fa(2.0f,-1.0f, 0.19f), dj, sqrt2-sqrtf(0.2f*0.2f-0.19f*0.19f) },
+        { Vec3fa(2.0f,-1.0f, 0.21f), dj, inf },
+        { Vec3fa(2.0f,-1.0f,-0.21f), dj, inf },
+        { Vec3fa(0.1f, 0.0f, 1.00f), Vec3fa(0,0,-1), 1.0f-0.11f*slope },
+        { Vec3fa(0.5f, 0.0f, 1.00f), Vec3fa(0,0,-1), 1.0f-0.15f*slope },
+        { Vec3fa(0.9f, 0.0f, 1.00f), Vec3fa(0,0,-1), 1.0f-0.19f*slope },
+        { Vec3fa(0.5f, 0.16f,1.00f), Vec3fa(0,0,-1), inf },
+      };
+      const size_t numRays = sizeof(expected)/sizeof(Expected);
+
+      RTCRayHit rays[numRays];
+      for (size_t i=0; i<numRays; i++)
+        rays[i] = makeRay(expected[i].org,expected[i].dir);
+      IntersectWithMode(imode,ivariant,scene,rays,numRays);
+
+      for (size_t i=0; i<numRays; i++)
+      {
+        const bool hit = expected[i].t != float(inf);
+        if (ivariant & VARIANT_INTERSECT)
+        {
+          if (hit != (rays[i].hit.geomID == 0)) return VerifyApplication::FAILED;
+          if (hit && abs(rays[i].ray.tfar-expected[i].t) > 2E-3f) return VerifyApplication::FAILED;
+          if (hit && i >= 4 && rays[i].hit.primID != 0) return VerifyApplication::FAILED;
+        }
+        else if (hit != (rays[i].ray.tfar == float(neg_inf)))
+          return VerifyApplication::FAILED;
+      }
+      AssertNoError(device);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct RoundBezierCurveAccuracyTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+
+    RoundBezierCurveAccuracyTest (std::string name, int isa, SceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    static Vec3fa eval(const Vec3fa* p, float u)
+    {
+      const float t0 = (1.0f-u)*(1.0f-u)*(1.0f-u), t1 = 3.0f*u*(1.0f-u)*(1.0f-u);
+      const float t2 = 3.0f*u*u*(1.0f-u), t3 = u*u*u;
+      return t0*p[0]+t1*p[1]+t2*p[2]+t3*p[3];
+    }
+
+    static void intersect(RTCScene scene, RTCRayHit& ray, const RTCRayCone* cone)
+    {
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+      if (cone) rtcIntersectCone1(scene,&context,&ray,cone);
+      else      rtcIntersect1(scene,&context,&ray);
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      /* a slightly bent round bezier curve, whose sub-segments are flat
+       * enough to terminate the subdivision early */
+      const float r = 0.05f;
+      const Vec3fa p[4] = { Vec3fa(-1.0f,0.0f,0.0f,r), Vec3fa(-0.3f,0.1f,0.0f,r), Vec3fa(0.3f,0.1f,0.0f,r), Vec3fa(1.0f,0.0f,0.0f,r) };
+      VerifyScene scene(device,sflags);
+      RTCGeometry geom = rtcNewGeometry(device,RTC_GEOMETRY_TYPE_ROUND_BEZIER_CURVE);
+      Vec3fa* vertices = (Vec3fa*) rtcSetNewGeometryBuffer(geom,RTC_BUFFER_TYPE_VERTEX,0,RTC_FORMAT_FLOAT4,sizeof(Vec3fa),4);
+      unsigned int* indices = (unsigned int*) rtcSetNewGeometryBuffer(geom,RTC_BUFFER_TYPE_INDEX,0,RTC_FORMAT_UINT,sizeof(unsigned int),1);
+      for (size_t i=0; i<4; i++) vertices[i] = p[i];
+      indices[0] = 0;
+      rtcCommitGeometry(geom);
+      rtcAttachGeometry(scene,geom);
+      rtcReleaseGeometry(geom);
+      rtcCommitScene (scene);
+
+      /* the reference is a fine tessellation into round linear segments,
+       * which get intersected in closed form without any subdivision */
+      const unsigned int numSegments = 512;
+      VerifyScene reference(device,sflags);
+      geom = rtcNewGeometry(device,RTC_GEOMETRY_TYPE_ROUND_LINEAR_CURVE);
+      vertices = (Vec3fa*) rtcSetNewGeometryBuffer(geom,RTC_BUFFER_TYPE_VERTEX,0,RTC_FORMAT_FLOAT4,sizeof(Vec3fa),numSegments+1);
+      indices = (unsigned int*) rtcSetNewGeometryBuffer(geom,RTC_BUFFER_TYPE_INDEX,0,RTC_FORMAT_UINT,sizeof(unsigned int),numSegments);
+      for (unsigned int i=0; i<=numSegments; i++) {
+        vertices[i] = eval(p,float(i)/float(numSegments));
+        vertices[i].w = r;
+      }
+      for (unsigned int i=0; i<numSegments; i++) indices[i] = i;
+      rtcCommitGeometry(geom);
+      rtcAttachGeometry(reference,geom);
+      rtcReleaseGeometry(geom);
+      rtcCommitScene (reference);
+      AssertNoError(device);
+
+      /* rays pass the curve axis at a known distance, perpendicular to the
+       * tangent, such that rays closer than the radius hit the curve */
+      const RTCRayCone zeroCone = { 0.0f, 0.0f };
+      const RTCRayCone thinCone = { 0.0f, 0.002f };
+      const Vec3fa dirs[3] = { Vec3fa(0,0,-1), normalize(Vec3fa(0.3f,0.2f,-1.0f)), normalize(Vec3fa(-0.5f,0.0f,-1.0f)) };
+      const float offsets[5] = { 0.0f, -0.5f*r, 0.5f*r, -1.5f*r, 1.5f*r };
+      for (size_t i=1; i<32; i++)
+      {
+        const float u = float(i)/32.0f;
+        const Vec3fa P = eval(p,u);
+        const Vec3fa T = normalize(eval(p,u+1E-3f)-eval(p,u-1E-3f));
+        for (const Vec3fa& dir : dirs)
+        {
+          const Vec3fa side = normalize(cross(T,dir));
+          for (float offset : offsets)
+          {
+            const Vec3fa org = P+offset*side-2.0f*dir;
+            const bool expectHit = abs(offset) < r;
+
+            RTCRayHit ref = makeRay(org,dir);
+            intersect(reference,ref,nullptr);
+            if ((ref.hit.geomID == 0) != expectHit) return VerifyApplication::FAILED;
+
+            for (const RTCRayCone* cone : { (const RTCRayCone*) nullptr, &zeroCone, &thinCone })
+            {
+              RTCRayHit ray = makeRay(org,dir);
+              intersect(scene,ray,cone);
+              if ((ray.hit.geomID == 0) != expectHit) return VerifyApplication::FAILED;
+              if (!expectHit) continue;
+
+              /* the subdivision may stop once a segment fits into the cone footprint */
+              const float footprint = cone ? cone->width+ref.ray.tfar*cone->spreadAngle : 0.0f;
+              if (abs(ray.ray.tfar-ref.ray.tfar) > 1E-2f*r+footprint) return VerifyApplication::FAILED;
+              if (abs(ray.hit.u-u) > 0.05f) return VerifyApplication::FAILED;
+            }
+          }
+        }
+      }
+      AssertNoError(device);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct IntersectionFilterTest : public VerifyApplication::IntersectTest
+  {
+    SceneFlags sflags;
+    RTCBuildQuality quality;
+    bool subdiv;
+
+    IntersectionFilterTest (std::string name, int isa, SceneFlags sflags, RTCBuildQuality quality, bool subdiv, IntersectMode imode, IntersectVariant ivariant)
+      : VerifyApplication::IntersectTest(name,isa,imode,ivariant,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), quality(quality), subdiv(subdiv) {}
+    
+    static void intersectionFilterN(const RTCFilterFunctionNArguments* const args)
+    {
+      if ((size_t)args->geometryUserPtr != 123) 
+        return;
+
+      for (unsigned int i=0; i<args->N; i++)
+      {
+	if (args->valid[i] != -1) continue;
+
+        /* reject hit */
+        if (RTCHitN_primID(args->hit,args->N,i) & 2) {
+          args->valid[i] = 0;
+        }
+      }
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      if (!supportsIntersectMode(device,imode))
+        return VerifyApplication::SKIPPED;
+
+      VerifyScene scene(device,sflags);
+      Vec3fa p0(-0.75f,-0.25f,-10.0f), dx(4,0,0), dy(0,4,0);
+      unsigned int geomID0 = 0;
+      if (subdiv) geomID0 = scene.addSubdivPlane (sampler,quality, 4, p0, dx, dy).first;
+      else        geomID0 = scene.addPlane       (sampler,quality, 4, p0, dx, dy).first;
+      RTCGeometry geom0 = rtcGetGeometry(scene,geomID0);
+      rtcSetGeometryUserData(geom0,(void*)123);
+      rtcSetGeometryIntersectFilterFunction (geom0,intersectionFilterN);
+      rtcSetGeometryOccludedFilterFunction (geom0,intersectionFilterN);
+      rtcCommitScene (scene);
+      AssertNoError(device);
+      
+      RTCRayHit rays[16];
+      for (unsigned int iy=0; iy<4; iy++) 
+      {
+        for (unsigned int ix=0; ix<4; ix++) 
+        {
+          unsigned int primID = iy*4+ix;
+          if (!subdiv) primID *= 2;
+          rays[iy*4+ix] = makeRay(Vec3fa(float(ix),float(iy),0.0f),Vec3fa(0,0,-1));
+        }
+      }
+      IntersectWithMode(imode,ivariant,scene,rays,16);
+      
+      bool passed = true;
+      for (unsigned int iy=0; iy<4; iy++) 
+      {
+        for (unsigned int ix=0; ix<4; ix++) 
+        {
+          unsigned int primID = iy*4+ix;
+          if (!subdiv) primID *= 2;
+          RTCRayHit& ray = rays[iy*4+ix];
+          bool ok = true;
+          if (ivariant & VARIANT_INTERSECT)
+            ok = (primID & 2) ? (ray.hit.geomID == RTC_INVALID_GEOMETRY_ID) : (ray.hit.geomID == 0);
+          else
+            ok = ((primID & 2) != 0) == (ray.ray.tfar != float(neg_inf));
+          if (!ok) passed = false;
+        }
+      }
+      AssertNoError(device);
+
+      return (VerifyApplication::TestReturnValue) passed;
+    }
+  };
+    
+  struct BatchedUserGeometryTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+    static const unsigned int numPrims = 16;
+
+    /* identical squares parallel to the xy-plane, the builder has to split them by count into leaves */
+    struct Squares
+    {
+      Vec3fa center;
+      float halfSize;
+      std::atomic<unsigned int> maxNumPrimIDs;
+      std::atomic<bool> invalidPrimIDs;
+    };
+
+    BatchedUserGeometryTest (std::string name, int isa, SceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    static void bounds(const struct RTCBoundsFunctionArguments* args)
+    {
+      const Squares* squares = (const Squares*) args->geometryUserPtr;
+      BBox3fa* bounds_o = (BBox3fa*)args->bounds_o;
+      bounds_o->lower = squares->center-Vec3fa(squares->halfSize,squares->halfSize,0.0f);
+      bounds_o->upper = squares->center+Vec3fa(squares->halfSize,squares->halfSize,0.0f);
+    }
+
+    /* returns the hit distance of a single ray with the squares, and records the passed primitives */
+    static float intersect(Squares* squares, const unsigned int* primIDs, unsigned int numPrimIDs, const Vec3fa& org, const Vec3fa& dir, float tnear, float tfar)
+    {
+      unsigned int maxNumPrimIDs = squares->maxNumPrimIDs;
+      while (maxNumPrimIDs < numPrimIDs && !squares->maxNumPrimIDs.compare_exchange_weak(maxNumPrimIDs,numPrimIDs));
+      for (unsigned int i=0; i<numPrimIDs; i++) {
+        if (primIDs[i] >= numPrims) squares->invalidPrimIDs = true;
+        for (unsigned int j=0; j<i; j++)
+          if (primIDs[i] == primIDs[j]) squares->invalidPrimIDs = true;
+      }
+      if (dir.z == 0.0f) return neg_inf;
+      const float t = (squares->center.z-org.z)/dir.z;
+      if (!(t >= tnear && t <= tfar)) return neg_inf;
+      const Vec3fa p = org+t*dir;
+      if (abs(p.x-squares->center.x) > squares->halfSize || abs(p.y-squares->center.y) > squares->halfSize) return neg_inf;
+      return t;
+    }
+
+    static void intersectN(const struct RTCIntersectFunctionNArguments* args)
+    {
+      assert(args->N == 1);
+      if (!args->valid[0]) return;
+      RTCRayHit* rayhit = (RTCRayHit*) args->rayhit;
+      RTCRay& ray = rayhit->ray;
+      const float t = intersect((Squares*)args->geometryUserPtr,args->primIDs,args->numPrimIDs,Vec3fa(ray.org_x,ray.org_y,ray.org_z),Vec3fa(ray.dir_x,ray.dir_y,ray.dir_z),ray.tnear,ray.tfar);
+      if (t == float(neg_inf)) return;
+      ray.tfar = t;
+      rayhit->hit.u = rayhit->hit.v = 0.0f;
+      rayhit->hit.Ng_x = rayhit->hit.Ng_y = 0.0f; rayhit->hit.Ng_z = 1.0f;
+      rayhit->hit.primID = args->primIDs[0];
+      rayhit->hit.geomID = 0;
+      rayhit->hit.instID[0] = args->context->instID[0];
+    }
+
+    static void occludedN(const struct RTCOccludedFunctionNArguments* args)
+    {
+      assert(args->N == 1);
+      if (!args->valid[0]) return;
+      RTCRay* ray = (RTCRay*) args->ray;
+      const float t = intersect((Squares*)args->geometryUserPtr,args->primIDs,args->numPrimIDs,Vec3fa(ray->org_x,ray->org_y,ray->org_z),Vec3fa(ray->dir_x,ray->dir_y,ray->dir_z),ray->tnear,ray->tfar);
+      if (t != float(neg_inf)) ray->tfar = neg_inf;
+    }
+
+    /* traces a hitting and a missing ray and returns the maximal number of primitives passed to a callback */
+    bool trace(RTCScene scene, Squares& squares, unsigned int& maxNumPrimIDs)
+    {
+      squares.maxNumPrimIDs = 0;
+      squares.invalidPrimIDs = false;
+
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+      RTCRayHit hit = makeRay(Vec3fa(0.1f,0.2f,0.0f),Vec3fa(0,0,-1));
+      rtcIntersect1(scene,&context,&hit);
+      if (hit.hit.geomID != 0 || hit.hit.primID >= numPrims || hit.ray.tfar != 1.0f) return false;
+
+      RTCRayHit miss = makeRay(Vec3fa(2.0f,0.2f,0.0f),Vec3fa(0,0,-1));
+      rtcIntersect1(scene,&context,&miss);
+      if (miss.hit.geomID != RTC_INVALID_GEOMETRY_ID) return false;
+
+      RTCRayHit shadow = makeRay(Vec3fa(0.1f,0.2f,0.0f),Vec3fa(0,0,-1));
+      rtcOccluded1(scene,&context,&shadow.ray);
+      if (shadow.ray.tfar != float(neg_inf)) return false;
+
+      maxNumPrimIDs = squares.maxNumPrimIDs;
+      return !squares.invalidPrimIDs;
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      Squares squares;
+      squares.center = Vec3fa(0.0f,0.0f,-1.0f);
+      squares.halfSize = 1.0f;
+      VerifyScene scene(device,sflags);
+      RTCGeometry geom = rtcNewGeometry(device,RTC_GEOMETRY_TYPE_USER);
+      rtcSetGeometryUserPrimitiveCount(geom,numPrims);
+      rtcSetGeometryUserData(geom,&squares);
+      rtcSetGeometryBoundsFunction(geom,bounds,nullptr);
+      rtcSetGeometryIntersectFunction(geom,intersectN);
+      rtcSetGeometryOccludedFunction(geom,occludedN);
+      rtcCommitGeometry(geom);
+      rtcAttachGeometryByID(scene,geom,0);
+      rtcReleaseGeometry(geom);
+      rtcCommitScene (scene);
+      AssertNoError(device);
+
+      /* standard callbacks get invoked per primitive */
+      unsigned int maxNumPrimIDs = 0;
+      if (!trace(scene,squares,maxNumPrimIDs)) return VerifyApplication::FAILED;
+      if (maxNumPrimIDs != 1) return VerifyApplication::FAILED;
+
+      /* batched callbacks set after the first build have to get multiple primitives of a leaf */
+      rtcSetGeometryIntersectBatchFunction(geom,intersectN);
+      rtcSetGeometryOccludedBatchFunction(geom,occludedN);
+      rtcCommitGeometry(geom);
+      rtcCommitScene (scene);
+      AssertNoError(device);
+      if (!trace(scene,squares,maxNumPrimIDs)) return VerifyApplication::FAILED;
+      if (maxNumPrimIDs < 2) return VerifyApplication::FAILED;
+      AssertNoError(device);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct OpacityMicromapTest : public VerifyApplication::IntersectTest
+  {
+    SceneFlags sflags;
+    static const unsigned int numTriangles = 2;
+    static const unsigned int N = 4;                // micro triangles per edge of level 2
+    static const unsigned int numMicroTriangles = N*N;
+
+    OpacityMicromapTest (std::string name, int isa, SceneFlags sflags, IntersectMode imode, IntersectVariant ivariant)
+      : VerifyApplication::IntersectTest(name,isa,imode,ivariant,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      if (!supportsIntersectMode(device,imode))
+        return VerifyApplication::SKIPPED;
+
+      /* separate right triangles with u along x and v along y, each with a random level 2 micromap */
+      VerifyScene scene(device,sflags);
+      RTCGeometry geom = rtcNewGeometry(device,RTC_GEOMETRY_TYPE_TRIANGLE);
+      Vec3fa* vertices = (Vec3fa*) rtcSetNewGeometryBuffer(geom,RTC_BUFFER_TYPE_VERTEX,0,RTC_FORMAT_FLOAT3,sizeof(Vec3fa),3*numTriangles);
+      unsigned int* indices = (unsigned int*) rtcSetNewGeometryBuffer(geom,RTC_BUFFER_TYPE_INDEX,0,RTC_FORMAT_UINT3,3*sizeof(unsigned int),numTriangles);
+      unsigned short* masks = (unsigned short*) rtcSetNewGeometryBuffer(geom,RTC_BUFFER_TYPE_OPACITY_MICROMAP,0,RTC_FORMAT_USHORT,sizeof(unsigned short),numTriangles);
+      for (unsigned int i=0; i<numTriangles; i++)
+      {
+        const float x0 = 2.0f*float(i);
+        vertices[3*i+0] = Vec3fa(x0+0.0f,0.0f,-1.0f);
+        vertices[3*i+1] = Vec3fa(x0+1.0f,0.0f,-1.0f);
+        vertices[3*i+2] = Vec3fa(x0+0.0f,1.0f,-1.0f);
+        for (unsigned int j=0; j<3; j++) indices[3*i+j] = 3*i+j;
+        masks[i] = (unsigned short) RandomSampler_getInt(sampler);
+      }
+      rtcCommitGeometry(geom);
+      unsigned int geomID = rtcAttachGeometry(scene,geom);
+      rtcReleaseGeometry(geom);
+      rtcCommitScene (scene);
+      AssertNoError(device);
+
+      /* shoot a ray through the centroid of each micro triangle, enumerated row by row along v */
+      const size_t numRays = numTriangles*numMicroTriangles;
+      RTCRayHit rays[numRays];
+      bool opaque[numRays];
+      for (unsigned int i=0, r=0; i<numTriangles; i++)
+      {
+        for (unsigned int j=0, k=0; j<N; j++)
+        {
+          for (unsigned int m=0; m<2*(N-j)-1; m++, k++, r++)
+          {
+            const float ofs = (m & 1) ? 2.0f/3.0f : 1.0f/3.0f;
+            const float u = (float(m/2)+ofs)/float(N), v = (float(j)+ofs)/float(N);
+            rays[r] = makeRay(Vec3fa(2.0f*float(i)+u,v,0.0f),Vec3fa(0,0,-1));
+            opaque[r] = (masks[i] >> k) & 1;
+          }
+        }
+      }
+      IntersectWithMode(imode,ivariant,scene,rays,numRays);
+
+      bool passed = true;
+      for (unsigned int r=0; r<numRays; r++)
+      {
+        const RTCRayHit& ray = rays[r];
+        bool ok = true;
+        if (ivariant & VARIANT_INTERSECT)
+          ok = opaque[r] ? (ray.hit.geomID == geomID && ray.hit.primID == r/numMicroTriangles) : (ray.hit.geomID == RTC_INVALID_GEOMETRY_ID);
+        else
+          ok = opaque[r] == (ray.ray.tfar == float(neg_inf));
+        if (!ok) passed = false;
+      }
+      AssertNoError(device);
+
+      return (VerifyApplication::TestReturnValue) passed;
+    }
+  };
+
+  struct RayConeTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+    InstancingType itype;
+
+    /* unit square at z=-1 that records the ray cone passed to the callbacks */
+    struct ConeSquare
+    {
+      bool hasCone;
+      RTCRayCone cone;
+    };
+
+    RayConeTest (std::string name, int isa, SceneFlags sflags, InstancingType itype)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), itype(itype) {}
+
+    static void bounds(const struct RTCBoundsFunctionArguments* args)
+    {
+      BBox3fa* bounds_o = (BBox3fa*)args->bounds_o;
+      bounds_o->lower = Vec3fa(-1.0f,-1.0f,-1.0f);
+      bounds_o->upper = Vec3fa(+1.0f,+1.0f,-1.0f);
+    }
+
+    static float intersect(ConeSquare* square, const RTCRayCone* cone, const RTCRay& ray)
+    {
+      square->hasCone = cone != nullptr;
+      if (cone) square->cone = *cone;
+      if (ray.dir_z == 0.0f) return neg_inf;
+      const float t = (-1.0f-ray.org_z)/ray.dir_z;
+      if (!(t >= ray.tnear && t <= ray.tfar)) return neg_inf;
+      if (abs(ray.org_x+t*ray.dir_x) > 1.0f || abs(ray.org_y+t*ray.dir_y) > 1.0f) return neg_inf;
+      return t;
+    }
+
+    static void intersectN(const struct RTCIntersectFunctionNArguments* args)
+    {
+      assert(args->N == 1);
+      if (!args->valid[0]) return;
+      RTCRayHit* rayhit = (RTCRayHit*) args->rayhit;
+      const float t = intersect((ConeSquare*)args->geometryUserPtr,args->cone,rayhit->ray);
+      if (t == float(neg_inf)) return;
+      rayhit->ray.tfar = t;
+      rayhit->hit.u = rayhit->hit.v = 0.0f;
+      rayhit->hit.Ng_x = rayhit->hit.Ng_y = 0.0f; rayhit->hit.Ng_z = 1.0f;
+      rayhit->hit.primID = args->primID;
+      rayhit->hit.geomID = 0;
+      rayhit->hit.instID[0] = args->context->instID[0];
+    }
+
+    static void occludedN(const struct RTCOccludedFunctionNArguments* args)
+    {
+      assert(args->N == 1);
+      if (!args->valid[0]) return;
+      RTCRay* ray = (RTCRay*) args->ray;
+      if (intersect((ConeSquare*)args->geometryUserPtr,args->cone,*ray) != float(neg_inf))
+        ray->tfar = neg_inf;
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      /* a flat subdivision plane and a user geometry, directly in the scene or instanced with uniform scale */
+      const float scale = itype == USER_INSTANCING ? 2.0f : 1.0f;
+      VerifyScene scene(device,sflags);
+      Ref<VerifyScene> objects = itype == USER_INSTANCING ? new VerifyScene(device,sflags) : nullptr;
+      VerifyScene& target = objects ? *objects : scene;
+      ConeSquare square;
+      RTCGeometry geom = rtcNewGeometry(device,RTC_GEOMETRY_TYPE_USER);
+      rtcSetGeometryUserPrimitiveCount(geom,1);
+      rtcSetGeometryUserData(geom,&square);
+      rtcSetGeometryBoundsFunction(geom,bounds,nullptr);
+      rtcSetGeometryIntersectFunction(geom,intersectN);
+      rtcSetGeometryOccludedFunction(geom,occludedN);
+      rtcCommitGeometry(geom);
+      rtcAttachGeometryByID(target,geom,0);
+      rtcReleaseGeometry(geom);
+      const Vec3fa p0(-0.75f,-0.25f,-10.0f), dx(4,0,0), dy(0,4,0);
+      const unsigned int subdivID = target.addSubdivPlane(sampler,RTC_BUILD_QUALITY_MEDIUM,4,p0,dx,dy).first;
+      if (objects) {
+        rtcCommitScene(*objects);
+        scene.addInstance(objects,AffineSpace3fa::scale(Vec3fa(scale)));
+      }
+      rtcCommitScene (scene);
+      AssertNoError(device);
+
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+      const RTCRayCone zeroCone = { 0.0f, 0.0f };
+      const RTCRayCone wideCone = { 4.0f, 0.1f };
+
+      /* the ray cone is passed to user geometry callbacks in the local space of the instance, the ray misses the subdivision plane */
+      for (int occluded=0; occluded<2; occluded++)
+      {
+        RTCRayHit ray = makeRay(Vec3fa(-0.9f,-0.9f,0.0f),Vec3fa(0,0,-1));
+        square.hasCone = true;
+        if (occluded) rtcOccluded1(scene,&context,&ray.ray);
+        else          rtcIntersect1(scene,&context,&ray);
+        if (square.hasCone) return VerifyApplication::FAILED;
+
+        ray = makeRay(Vec3fa(-0.9f,-0.9f,0.0f),Vec3fa(0,0,-1));
+        if (occluded) rtcOccludedCone1(scene,&context,&ray.ray,&wideCone);
+        else          rtcIntersectCone1(scene,&context,&ray,&wideCone);
+        if (!square.hasCone) return VerifyApplication::FAILED;
+        if (abs(square.cone.width-wideCone.width/scale) > 1E-3f*wideCone.width) return VerifyApplication::FAILED;
+        if (square.cone.spreadAngle != wideCone.spreadAngle) return VerifyApplication::FAILED;
+        if (occluded ? ray.ray.tfar != float(neg_inf) : (ray.hit.geomID != 0 || abs(ray.ray.tfar-scale) > 1E-4f)) return VerifyApplication::FAILED;
+      }
+
+      /* cone queries on the flat subdivision plane hit the same plane as standard queries, missing the user geometry */
+      for (unsigned int i=0; i<16; i++)
+      {
+        const Vec3fa org(3.0f*float(i%4)+0.5f-4.0f,3.0f*float(i/4)+0.5f-4.0f,0.0f);
+        if (abs(org.x) <= scale && abs(org.y) <= scale) continue;
+        const Vec3fa dir(0.01f,0.02f,-1.0f);
+
+        RTCRayHit ref = makeRay(org,dir);
+        rtcIntersect1(scene,&context,&ref);
+        const bool hit = ref.hit.geomID != RTC_INVALID_GEOMETRY_ID;
+        if (hit && ref.hit.geomID != subdivID) return VerifyApplication::FAILED;
+
+        for (const RTCRayCone* cone : { (const RTCRayCone*) nullptr, &zeroCone, &wideCone })
+        {
+          RTCRayHit ray = makeRay(org,dir);
+          rtcIntersectCone1(scene,&context,&ray,cone);
+          if (ray.hit.geomID != ref.hit.geomID) return VerifyApplication::FAILED;
+          if (cone != &wideCone && (ray.ray.tfar != ref.ray.tfar || ray.hit.primID != ref.hit.primID || ray.hit.u != ref.hit.u || ray.hit.v != ref.hit.v))
+            return VerifyApplication::FAILED;
+          if (hit && abs(ray.ray.tfar-ref.ray.tfar) > 1E-3f*ref.ray.tfar) return VerifyApplication::FAILED;
+
+          RTCRayHit shadow = makeRay(org,dir);
+          rtcOccludedCone1(scene,&context,&shadow.ray,cone);
+          if ((shadow.ray.tfar == float(neg_inf)) != hit) return VerifyApplication::FAILED;
+        }
+      }
+      AssertNoError(device);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct InstanceLODTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+
+    InstanceLODTest (std::string name, int isa, SceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    /* returns the geometry ID hit inside the instance, which identifies the selected level */
+    static unsigned int trace(RTCScene scene, const Vec3fa& org, unsigned int id, const RTCRayCone* cone)
+    {
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+      RTCRayHit ray = makeRay(org,Vec3fa(0,0,-1));
+      ray.ray.id = id;
+      if (cone) rtcIntersectCone1(scene,&context,&ray,cone);
+      else      rtcIntersect1(scene,&context,&ray);
+      return ray.hit.geomID;
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      /* the plane of level i has geometry ID i, the planes before it are placed away from the rays */
+      Ref<VerifyScene> levels[3];
+      for (unsigned int i=0; i<3; i++)
+      {
+        levels[i] = new VerifyScene(device,sflags);
+        for (unsigned int j=0; j<i; j++)
+          levels[i]->addPlane(sampler,RTC_BUILD_QUALITY_MEDIUM,4,Vec3fa(10,10,0),Vec3fa(1,0,0),Vec3fa(0,1,0));
+        if (levels[i]->addPlane(sampler,RTC_BUILD_QUALITY_MEDIUM,4,Vec3fa(-1,-1,0),Vec3fa(2,0,0),Vec3fa(0,2,0)).first != i)
+          return VerifyApplication::FAILED;
+        rtcCommitScene(*levels[i]);
+      }
+
+      VerifyScene scene(device,sflags);
+      RTCGeometry geom = rtcGetGeometry(scene,scene.addInstance(levels[0],one));
+      rtcSetGeometryInstancedSceneLOD(geom,1,*levels[1],10.0f,4.0f);
+      rtcSetGeometryInstancedSceneLOD(geom,2,*levels[2],100.0f,0.0f);
+      rtcCommitGeometry(geom);
+      rtcCommitScene(scene);
+      AssertNoError(device);
+
+      /* levels selected by the distance to the ray origin */
+      if (trace(scene,Vec3fa(0,0,5),1,nullptr) != 0) return VerifyApplication::FAILED;
+      if (trace(scene,Vec3fa(0,0,50),1,nullptr) != 1) return VerifyApplication::FAILED;
+      if (trace(scene,Vec3fa(0,0,500),1,nullptr) != 2) return VerifyApplication::FAILED;
+
+      /* ray cones move the origin width/spreadAngle back */
+      RTCRayCone cone; cone.width = 0.1f; cone.spreadAngle = 0.01f;
+      if (trace(scene,Vec3fa(0,0,5),1,&cone) != 1) return VerifyApplication::FAILED;
+      cone.spreadAngle = 0.001f;
+      if (trace(scene,Vec3fa(0,0,50),1,&cone) != 2) return VerifyApplication::FAILED;
+      cone.spreadAngle = 0.0f;
+      if (trace(scene,Vec3fa(0,0,5),1,&cone) != 0) return VerifyApplication::FAILED;
+
+      /* inside the blend range rays with the same ID select the same level,
+       * while rays without ID have to select both levels */
+      size_t numLevel[2][2] = { { 0, 0 }, { 0, 0 } };
+      for (unsigned int i=0; i<256; i++)
+      {
+        const Vec3fa org(0.001f*float(i%16),0.001f*float(i/16),10.0f);
+        for (unsigned int id=0; id<2; id++) {
+          const unsigned int level = trace(scene,org,id ? 7 : 0,nullptr);
+          if (level > 1) return VerifyApplication::FAILED;
+          numLevel[id][level]++;
+        }
+      }
+      if (numLevel[0][0] == 0 || numLevel[0][1] == 0) return VerifyApplication::FAILED;
+      if (numLevel[1][0] != 0 && numLevel[1][1] != 0) return VerifyApplication::FAILED;
+      AssertNoError(device);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct MultiHitTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+    InstancingType itype;
+    static const unsigned int K = 5;
+
+    MultiHitTest (std::string name, int isa, SceneFlags sflags, InstancingType itype)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), itype(itype) {}
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      /* K parallel planes along the ray, either directly in the scene, in an instanced scene, or replaced by automatic instances */
+      SceneFlags tflags = sflags;
+      if (itype == AUTO_INSTANCING) tflags.sflags = (RTCSceneFlags)(tflags.sflags | RTC_SCENE_FLAG_AUTO_INSTANCING);
+      VerifyScene scene(device,tflags);
+      Ref<VerifyScene> planes = itype == USER_INSTANCING ? new VerifyScene(device,sflags) : nullptr;
+      unsigned int geomIDs[K];
+      for (unsigned int k=0; k<K; k++) {
+        const Vec3fa p0(-0.75f,-0.25f,-1.0f-float(k)), dx(4,0,0), dy(0,4,0);
+        geomIDs[k] = (planes ? *planes : scene).addPlane(sampler,RTC_BUILD_QUALITY_MEDIUM,4,p0,dx,dy).first;
+      }
+      unsigned int instID = RTC_INVALID_GEOMETRY_ID;
+      if (planes) {
+        rtcCommitScene(*planes);
+        instID = scene.addInstance(planes,AffineSpace3fa(one));
+      }
+      rtcCommitScene (scene);
+      AssertNoError(device);
+
+      for (unsigned int maxHitCount : { 1u, 3u, K, K+3 })
+      {
+        RTCIntersectContext context;
+        rtcInitIntersectContext(&context);
+        RTCRayHit ray = makeRay(Vec3fa(0.3f,0.45f,0.0f),Vec3fa(0,0,-1));
+        RTCMultiHit hits[K+3];
+        const unsigned int numHits = rtcIntersectMultiHit1(scene,&context,&ray.ray,hits,maxHitCount);
+        AssertNoError(device);
+
+        /* the closest hits are reported sorted by distance and the ray is not modified */
+        if (numHits != min(maxHitCount,K)) return VerifyApplication::FAILED;
+        if (ray.ray.tfar != float(inf)) return VerifyApplication::FAILED;
+        for (unsigned int i=0; i<numHits; i++)
+        {
+          if (abs(hits[i].t - float(i+1)) > 16.0f*float(ulp)) return VerifyApplication::FAILED;
+          if (hits[i].hit.geomID != geomIDs[i]) return VerifyApplication::FAILED;
+          if (hits[i].hit.instID[0] != instID) return VerifyApplication::FAILED;
+          if (hits[i].hit.primID != hits[0].hit.primID) return VerifyApplication::FAILED;
+        }
+      }
+      AssertNoError(device);
+
+      return VerifyApplication::PASSED;
     }
   };
 
-  struct BackfaceCullingTest : public VerifyApplication::IntersectTest
+  static float transmittanceOpacityFunction(const RTCOpacityFunctionArguments* args) {
+    return *(const float*)args->geometryUserPtr;
+  }
+
+  struct TransmittanceTest : public VerifyApplication::Test
   {
     SceneFlags sflags;
-    RTCBuildQuality quality;
-    GeometryType gtype;
+    InstancingType itype;
+    static const unsigned int K = 5;
+
+    TransmittanceTest (std::string name, int isa, SceneFlags sflags, InstancingType itype)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), itype(itype) {}
 
-    BackfaceCullingTest (std::string name, int isa, SceneFlags sflags, RTCBuildQuality quality, GeometryType gtype, IntersectMode imode, IntersectVariant ivariant)
-      : VerifyApplication::IntersectTest(name,isa,imode,ivariant,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), quality(quality), gtype(gtype) {}
-    
     VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
     {
       std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
       RTCDeviceRef device = rtcNewDevice(cfg.c_str());
       errorHandler(nullptr,rtcGetDeviceError(device));
-      if (!supportsIntersectMode(device,imode))
-        return VerifyApplication::SKIPPED;
-       
-      /* create triangle that is front facing for a right handed 
-         coordinate system if looking along the z direction */
-      VerifyScene scene(device,sflags);
-      AssertNoError(device);
-      const Vec3fa p0 = Vec3fa(0.0f);
-      const Vec3fa dx = Vec3fa(0.0f,1.0f,0.0f);
-      const Vec3fa dy = Vec3fa(1.0f,0.0f,0.0f);
-      switch (gtype) {
-      case TRIANGLE_MESH:    scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createTrianglePlane(p0,dx,dy,1,1)); break;
-      case TRIANGLE_MESH_MB: scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createTrianglePlane(p0,dx,dy,1,1)->set_motion_vector(zero)); break;
-      case QUAD_MESH:        scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createQuadPlane(p0,dx,dy,1,1)); break;
-      case QUAD_MESH_MB:     scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createQuadPlane(p0,dx,dy,1,1)->set_motion_vector(zero)); break;
-      case GRID_MESH:        scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createGridPlane(p0,dx,dy,1,1)); break;
-      case GRID_MESH_MB:     scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createGridPlane(p0,dx,dy,1,1)->set_motion_vector(zero)); break;
-      case SUBDIV_MESH:      scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createSubdivPlane(p0,dx,dy,1,1,4.0f)); break;
-      case SUBDIV_MESH_MB:   scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,SceneGraph::createSubdivPlane(p0,dx,dy,1,1,4.0f)->set_motion_vector(zero)); break;
-      default:               throw std::runtime_error("unsupported geometry type: "+to_string(gtype)); 
+
+      /* K-1 half transparent planes followed by an opaque plane without opacity function */
+      SceneFlags tflags = sflags;
+      if (itype == AUTO_INSTANCING) tflags.sflags = (RTCSceneFlags)(tflags.sflags | RTC_SCENE_FLAG_AUTO_INSTANCING);
+      VerifyScene scene(device,tflags);
+      Ref<VerifyScene> planes = itype == USER_INSTANCING ? new VerifyScene(device,sflags) : nullptr;
+      float opacity = 0.5f;
+      for (unsigned int k=0; k<K; k++)
+      {
+        VerifyScene& target = planes ? *planes : scene;
+        const Vec3fa p0(-0.75f,-0.25f,-1.0f-float(k)), dx(4,0,0), dy(0,4,0);
+        const unsigned int geomID = target.addPlane(sampler,RTC_BUILD_QUALITY_MEDIUM,4,p0,dx,dy).first;
+        if (k == K-1) continue;
+        RTCGeometry geom = rtcGetGeometry(target,geomID);
+        rtcSetGeometryUserData(geom,&opacity);
+        rtcSetGeometryOpacityFunction(geom,transmittanceOpacityFunction);
+        rtcCommitGeometry(geom);
+      }
+      if (planes) {
+        rtcCommitScene(*planes);
+        scene.addInstance(planes,AffineSpace3fa(one));
       }
-      
-      AssertNoError(device);
       rtcCommitScene (scene);
       AssertNoError(device);
 
-      const size_t numRays = 1000;
-      RTCRayHit rays[numRays];
-      bool passed = true;
+      const float T = powf(1.0f-opacity,float(K-1));
+      const Vec3fa org(0.3f,0.45f,0.0f), dir(0,0,-1);
+      struct Query { float tfar; float minTransmittance; float expected; };
+      const Query queries[] = {
+        { 0.5f, 0.0f, 1.0f },                       // no plane in front of the ray end
+        { float(K)-0.5f, 0.0f, T },                 // product over all transparent planes
+        { float(K)-0.5f, 0.5f*T, T },               // threshold below the result
+        { float(K)-0.5f, 2.0f*T, 0.0f },            // early termination at the threshold
+        { float(inf), 0.0f, 0.0f }                  // opaque plane blocks the ray
+      };
 
-      for (size_t i=0; i<numRays; i++) {
-        const float rx = random_float();
-        const float ry = random_float();
-        if (i%2) rays[i] = makeRay(Vec3fa(rx,ry,+1),Vec3fa(0,0,-1)); 
-        else     rays[i] = makeRay(Vec3fa(rx,ry,-1),Vec3fa(0,0,+1)); 
+      for (const Query& q : queries)
+      {
+        RTCIntersectContext context;
+        rtcInitIntersectContext(&context);
+        RTCRayHit ray = makeRay(org,dir);
+        ray.ray.tfar = q.tfar;
+        const float transmittance = rtcOccludedTransmittance1(scene,&context,&ray.ray,q.minTransmittance);
+        AssertNoError(device);
+        if (abs(transmittance-q.expected) > 16.0f*float(ulp)) return VerifyApplication::FAILED;
+
+        /* opacity functions are ignored by standard occlusion queries */
+        rtcOccluded1(scene,&context,&ray.ray);
+        if ((ray.ray.tfar == float(neg_inf)) != (q.tfar > 1.0f)) return VerifyApplication::FAILED;
       }
-      
-      IntersectWithMode(imode,ivariant,scene,rays,numRays);
-      
-      for (size_t i=0; i<numRays; i++) 
+      AssertNoError(device);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct TransmittanceSpatialSplitTest : public VerifyApplication::Test
+  {
+    static const unsigned int K = 300;
+
+    TransmittanceSpatialSplitTest (std::string name, int isa)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS) {}
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      /* long thin slanted triangles of different orientation around the
+       * rays, spatial splits reference each of them multiple times */
+      VerifyScene scene(device,SceneFlags(RTC_SCENE_FLAG_NONE,RTC_BUILD_QUALITY_HIGH));
+      RTCGeometry geom = rtcNewGeometry(device,RTC_GEOMETRY_TYPE_TRIANGLE);
+      Vec3f* vertices = (Vec3f*) rtcSetNewGeometryBuffer(geom,RTC_BUFFER_TYPE_VERTEX,0,RTC_FORMAT_FLOAT3,sizeof(Vec3f),3*K);
+      unsigned int* indices = (unsigned int*) rtcSetNewGeometryBuffer(geom,RTC_BUFFER_TYPE_INDEX,0,RTC_FORMAT_UINT3,3*sizeof(unsigned int),K);
+      for (unsigned int k=0; k<K; k++)
       {
-        Vec3fa dir(rays[i].ray.dir_x,rays[i].ray.dir_y,rays[i].ray.dir_z);
-        Vec3fa Ng (rays[i].hit.Ng_x, rays[i].hit.Ng_y, rays[i].hit.Ng_z);
-        if (i%2) passed &= rays[i].hit.geomID == RTC_INVALID_GEOMETRY_ID;
-        else {
-          passed &= rays[i].hit.geomID == 0;
-          if (ivariant & VARIANT_INTERSECT)
-            passed &= dot(dir,Ng) < 0.0f;
-        }
+        const float z = -1.0f-0.01f*float(k);
+        const float a = 2.0f*float(pi)*float(k)/float(K);
+        vertices[3*k+0] = Vec3f(-10.0f*cosf(a),-10.0f*sinf(a),z-0.5f);
+        vertices[3*k+1] = Vec3f(+10.0f*cosf(a),+10.0f*sinf(a),z+0.5f);
+        vertices[3*k+2] = Vec3f(-2.0f*sinf(a),2.0f*cosf(a),z);
+        for (unsigned int j=0; j<3; j++) indices[3*k+j] = 3*k+j;
       }
+      float opacity = 0.01f;
+      rtcSetGeometryUserData(geom,&opacity);
+      rtcSetGeometryOpacityFunction(geom,transmittanceOpacityFunction);
+      rtcCommitGeometry(geom);
+      rtcAttachGeometry(scene,geom);
+      rtcReleaseGeometry(geom);
+      rtcCommitScene (scene);
       AssertNoError(device);
 
-      return (VerifyApplication::TestReturnValue) passed;
+      /* each triangle has to contribute exactly once, also after more than MAX_HITS hits */
+      std::vector<RTCMultiHit> hits(K);
+      for (unsigned int i=0; i<100; i++)
+      {
+        RTCIntersectContext context;
+        rtcInitIntersectContext(&context);
+        RTCRayHit ray = makeRay(Vec3fa(0.01f*float(i%10)-0.05f,0.01f*float(i/10)-0.05f,0.0f),Vec3fa(0,0,-1));
+        const unsigned int numHits = rtcIntersectMultiHit1(scene,&context,&ray.ray,hits.data(),K);
+        const float transmittance = rtcOccludedTransmittance1(scene,&context,&ray.ray,0.0f);
+        const float expected = powf(1.0f-opacity,float(numHits));
+        if (numHits <= 64 || abs(transmittance-expected) > 1E-4f) return VerifyApplication::FAILED;
+      }
+      AssertNoError(device);
+
+      return VerifyApplication::PASSED;
     }
   };
 
-  struct IntersectionFilterTest : public VerifyApplication::IntersectTest
+  struct TraversalCountersTest : public VerifyApplication::Test
   {
     SceneFlags sflags;
-    RTCBuildQuality quality;
-    bool subdiv;
 
-    IntersectionFilterTest (std::string name, int isa, SceneFlags sflags, RTCBuildQuality quality, bool subdiv, IntersectMode imode, IntersectVariant ivariant)
-      : VerifyApplication::IntersectTest(name,isa,imode,ivariant,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags), quality(quality), subdiv(subdiv) {}
-    
-    static void intersectionFilterN(const RTCFilterFunctionNArguments* const args)
+    TraversalCountersTest (std::string name, int isa, SceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    static RTCTraversalCounters sum(RTCDevice device)
     {
-      if ((size_t)args->geometryUserPtr != 123) 
-        return;
+      std::vector<RTCTraversalCounters> counters(rtcGetDeviceTraversalCounters(device,nullptr,0));
+      counters.resize(rtcGetDeviceTraversalCounters(device,counters.data(),counters.size()));
+      RTCTraversalCounters total;
+      memset(&total,0,sizeof(total));
+      for (auto& c : counters) {
+        total.traversals += c.traversals;
+        total.nodes += c.nodes;
+        total.leaves += c.leaves;
+        total.primitives += c.primitives;
+        total.instanceTransitions += c.instanceTransitions;
+        total.maxStackDepth = max(total.maxStackDepth,c.maxStackDepth);
+      }
+      return total;
+    }
 
-      for (unsigned int i=0; i<args->N; i++)
+    static void trace(RTCScene scene)
+    {
+      for (size_t i=0; i<16; i++)
       {
-	if (args->valid[i] != -1) continue;
-
-        /* reject hit */
-        if (RTCHitN_primID(args->hit,args->N,i) & 2) {
-          args->valid[i] = 0;
-        }
+        RTCIntersectContext context;
+        rtcInitIntersectContext(&context);
+        const Vec3fa org(0.1f*float(i%4)-0.15f,0.1f*float(i/4)-0.15f,1.0f);
+        RTCRayHit ray0 = makeRay(org,Vec3fa(0,0,-1));
+        rtcIntersect1(scene,&context,&ray0);
+        RTCRayHit ray1 = makeRay(org,Vec3fa(0,0,-1));
+        rtcOccluded1(scene,&context,&ray1.ray);
       }
     }
 
@@ -2599,55 +4353,103 @@ namespace embree
       std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
       RTCDeviceRef device = rtcNewDevice(cfg.c_str());
       errorHandler(nullptr,rtcGetDeviceError(device));
-      if (!supportsIntersectMode(device,imode))
-        return VerifyApplication::SKIPPED;
+      rtcSetDeviceProperty(device,RTC_DEVICE_PROPERTY_TRAVERSAL_COUNTERS_ENABLED,1);
+      if (rtcGetDeviceProperty(device,RTC_DEVICE_PROPERTY_TRAVERSAL_COUNTERS_ENABLED) != 1)
+        return VerifyApplication::FAILED;
+
+      Ref<VerifyScene> flat = new VerifyScene(device,sflags);
+      flat->addPlane(sampler,RTC_BUILD_QUALITY_MEDIUM,16,Vec3fa(-1,-1,0),Vec3fa(2,0,0),Vec3fa(0,2,0));
+      rtcCommitScene(*flat);
+      VerifyScene instanced(device,sflags);
+      instanced.addInstance(flat,one);
+      rtcCommitScene(instanced);
+      AssertNoError(device);
 
-      VerifyScene scene(device,sflags);
-      Vec3fa p0(-0.75f,-0.25f,-10.0f), dx(4,0,0), dy(0,4,0);
-      unsigned int geomID0 = 0;
-      if (subdiv) geomID0 = scene.addSubdivPlane (sampler,quality, 4, p0, dx, dy).first;
-      else        geomID0 = scene.addPlane       (sampler,quality, 4, p0, dx, dy).first;
-      RTCGeometry geom0 = rtcGetGeometry(scene,geomID0);
-      rtcSetGeometryUserData(geom0,(void*)123);
-      rtcSetGeometryIntersectFilterFunction (geom0,intersectionFilterN);
-      rtcSetGeometryOccludedFilterFunction (geom0,intersectionFilterN);
-      rtcCommitScene (scene);
+      /* flat scene */
+      trace(*flat);
+      RTCTraversalCounters c = sum(device);
+      if (c.traversals == 0 || c.nodes == 0 || c.leaves == 0 || c.primitives == 0) return VerifyApplication::FAILED;
+      if (c.instanceTransitions != 0) return VerifyApplication::FAILED;
+
+      /* resetting keeps the threads but clears their counters */
+      const size_t numThreads = rtcGetDeviceTraversalCounters(device,nullptr,0);
+      rtcResetDeviceTraversalCounters(device);
+      if (rtcGetDeviceTraversalCounters(device,nullptr,0) != numThreads) return VerifyApplication::FAILED;
+      c = sum(device);
+      if (c.traversals || c.nodes || c.leaves || c.primitives || c.instanceTransitions || c.maxStackDepth) return VerifyApplication::FAILED;
+
+      /* instanced scene */
+      trace(instanced);
+      c = sum(device);
+      if (c.traversals == 0 || c.nodes == 0 || c.leaves == 0 || c.instanceTransitions == 0) return VerifyApplication::FAILED;
+      rtcResetDeviceTraversalCounters(device);
+      c = sum(device);
+      if (c.traversals || c.nodes || c.leaves || c.primitives || c.instanceTransitions || c.maxStackDepth) return VerifyApplication::FAILED;
       AssertNoError(device);
-      
-      RTCRayHit rays[16];
-      for (unsigned int iy=0; iy<4; iy++) 
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct AutoInstancingTest : public VerifyApplication::Test
+  {
+    SceneFlags sflags;
+    static const unsigned int N = 8;
+
+    AutoInstancingTest (std::string name, int isa, SceneFlags sflags)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      /* translated copies of a triangle and a quad mesh, and meshes with
+       * the same topology but a different shape that must not get instanced */
+      SceneFlags aflags = sflags;
+      aflags.sflags = (RTCSceneFlags)(aflags.sflags | RTC_SCENE_FLAG_AUTO_INSTANCING);
+      VerifyScene reference(device,sflags);
+      VerifyScene scene(device,aflags);
+      std::vector<Vec3fa> centers;
+      for (unsigned int i=0; i<=N; i++)
       {
-        for (unsigned int ix=0; ix<4; ix++) 
-        {
-          unsigned int primID = iy*4+ix;
-          if (!subdiv) primID *= 2;
-          rays[iy*4+ix] = makeRay(Vec3fa(float(ix),float(iy),0.0f),Vec3fa(0,0,-1));
-        }
+        const float radius = i < N ? 1.0f : 0.5f;
+        const Vec3fa c0(3.0f*float(i),0.0f,0.0f), c1(3.0f*float(i),3.0f,0.0f);
+        Ref<SceneGraph::Node> tris = SceneGraph::createTriangleSphere(c0,radius,8);
+        Ref<SceneGraph::Node> quads = SceneGraph::createQuadSphere(c1,radius,8);
+        if (reference.addGeometry(RTC_BUILD_QUALITY_MEDIUM,tris) != scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,tris)) return VerifyApplication::FAILED;
+        if (reference.addGeometry(RTC_BUILD_QUALITY_MEDIUM,quads) != scene.addGeometry(RTC_BUILD_QUALITY_MEDIUM,quads)) return VerifyApplication::FAILED;
+        centers.push_back(c0);
+        centers.push_back(c1);
       }
-      IntersectWithMode(imode,ivariant,scene,rays,16);
-      
-      bool passed = true;
-      for (unsigned int iy=0; iy<4; iy++) 
+      rtcCommitScene (reference);
+      rtcCommitScene (scene);
+      AssertNoError(device);
+
+      /* hits have to report the IDs of the original meshes */
+      for (const Vec3fa& c : centers)
       {
-        for (unsigned int ix=0; ix<4; ix++) 
+        for (const Vec3fa& d : { Vec3fa(0.13f,0.27f,0.0f), Vec3fa(-0.31f,0.07f,0.0f), Vec3fa(0.21f,-0.36f,0.0f) })
         {
-          unsigned int primID = iy*4+ix;
-          if (!subdiv) primID *= 2;
-          RTCRayHit& ray = rays[iy*4+ix];
-          bool ok = true;
-          if (ivariant & VARIANT_INTERSECT)
-            ok = (primID & 2) ? (ray.hit.geomID == RTC_INVALID_GEOMETRY_ID) : (ray.hit.geomID == 0);
-          else
-            ok = ((primID & 2) != 0) == (ray.ray.tfar != float(neg_inf));
-          if (!ok) passed = false;
+          RTCIntersectContext context;
+          rtcInitIntersectContext(&context);
+          RTCRayHit ray0 = makeRay(c+d+Vec3fa(0,0,5),Vec3fa(0,0,-1));
+          RTCRayHit ray1 = ray0;
+          rtcIntersect1(reference,&context,&ray0);
+          rtcIntersect1(scene,&context,&ray1);
+          if (ray0.hit.geomID == RTC_INVALID_GEOMETRY_ID) return VerifyApplication::FAILED;
+          if (ray0.hit.geomID != ray1.hit.geomID || ray0.hit.primID != ray1.hit.primID) return VerifyApplication::FAILED;
+          if (ray1.hit.instID[0] != RTC_INVALID_GEOMETRY_ID) return VerifyApplication::FAILED;
+          if (abs(ray0.ray.tfar-ray1.ray.tfar) > 1E-4f) return VerifyApplication::FAILED;
         }
       }
       AssertNoError(device);
 
-      return (VerifyApplication::TestReturnValue) passed;
+      return VerifyApplication::PASSED;
     }
   };
-    
+
   struct InactiveRaysTest : public VerifyApplication::IntersectTest
   {
     SceneFlags sflags;
@@ -3771,6 +5573,9 @@ namespace embree
       case DISC_GEOMETRY_MB:  scene->addGeometry(quality,SceneGraph::createPointSphere(zero, one, float(one)/100.f, numPhi, SceneGraph::DISC)->set_motion_vector(random_motion_vector2(0.01f))); break;
       case ORIENTED_DISC_GEOMETRY:  scene->addGeometry(quality,SceneGraph::createPointSphere(zero, one, float(one)/100.f, numPhi, SceneGraph::ORIENTED_DISC)); break;
       case ORIENTED_DISC_GEOMETRY_MB:  scene->addGeometry(quality,SceneGraph::createPointSphere(zero, one, float(one)/100.f, numPhi, SceneGraph::ORIENTED_DISC)->set_motion_vector(random_motion_vector2(0.01f))); break;
+      case HAIR_GEOMETRY:    scene->addGeometry(quality,SceneGraph::createHairyPlane(1,Vec3fa(-1,1,-1),Vec3fa(2,0,0),Vec3fa(0,0,2),0.2f,0.01f,4*numPhi*numPhi,SceneGraph::FLAT_CURVE)); break;
+      case HAIR_GEOMETRY_MB: scene->addGeometry(quality,SceneGraph::createHairyPlane(1,Vec3fa(-1,1,-1),Vec3fa(2,0,0),Vec3fa(0,0,2),0.2f,0.01f,4*numPhi*numPhi,SceneGraph::FLAT_CURVE)->set_motion_vector(random_motion_vector2(0.01f))); break;
+      case INSTANCED_TRIANGLE_MESH: scene->addInstancedSpheres(quality,sflags,numPhi); break;
       default:               throw std::runtime_error("invalid geometry for benchmark");
       }
       rtcCommitScene (*scene);
@@ -3949,6 +5754,9 @@ namespace embree
       case DISC_GEOMETRY_MB:  scene->addGeometry(quality,SceneGraph::createPointSphere(zero, one, float(one)/100.f, numPhi, SceneGraph::DISC)->set_motion_vector(random_motion_vector2(0.01f))); break;
       case ORIENTED_DISC_GEOMETRY:  scene->addGeometry(quality,SceneGraph::createPointSphere(zero, one, float(one)/100.f, numPhi, SceneGraph::ORIENTED_DISC)); break;
       case ORIENTED_DISC_GEOMETRY_MB:  scene->addGeometry(quality,SceneGraph::createPointSphere(zero, one, float(one)/100.f, numPhi, SceneGraph::ORIENTED_DISC)->set_motion_vector(random_motion_vector2(0.01f))); break;
+      case HAIR_GEOMETRY:    scene->addGeometry(quality,SceneGraph::createHairyPlane(1,Vec3fa(-1,1,-1),Vec3fa(2,0,0),Vec3fa(0,0,2),0.2f,0.01f,4*numPhi*numPhi,SceneGraph::FLAT_CURVE)); break;
+      case HAIR_GEOMETRY_MB: scene->addGeometry(quality,SceneGraph::createHairyPlane(1,Vec3fa(-1,1,-1),Vec3fa(2,0,0),Vec3fa(0,0,2),0.2f,0.01f,4*numPhi*numPhi,SceneGraph::FLAT_CURVE)->set_motion_vector(random_motion_vector2(0.01f))); break;
+      case INSTANCED_TRIANGLE_MESH: scene->addInstancedSpheres(quality,sflags,numPhi); break;
       default:               throw std::runtime_error("invalid geometry for benchmark");
       }
       rtcCommitScene (*scene);
@@ -4199,7 +6007,7 @@ namespace embree
       tests(new TestGroup("",false,false)), 
       device(nullptr),
       user_specified_tests(false), flatten(true), parallel(true), cdash(false), 
-      database(""), update_database(false), benchmark_tolerance(0.05f),
+      database(""), update_database(false), benchmark_tolerance(0.05f), benchmark_frames(8), benchmark_json(""),
       usecolors(true)
   {
     rtcore = ""; // do not start threads nor set affinty for normal tests 
@@ -4309,6 +6117,8 @@ namespace embree
         groups.top()->add(new GetBoundsTest(to_string(gtype),isa,gtype));
       groups.pop();
 
+      groups.top()->add(new DisplacedSubdivBoundsTest("get_displaced_subdiv_bounds",isa));
+
       push(new TestGroup("get_linear_bounds",true,true));
       for (auto gtype : gtypes_all)
         groups.top()->add(new GetLinearBoundsTest(to_string(gtype),isa,gtype));
@@ -4344,6 +6154,36 @@ namespace embree
       for (auto sflags : sceneFlags) 
         groups.top()->add(new BuildTest(to_string(sflags),isa,sflags,RTC_BUILD_QUALITY_MEDIUM));
       groups.pop();
+
+      push(new TestGroup("trace_file",true,false));
+      for (auto sflags : sceneFlags)
+        groups.top()->add(new TraceFileTest(to_string(sflags),isa,sflags));
+      groups.pop();
+
+      push(new TestGroup("mapped_buffer",true,true));
+      for (auto sflags : sceneFlags)
+        groups.top()->add(new MappedBufferTest(to_string(sflags),isa,sflags));
+      groups.pop();
+
+      push(new TestGroup("numa_replication",true,true));
+      for (auto sflags : sceneFlags)
+        groups.top()->add(new NumaReplicationTest(to_string(sflags),isa,sflags));
+      groups.pop();
+
+      push(new TestGroup("build_memory_budget",true,true));
+      for (auto sflags : sceneFlags)
+        groups.top()->add(new BuildMemoryBudgetTest(to_string(sflags),isa,sflags));
+      groups.pop();
+
+      push(new TestGroup("background_build",true,true));
+      for (auto sflags : sceneFlags)
+        groups.top()->add(new BackgroundBuildTest(to_string(sflags),isa,sflags));
+      groups.pop();
+
+      push(new TestGroup("build_report",true,true));
+      for (auto sflags : sceneFlags)
+        groups.top()->add(new BuildReportTest(to_string(sflags),isa,sflags));
+      groups.pop();
       
       push(new TestGroup("overlapping_primitives",true,false));
       for (auto sflags : sceneFlags)
@@ -4421,6 +6261,12 @@ namespace embree
       for (auto s : interpolateTests)
         groups.top()->add(new InterpolateSubdivTest(std::to_string((long long)(s)),isa,s));
       groups.pop();
+
+      /* batches above 64 samples get sorted, above 8192 samples with the radix sort */
+      push(new TestGroup("subdiv_n",true,true));
+      for (auto n : { 16u, 100u, 9000u })
+        groups.top()->add(new InterpolateNSubdivTest(std::to_string((long long)(n)),isa,n));
+      groups.pop();
         
       push(new TestGroup("hair",true,true));
       for (auto s : interpolateTests) 
@@ -4449,6 +6295,21 @@ namespace embree
                 groups.top()->add(new QuadHitTest(to_string(sflags,imode,ivariant),isa,sflags,RTC_BUILD_QUALITY_MEDIUM,imode,ivariant));
       groups.pop();
 
+      push(new TestGroup("compressed_vertices",true,true));
+      for (auto gtype : { TRIANGLE_MESH, QUAD_MESH })
+        for (auto format : { RTC_FORMAT_HALF3, RTC_FORMAT_USHORT3 })
+          for (auto sflags : sceneFlags)
+            for (auto imode : intersectModes)
+              groups.top()->add(new CompressedVerticesTest(to_string(gtype)+"."+to_string(sflags,imode)+(format == RTC_FORMAT_HALF3 ? ".half3" : ".ushort3"),isa,sflags,gtype,format,imode));
+      groups.pop();
+
+      push(new TestGroup("meshlet_indices",true,true));
+      for (auto gtype : { TRIANGLE_MESH, QUAD_MESH })
+        for (auto sflags : sceneFlags)
+          for (auto imode : intersectModes)
+            groups.top()->add(new MeshletIndicesTest(to_string(gtype)+"."+to_string(sflags,imode),isa,sflags,gtype,imode));
+      groups.pop();
+
       if (rtcGetDeviceProperty(device,RTC_DEVICE_PROPERTY_RAY_MASK_SUPPORTED)) 
       {
         push(new TestGroup("ray_masks",true,true));
@@ -4471,6 +6332,19 @@ namespace embree
                     groups.top()->add(new BackfaceCullingTest(to_string(gtype,sflags,imode,ivariant),isa,sflags,RTC_BUILD_QUALITY_MEDIUM,gtype,imode,ivariant));
         groups.pop();
       }
+
+      push(new TestGroup("round_linear_curves",true,true));
+      for (auto sflags : sceneFlags)
+        for (auto imode : intersectModes)
+          for (auto ivariant : intersectVariants)
+            if (has_variant(imode,ivariant))
+              groups.top()->add(new RoundLinearCurveTest(to_string(sflags,imode,ivariant),isa,sflags,imode,ivariant));
+      groups.pop();
+
+      push(new TestGroup("round_bezier_curve_accuracy",true,true));
+      for (auto sflags : sceneFlags)
+        groups.top()->add(new RoundBezierCurveAccuracyTest(to_string(sflags),isa,sflags));
+      groups.pop();
       
       push(new TestGroup("intersection_filter",true,true));
       if (rtcGetDeviceProperty(device,RTC_DEVICE_PROPERTY_FILTER_FUNCTION_SUPPORTED)) 
@@ -4490,6 +6364,59 @@ namespace embree
       }
       groups.pop();
       
+      push(new TestGroup("batched_user_geometry",true,true));
+      for (auto sflags : sceneFlags)
+        groups.top()->add(new BatchedUserGeometryTest(to_string(sflags),isa,sflags));
+      groups.pop();
+
+      push(new TestGroup("opacity_micromap",true,true));
+      for (auto sflags : sceneFlags)
+        for (auto imode : intersectModes)
+          for (auto ivariant : intersectVariants)
+            if (has_variant(imode,ivariant))
+              groups.top()->add(new OpacityMicromapTest(to_string(sflags,imode,ivariant),isa,sflags,imode,ivariant));
+      groups.pop();
+
+      push(new TestGroup("ray_cones",true,true));
+      for (auto sflags : sceneFlags)
+        for (auto itype : { NO_INSTANCING, USER_INSTANCING })
+          groups.top()->add(new RayConeTest(to_string(sflags)+"."+to_string(itype),isa,sflags,itype));
+      groups.pop();
+
+      push(new TestGroup("instance_lod",true,true));
+      for (auto sflags : sceneFlags)
+        groups.top()->add(new InstanceLODTest(to_string(sflags),isa,sflags));
+      groups.pop();
+
+      push(new TestGroup("multi_hit",true,true));
+      if (rtcGetDeviceProperty(device,RTC_DEVICE_PROPERTY_FILTER_FUNCTION_SUPPORTED))
+      {
+        for (auto sflags : sceneFlags)
+          for (auto itype : { NO_INSTANCING, USER_INSTANCING, AUTO_INSTANCING })
+            groups.top()->add(new MultiHitTest(to_string(sflags)+"."+to_string(itype),isa,sflags,itype));
+      }
+      groups.pop();
+
+      push(new TestGroup("transmittance",true,true));
+      if (rtcGetDeviceProperty(device,RTC_DEVICE_PROPERTY_FILTER_FUNCTION_SUPPORTED))
+      {
+        for (auto sflags : sceneFlags)
+          for (auto itype : { NO_INSTANCING, USER_INSTANCING, AUTO_INSTANCING })
+            groups.top()->add(new TransmittanceTest(to_string(sflags)+"."+to_string(itype),isa,sflags,itype));
+        groups.top()->add(new TransmittanceSpatialSplitTest("spatial_splits",isa));
+      }
+      groups.pop();
+
+      push(new TestGroup("traversal_counters",true,true));
+      for (auto sflags : sceneFlags)
+        groups.top()->add(new TraversalCountersTest(to_string(sflags),isa,sflags));
+      groups.pop();
+
+      push(new TestGroup("auto_instancing",true,true));
+      for (auto sflags : sceneFlags)
+        groups.top()->add(new AutoInstancingTest(to_string(sflags),isa,sflags));
+      groups.pop();
+
       push(new TestGroup("inactive_rays",true,true));
       for (auto sflags : sceneFlags) 
         for (auto imode : intersectModes) 
@@ -4658,7 +6585,10 @@ namespace embree
         DISC_GEOMETRY,
         DISC_GEOMETRY_MB,
         ORIENTED_DISC_GEOMETRY,
-        ORIENTED_DISC_GEOMETRY_MB
+        ORIENTED_DISC_GEOMETRY_MB,
+        HAIR_GEOMETRY,
+        HAIR_GEOMETRY_MB,
+        INSTANCED_TRIANGLE_MESH
         // FIXME: use more geometry types
       };
 
@@ -4679,12 +6609,14 @@ namespace embree
       std::vector<std::pair<SceneFlags,RTCBuildQuality>> benchmark_create_sflags_quality;
       benchmark_create_sflags_quality.push_back(std::make_pair(SceneFlags(RTC_SCENE_FLAG_NONE,RTC_BUILD_QUALITY_MEDIUM),RTC_BUILD_QUALITY_MEDIUM));
       benchmark_create_sflags_quality.push_back(std::make_pair(SceneFlags(RTC_SCENE_FLAG_DYNAMIC,RTC_BUILD_QUALITY_LOW),RTC_BUILD_QUALITY_LOW));
+      benchmark_create_sflags_quality.push_back(std::make_pair(SceneFlags(RTC_SCENE_FLAG_NONE,RTC_BUILD_QUALITY_HIGH),RTC_BUILD_QUALITY_HIGH));
 
       GeometryType benchmark_create_gtypes[] = { 
         TRIANGLE_MESH, 
         TRIANGLE_MESH_MB, 
         QUAD_MESH, 
         QUAD_MESH_MB, 
+        SUBDIV_MESH,
         HAIR_GEOMETRY,
         HAIR_GEOMETRY_MB,
         LINE_GEOMETRY,
@@ -4823,6 +6755,16 @@ namespace embree
       }, "--benchmark-tolerance: maximum relative slowdown to let a test pass");
     registerOptionAlias("benchmark-tolerance","tolerance");
 
+    registerOption("benchmark-frames", [this] (Ref<ParseStream> cin, const FileName& path) {
+        const int frames = cin->getInt();
+        if (frames < 1) throw std::runtime_error("--benchmark-frames has to be at least 1");
+        benchmark_frames = frames;
+      }, "--benchmark-frames <N>: number of measured frames per benchmark attempt (default 8)");
+
+    registerOption("benchmark-json", [this] (Ref<ParseStream> cin, const FileName& path) {
+        benchmark_json = cin->getFileName();
+      }, "--benchmark-json <file>: writes avg, sigma, min, max and 10/50/90 percentiles of all executed benchmarks to a JSON file");
+
     registerOption("print-tests", [this] (Ref<ParseStream> cin, const FileName& path) {
         print_tests(tests,0);
         exit(1);
@@ -4844,7 +6786,7 @@ namespace embree
         plot(benchmarks,outFileName,"#primitives",1000,1100000,1.2f,0,[&] (Ref<Benchmark> benchmark, size_t& N) {
             N = benchmark->setNumPrimitives(N);
             benchmark->setup(this);
-            Statistics stat = benchmark->benchmark_loop(this);
+            Statistics stat = benchmark->benchmark_loop(this).getStatistics();
             benchmark->cleanup(this);
             return stat;
           });
@@ -4857,7 +6799,7 @@ namespace embree
         plot(benchmarks,outFileName,"#threads",2,getNumberOfLogicalThreads(),1.0f,2,[&] (Ref<Benchmark> benchmark, size_t N) {
             benchmark->setNumThreads(N);
             benchmark->setup(this);
-            Statistics stat = benchmark->benchmark_loop(this);
+            Statistics stat = benchmark->benchmark_loop(this).getStatistics();
             benchmark->cleanup(this);
             return stat;
           });
@@ -5008,6 +6950,48 @@ namespace embree
     }
   }
 
+  static std::string jsonNumber(double v)
+  {
+    if (!std::isfinite(v)) return "null";
+    std::stringstream str; str << std::setprecision(9) << v;
+    return str.str();
+  }
+
+  void VerifyApplication::writeBenchmarkResults(const FileName& fileName)
+  {
+    std::fstream json;
+    json.open(fileName.c_str(), std::fstream::out | std::fstream::trunc);
+    if (!json.is_open()) throw std::runtime_error("cannot open file "+fileName.str());
+    
+    json << "{" << std::endl;
+    json << "  \"hash\": \"" << loadGitHash() << "\"," << std::endl;
+    json << "  \"tolerance\": " << jsonNumber(benchmark_tolerance) << "," << std::endl;
+    json << "  \"benchmarks\": [" << std::endl;
+    for (size_t i=0; i<benchmark_results.size(); i++)
+    {
+      const BenchmarkResult& r = benchmark_results[i];
+      json << "    { ";
+      json << "\"name\": \"" << r.name << "\", ";
+      json << "\"unit\": \"" << r.unit << "\", ";
+      json << "\"higher_is_better\": " << (r.higher_is_better ? "true" : "false") << ", ";
+      json << "\"avg\": " << jsonNumber(r.avg) << ", ";
+      json << "\"sigma\": " << jsonNumber(r.sigma) << ", ";
+      json << "\"min\": " << jsonNumber(r.min) << ", ";
+      json << "\"max\": " << jsonNumber(r.max) << ", ";
+      json << "\"p10\": " << jsonNumber(r.p10) << ", ";
+      json << "\"p50\": " << jsonNumber(r.p50) << ", ";
+      json << "\"p90\": " << jsonNumber(r.p90) << ", ";
+      json << "\"reference\": " << jsonNumber(r.reference) << ", ";
+      json << "\"samples\": " << r.samples << ", ";
+      json << "\"attempts\": " << r.attempts << ", ";
+      json << "\"passed\": " << (r.passed ? "true" : "false");
+      json << " }" << (i+1 < benchmark_results.size() ? "," : "") << std::endl;
+    }
+    json << "  ]" << std::endl;
+    json << "}" << std::endl;
+    json.close();
+  }
+
   int VerifyApplication::main(int argc, char** argv) try
   {
     /* for best performance set FTZ and DAZ flags in MXCSR control and status register */
@@ -5020,6 +7004,10 @@ namespace embree
     /* run all enabled tests */
     tests->execute(this,false);
 
+    /* write benchmark results */
+    if (benchmark_json != "")
+      writeBenchmarkResults(benchmark_json);
+
     /* print result */
     std::cout << std::endl;
     std::cout << std::setw(TEXT_ALIGN) << "Tests passed" << ": " << numPassedTests << std::endl; 
@@ -95,7 +95,7 @@ namespace embree
       }
       virtual bool setup(VerifyApplication* state) { return true; }
       virtual float benchmark(VerifyApplication* state) = 0;
-      Statistics benchmark_loop(VerifyApplication* state);
+      FilteredStatistics benchmark_loop(VerifyApplication* state);
       virtual void cleanup(VerifyApplication* state) {}
       virtual TestReturnValue execute(VerifyApplication* state, bool silent);
       double readDatabase(VerifyApplication* state);
@@ -155,6 +155,7 @@ namespace embree
      template<typename Closure>
        void plot(std::vector<Ref<Benchmark>> benchmarks, const FileName outFileName, std::string xlabel, size_t startN, size_t endN, float f, size_t dn, const Closure& test);
     FileName parse_benchmark_list(Ref<ParseStream> cin, std::vector<Ref<Benchmark>>& benchmarks);
+    void writeBenchmarkResults(const FileName& fileName);
     int main(int argc, char** argv);
     
   public:
@@ -183,6 +184,23 @@ namespace embree
     FileName database;
     bool update_database;
     float benchmark_tolerance;
+    size_t benchmark_frames;
+    FileName benchmark_json;
+
+    /* measured results of all executed benchmarks */
+    struct BenchmarkResult
+    {
+      std::string name;
+      std::string unit;
+      bool higher_is_better;
+      float avg, sigma, min, max;
+      float p10, p50, p90;
+      double reference;
+      size_t samples;
+      size_t attempts;
+      bool passed;
+    };
+    std::vector<BenchmarkResult> benchmark_results;
 
     /* sets terminal colors */
   public: